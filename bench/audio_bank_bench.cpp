@@ -0,0 +1,99 @@
+/**
+ * @file audio_bank_bench.cpp
+ * @author Team Doge
+ * @brief Startup time and resident PCM of the sound effects: every file the
+ * board, shower, mac and planit worlds load, decoded synchronously once per
+ * world as their constructors used to, against asking the SoundLibrary for
+ * them and letting the loader thread of the AudioBank decode each file once.
+ * Runs on the dummy audio driver.
+ * @version 0.1
+ * @date 2021-12-05
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#define GL3W_IMPLEMENTATION
+#include <gl3w.h>
+
+// stlib
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// internal
+#include "audio_bank.hpp"
+#include "common.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+// In the order SceneManager::init creates the worlds
+const std::vector<std::string> SOUNDS = {
+    // board
+    "UI_41.wav", "plus_coin.wav", "minus_coin.wav", "explosion_1.wav",
+    "power_up_1.wav", "next_player.wav", "dice_roll2.wav", "dice_hit.wav",
+    "error_1.wav", "spring.wav", "doge_bark.wav", "doge_whimper.wav",
+    // mac
+    "salmon_dead.wav", "salmon_eat.wav",
+    // shower
+    "doge_die.wav", "doge_bark.wav",
+    // planit
+    "salmon_dead.wav", "salmon_eat.wav"};
+// the board and planit also asked for data/audio/music.wav, which is missing
+const int MUSIC_LOADS = 2;
+
+float ms_since(Clock::time_point start) {
+  return std::chrono::duration<float, std::milli>(Clock::now() - start)
+      .count();
+}
+
+int main() {
+  if (!audio_bank.open(true)) return EXIT_FAILURE;
+
+  // once to get the files into the page cache, both runs then only decode
+  for (const std::string &file : SOUNDS)
+    Mix_FreeChunk(Mix_LoadWAV(audio_path(file).c_str()));
+
+  auto start = Clock::now();
+  std::vector<Mix_Chunk *> chunks;
+  size_t per_world_bytes = 0;
+  for (const std::string &file : SOUNDS) {
+    chunks.push_back(Mix_LoadWAV(audio_path(file).c_str()));
+    if (chunks.back() != nullptr) per_world_bytes += chunks.back()->alen;
+  }
+  for (int i = 0; i < MUSIC_LOADS; i++) {
+    Mix_Music *music = Mix_LoadMUS(audio_path("music.wav").c_str());
+    if (music != nullptr) Mix_FreeMusic(music);
+  }
+  float per_world_ms = ms_since(start);
+  for (Mix_Chunk *chunk : chunks)
+    if (chunk != nullptr) Mix_FreeChunk(chunk);
+
+  start = Clock::now();
+  std::vector<Sound> sounds;
+  for (const std::string &file : SOUNDS)
+    sounds.push_back(sound_library.sound(file));
+  float request_ms = ms_since(start);
+  audio_bank.wait_loaded();
+  float loaded_ms = ms_since(start);
+  size_t bank_bytes = audio_bank.pcm_bytes();
+
+  printf("%zu sounds asked for\n", SOUNDS.size());
+  printf("decoded per world: %7.2f ms on the loading thread, %6zu KB of PCM\n",
+         per_world_ms, per_world_bytes / 1024);
+  printf("audio bank:        %7.2f ms on the loading thread, %6zu KB of PCM, "
+         "all decoded after %.2f ms\n",
+         request_ms, bank_bytes / 1024, loaded_ms);
+  printf("startup saved: %.2f ms, PCM saved: %zu KB\n",
+         per_world_ms - request_ms, (per_world_bytes - bank_bytes) / 1024);
+
+  for (const Sound &sound : sounds) {
+    if (sound->chunk == nullptr) {
+      fprintf(stderr, "%s was not decoded\n", sound->file.c_str());
+      return EXIT_FAILURE;
+    }
+  }
+  audio_bank.close();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,262 @@
+/**
+ * @file boids_bench.cpp
+ * @author Team Doge
+ * @brief Times a step of the grid boids (src/boids.hpp) against the O(N^2)
+ * double loop the shower swarm used, for 50 to 50k birds, and checks that
+ * both steer every bird the same way. Compares the scalar, SSE and AVX2
+ * neighbor kernels on 50k birds, the SIMD ones must stay within EPSILON of
+ * the scalar one. Then times 100k and 500k birds on 1, 2, 4 and 8 threads and
+ * checks that every thread count gives the same birds.
+ * @version 0.1
+ * @date 2021-12-06
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+// stlib
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// internal
+#include "boids.hpp"
+
+using glm::vec2;
+
+const float EPSILON = 1e-3f;
+// the double loop is only timed up to here, it takes seconds past it
+const size_t MAX_BRUTE_FORCE_BIRDS = 10000;
+// steps run on every thread count before comparing the birds
+const int STEPS_COMPARED = 5;
+
+struct Swarm {
+  std::vector<vec2> position, velocity;
+};
+
+// Birds spread over a world that keeps the density of the shower screen
+// with 50 birds per 1200x675 times density
+Swarm create_swarm(size_t count, float density, vec2 &bounds) {
+  float scale = std::sqrt(count / (50.f * density));
+  bounds = vec2(1200.f, 675.f) * scale;
+  std::default_random_engine rng(42);
+  std::uniform_real_distribution<float> uniform(0.f, 1.f);
+  Swarm swarm;
+  for (size_t i = 0; i < count; i++) {
+    swarm.position.push_back(
+        {bounds.x * uniform(rng), bounds.y * uniform(rng)});
+    swarm.velocity.push_back(
+        {40.f * uniform(rng) - 20.f, 40.f * uniform(rng) - 20.f});
+  }
+  return swarm;
+}
+
+// The shower swarm update with every bird against every other one, reading
+// the state before the step like Boids does
+void brute_force_step(const Boids &params, Swarm &swarm) {
+  const Swarm before = swarm;
+  size_t count = before.position.size();
+  for (size_t i = 0; i < count; i++) {
+    vec2 pos = before.position[i];
+    vec2 vel = before.velocity[i];
+    vec2 pos_sum = {0, 0}, vel_sum = {0, 0}, close = {0, 0};
+    int neighboring_birds = 0;
+    for (size_t j = 0; j < count; j++) {
+      if (i == j) continue;
+      vec2 d = pos - before.position[j];
+      float squared_distance = d.x * d.x + d.y * d.y;
+      if (squared_distance < params.protected_range * params.protected_range) {
+        close += d;
+      } else if (squared_distance <
+                 params.visual_range * params.visual_range) {
+        pos_sum += before.position[j];
+        vel_sum += before.velocity[j];
+        neighboring_birds++;
+      }
+    }
+    if (neighboring_birds > 0) {
+      vel += (pos_sum / (float)neighboring_birds - pos) *
+                 params.centering_factor +
+             (vel_sum / (float)neighboring_birds - vel) *
+                 params.matching_factor;
+    }
+    vel += close * params.avoid_factor;
+    if (pos.y < 0) {
+      pos.y = 0;
+      vel.y += params.turn_factor;
+    } else if (pos.y > params.bounds.y) {
+      pos.y = params.bounds.y;
+      vel.y -= params.turn_factor;
+    }
+    if (pos.x < 0) {
+      pos.x = 0;
+      vel.x += params.turn_factor;
+    } else if (pos.x > params.bounds.x) {
+      pos.x = params.bounds.x;
+      vel.x -= params.turn_factor;
+    }
+    float speed = std::sqrt(vel.x * vel.x + vel.y * vel.y);
+    if (speed > 0 && speed < params.min_speed)
+      vel = vel / speed * params.min_speed;
+    else if (speed > params.max_speed)
+      vel = vel / speed * params.max_speed;
+    swarm.position[i] = pos;
+    swarm.velocity[i] = vel;
+  }
+}
+
+// Largest difference of a velocity between two flocks
+float velocity_error(const Boids &l, const Boids &r) {
+  float error = 0;
+  for (unsigned int i = 0; i < l.size(); i++) {
+    vec2 d = l.velocity(i) - r.velocity(i);
+    error = std::max(error, std::max(std::abs(d.x), std::abs(d.y)));
+  }
+  return error;
+}
+
+bool same_birds(const Boids &l, const Boids &r) {
+  for (unsigned int i = 0; i < l.size(); i++) {
+    vec2 lp = l.position(i), rp = r.position(i);
+    vec2 lv = l.velocity(i), rv = r.velocity(i);
+    if (memcmp(&lp, &rp, sizeof(vec2)) != 0 ||
+        memcmp(&lv, &rv, sizeof(vec2)) != 0)
+      return false;
+  }
+  return true;
+}
+
+// Milliseconds per call of step, averaged over enough calls to take a while
+template <typename Step>
+double measure(Step step) {
+  int repeats = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  double seconds = 0;
+  do {
+    step();
+    repeats++;
+    seconds = std::chrono::duration<double>(
+                  std::chrono::high_resolution_clock::now() - start)
+                  .count();
+  } while (seconds < 0.5);
+  return seconds * 1000.0 / repeats;
+}
+
+int main() {
+  bool ok = true;
+  printf("%8s %8s %14s %10s %10s\n", "birds", "density", "double loop ms",
+         "grid ms", "birds/cell");
+  for (float density : {1.f, 10.f, 100.f}) {
+    for (size_t count : {50, 1000, 10000, 50000}) {
+      vec2 bounds;
+      Swarm swarm = create_swarm(count, density, bounds);
+
+      Boids boids;
+      boids.bounds = bounds;
+      for (size_t i = 0; i < count; i++)
+        boids.add(swarm.position[i], swarm.velocity[i]);
+
+      // one step of each must steer the same way
+      Swarm reference = swarm;
+      if (count <= MAX_BRUTE_FORCE_BIRDS) {
+        brute_force_step(boids, reference);
+        boids.step();
+        for (size_t i = 0; i < count; i++) {
+          vec2 d = boids.velocity((unsigned int)i) - reference.velocity[i];
+          vec2 p = boids.position((unsigned int)i) - reference.position[i];
+          if (std::abs(d.x) > EPSILON || std::abs(d.y) > EPSILON ||
+              p.x != 0 || p.y != 0) {
+            printf("bird %zu differs from the double loop\n", i);
+            ok = false;
+            break;
+          }
+        }
+      }
+
+      double brute_force_ms = -1;
+      if (count <= MAX_BRUTE_FORCE_BIRDS)
+        brute_force_ms = measure([&] { brute_force_step(boids, reference); });
+      double grid_ms = measure([&] { boids.step(); });
+      float cells = std::ceil(bounds.x / boids.visual_range) *
+                    std::ceil(bounds.y / boids.visual_range);
+      if (brute_force_ms < 0)
+        printf("%8zu %8.0f %14s %10.3f %10.1f\n", count, density, "-", grid_ms,
+               count / cells);
+      else
+        printf("%8zu %8.0f %14.3f %10.3f %10.1f\n", count, density,
+               brute_force_ms, grid_ms, count / cells);
+    }
+  }
+
+  printf("\nbest level on this cpu: %s\n", simd_level_name(simd_best_level()));
+  printf("%8s %8s %8s %10s %10s\n", "birds", "density", "level", "grid ms",
+         "error");
+  for (float density : {1.f, 10.f, 100.f}) {
+    const size_t count = 50000;
+    vec2 bounds;
+    Swarm swarm = create_swarm(count, density, bounds);
+    Boids start;
+    start.bounds = bounds;
+    for (size_t i = 0; i < count; i++)
+      start.add(swarm.position[i], swarm.velocity[i]);
+
+    Boids reference;
+    for (SimdLevel level :
+         {SimdLevel::SCALAR, SimdLevel::SSE, SimdLevel::AVX2}) {
+      if (level > simd_best_level()) continue;
+      set_boids_simd_level(level);
+      Boids boids = start;
+      boids.step();
+      float error = 0;
+      if (level == SimdLevel::SCALAR) {
+        reference = boids;
+      } else {
+        error = velocity_error(reference, boids);
+        if (error > EPSILON) {
+          printf("%s is %g off the scalar kernel\n", simd_level_name(level),
+                 error);
+          ok = false;
+        }
+      }
+      double grid_ms = measure([&] { boids.step(); });
+      printf("%8zu %8.0f %8s %10.3f %10.2g\n", count, density,
+             simd_level_name(level), grid_ms, error);
+    }
+    set_boids_simd_level(simd_best_level());
+  }
+
+  printf("\n%8s %8s %8s %10s %8s\n", "birds", "density", "threads",
+         "grid ms", "speedup");
+  for (size_t count : {100000, 500000}) {
+    vec2 bounds;
+    Swarm swarm = create_swarm(count, 10.f, bounds);
+    Boids serial;
+    serial.bounds = bounds;
+    for (size_t i = 0; i < count; i++)
+      serial.add(swarm.position[i], swarm.velocity[i]);
+    Boids reference = serial;
+    for (int s = 0; s < STEPS_COMPARED; s++) reference.step();
+
+    double single_thread_ms = 0;
+    for (unsigned int threads : {1, 2, 4, 8}) {
+      JobSystem jobs;
+      jobs.start(threads);
+      Boids boids = serial;
+      for (int s = 0; s < STEPS_COMPARED; s++) boids.step(&jobs);
+      if (!same_birds(reference, boids)) {
+        printf("%u threads differ from one\n", threads);
+        ok = false;
+      }
+      double grid_ms = measure([&] { boids.step(&jobs); });
+      if (threads == 1) single_thread_ms = grid_ms;
+      printf("%8zu %8.0f %8u %10.3f %8.2f\n", count, 10.f, threads, grid_ms,
+             single_thread_ms / grid_ms);
+    }
+  }
+  printf("(%u cores on this machine)\n", std::thread::hardware_concurrency());
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
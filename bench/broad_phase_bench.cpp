@@ -0,0 +1,196 @@
+/**
+ * @file broad_phase_bench.cpp
+ * @author Team Doge
+ * @brief Times the spatial hash broad phase against the O(N^2) double loop the
+ * physics systems used before, at 100, 1k and 10k bodies moving in a shower
+ * sized (1200x800) world. Also checks that both report the same pairs. Then
+ * splits the pair search of the spatial hash and the sweep and prune over a
+ * JobSystem of 1, 2, 4 and 8 threads at 10k and 50k bodies, and checks that
+ * they report the pairs of one thread in the same order.
+ * @version 0.1
+ * @date 2021-12-01
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+// stlib
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <glm/common.hpp>  // abs
+
+// internal
+#include "broad_phase.hpp"
+
+using glm::vec2;
+
+const vec2 WORLD_SIZE = {1200.f, 800.f};
+const int FRAMES = 100;
+const float STEP_SECONDS = 1.f / 60.f;
+
+struct Bodies {
+  std::vector<vec2> position;
+  std::vector<vec2> velocity;
+  std::vector<vec2> half_extents;
+};
+
+Bodies create_bodies(int count) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> x(0.f, WORLD_SIZE.x);
+  std::uniform_real_distribution<float> y(0.f, WORLD_SIZE.y);
+  std::uniform_real_distribution<float> speed(-200.f, 200.f);
+  std::uniform_real_distribution<float> size(4.f, 12.f);
+  Bodies bodies;
+  for (int i = 0; i < count; i++) {
+    bodies.position.push_back({x(rng), y(rng)});
+    bodies.velocity.push_back({speed(rng), speed(rng)});
+    float half = size(rng);
+    bodies.half_extents.push_back({half, half});
+  }
+  return bodies;
+}
+
+void move(Bodies &bodies) {
+  for (size_t i = 0; i < bodies.position.size(); i++) {
+    vec2 &p = bodies.position[i];
+    vec2 &v = bodies.velocity[i];
+    p += v * STEP_SECONDS;
+    if (p.x < 0 || p.x > WORLD_SIZE.x) v.x = -v.x;
+    if (p.y < 0 || p.y > WORLD_SIZE.y) v.y = -v.y;
+  }
+}
+
+bool overlaps(const Bodies &bodies, size_t i, size_t j) {
+  vec2 d = glm::abs(bodies.position[i] - bodies.position[j]);
+  vec2 r = bodies.half_extents[i] + bodies.half_extents[j];
+  return d.x <= r.x && d.y <= r.y;
+}
+
+// What every physics system did: test (i,j) and (j,i)
+void brute_force_pairs(const Bodies &bodies,
+                       std::vector<BroadPhasePair> &out_pairs) {
+  out_pairs.clear();
+  size_t count = bodies.position.size();
+  for (size_t i = 0; i < count; i++) {
+    for (size_t j = 0; j < count; j++) {
+      if (i == j) continue;
+      if (overlaps(bodies, i, j) && i < j)
+        out_pairs.push_back({(unsigned int)i, (unsigned int)j});
+    }
+  }
+}
+
+void broad_phase_pairs(BroadPhase &broad_phase, const Bodies &bodies,
+                       std::vector<BroadPhasePair> &out_pairs) {
+  broad_phase.clear();
+  for (size_t i = 0; i < bodies.position.size(); i++)
+    broad_phase.insert((unsigned int)i, bodies.position[i],
+                       bodies.half_extents[i]);
+  broad_phase.find_pairs(out_pairs);
+}
+
+bool same_order(const std::vector<BroadPhasePair> &a,
+                const std::vector<BroadPhasePair> &b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); i++)
+    if (a[i].a != b[i].a || a[i].b != b[i].b) return false;
+  return true;
+}
+
+bool same_pairs(std::vector<BroadPhasePair> a, std::vector<BroadPhasePair> b) {
+  auto less = [](const BroadPhasePair &l, const BroadPhasePair &r) {
+    return l.a < r.a || (l.a == r.a && l.b < r.b);
+  };
+  std::sort(a.begin(), a.end(), less);
+  std::sort(b.begin(), b.end(), less);
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); i++)
+    if (a[i].a != b[i].a || a[i].b != b[i].b) return false;
+  return true;
+}
+
+template <class F>
+double time_ms_per_frame(int frames, F frame) {
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < frames; i++) frame();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         frames;
+}
+
+int main() {
+  printf("%8s %10s %14s %14s %9s\n", "bodies", "pairs", "brute ms", "hash ms",
+         "speedup");
+  bool ok = true;
+  for (int count : {100, 1000, 10000}) {
+    Bodies bodies = create_bodies(count);
+    SpatialHash spatial_hash(32.f);
+    std::vector<BroadPhasePair> expected, pairs;
+
+    brute_force_pairs(bodies, expected);
+    broad_phase_pairs(spatial_hash, bodies, pairs);
+    if (!same_pairs(expected, pairs)) {
+      fprintf(stderr, "%d bodies: spatial hash found %zu pairs, expected %zu\n",
+              count, pairs.size(), expected.size());
+      ok = false;
+    }
+
+    // The double loop is too slow to run for all frames at 10k bodies
+    int brute_frames = std::max(1, FRAMES * 100 / count);
+    Bodies brute_bodies = bodies;
+    double brute_ms = time_ms_per_frame(brute_frames, [&]() {
+      move(brute_bodies);
+      brute_force_pairs(brute_bodies, expected);
+    });
+    double hash_ms = time_ms_per_frame(FRAMES, [&]() {
+      move(bodies);
+      broad_phase_pairs(spatial_hash, bodies, pairs);
+    });
+    printf("%8d %10zu %14.3f %14.3f %8.1fx\n", count, pairs.size(), brute_ms,
+           hash_ms, brute_ms / hash_ms);
+  }
+
+  printf("\n%8s %16s %8s %10s %8s\n", "bodies", "broad phase", "threads",
+         "ms", "speedup");
+  for (int count : {10000, 50000}) {
+    for (const char *name : {"spatial hash", "sweep and prune"}) {
+      std::vector<BroadPhasePair> reference, pairs;
+      double single_thread_ms = 0;
+      for (unsigned int threads : {1, 2, 4, 8}) {
+        // a new one per thread count, the sweep keeps its order between frames
+        SpatialHash spatial_hash(32.f);
+        SweepAndPrune sweep_and_prune;
+        BroadPhase &broad_phase = strcmp(name, "spatial hash") == 0
+                                      ? (BroadPhase &)spatial_hash
+                                      : (BroadPhase &)sweep_and_prune;
+        JobSystem jobs;
+        jobs.start(threads);
+        broad_phase.set_job_system(&jobs);
+        Bodies bodies = create_bodies(count);
+        broad_phase_pairs(broad_phase, bodies, pairs);
+        if (threads == 1) {
+          reference = pairs;
+        } else if (!same_order(reference, pairs)) {
+          fprintf(stderr, "%s on %u threads differs from one\n", name,
+                  threads);
+          ok = false;
+        }
+        double ms = time_ms_per_frame(FRAMES / 10, [&]() {
+          move(bodies);
+          broad_phase_pairs(broad_phase, bodies, pairs);
+        });
+        if (threads == 1) single_thread_ms = ms;
+        printf("%8d %16s %8u %10.3f %8.2f\n", count, name, threads, ms,
+               single_thread_ms / ms);
+      }
+    }
+  }
+  printf("(%u cores on this machine)\n", std::thread::hardware_concurrency());
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,198 @@
+/**
+ * @file narrow_phase_bench.cpp
+ * @author Team Doge
+ * @brief Measures the pairs per second of the narrow phase kernels with the
+ * scalar, SSE and AVX2 paths against the per pair sqrt(pow()) test the Mac
+ * scene used, and checks that every path reports the same hits, also for
+ * pairs that just touch.
+ * @version 0.1
+ * @date 2021-12-05
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+// stlib
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+// internal
+#include "narrow_phase.hpp"
+
+using glm::vec2;
+
+const int BODIES = 10000;
+const int REPEATS = 20;
+
+// The old Mac rock test
+bool legacy_circles_collide(vec2 p1, vec2 p2) {
+  float dist = sqrt(pow(p1.x - p2.x, 2) + pow(p1.y - p2.y, 2));
+  return dist < 50;
+}
+
+// Bodies jittered around the points of a grid and paired with their grid
+// neighbors, like the boxes of a broad phase that are a bit larger than the
+// shapes: a good part of the candidates touch and the pairs of a body are
+// reported together
+void create_workload(NarrowPhaseBodies &bodies,
+                     std::vector<BroadPhasePair> &pairs, size_t pair_count) {
+  const int columns = 100;
+  const float spacing = 45.f;
+  std::default_random_engine rng(42);
+  std::uniform_real_distribution<float> jitter(-15.f, 15.f);
+  std::uniform_int_distribution<int> neighbor(0, 3);
+  bodies.clear();
+  for (int i = 0; i < BODIES; i++)
+    bodies.add({(i % columns) * spacing + jitter(rng),
+                (i / columns) * spacing + jitter(rng)},
+               25.f, {25.f, 25.f});
+  const unsigned int steps[] = {1, columns - 1, columns, columns + 1};
+  pairs.clear();
+  for (unsigned int a = 0; pairs.size() < pair_count; a = (a + 1) % BODIES) {
+    unsigned int b = a + steps[neighbor(rng)];
+    if (b < BODIES) pairs.push_back({a, b});
+  }
+}
+
+// Pairs that just touch, where a fused multiply add would round the squared
+// distance differently from the other paths: circles a sum of radii apart,
+// circles at a distance of their radius from the corner of a box, and boxes
+// touching along an axis
+void create_tangent_workload(NarrowPhaseBodies &bodies,
+                             std::vector<BroadPhasePair> &pairs) {
+  const int tangent_pairs = 3000;
+  const float radius = 25.f;
+  std::default_random_engine rng(7);
+  std::uniform_real_distribution<float> position(0.f, 1000.f);
+  std::uniform_real_distribution<float> angle(0.f, float(M_PI / 2));
+  bodies.clear();
+  pairs.clear();
+  for (unsigned int i = 0; i < tangent_pairs; i++) {
+    vec2 a = {position(rng), position(rng)};
+    float theta = angle(rng);
+    vec2 offset = {cosf(theta), sinf(theta)};
+    vec2 b;
+    if (i % 3 == 0)
+      b = a + 2 * radius * offset;
+    else if (i % 3 == 1)
+      b = a - radius * (vec2(1.f, 1.f) + offset);
+    else
+      b = a + vec2(2 * radius, radius * offset.y);
+    bodies.add(a, radius, {radius, radius});
+    bodies.add(b, radius, {radius, radius});
+    pairs.push_back({2 * i, 2 * i + 1});
+  }
+}
+
+// Millions of pairs per second of run over the pair list
+double measure(const std::vector<BroadPhasePair> &pairs,
+               const std::function<void(std::vector<BroadPhasePair> &)> &run,
+               std::vector<BroadPhasePair> &hits) {
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int r = 0; r < REPEATS; r++) {
+    hits.clear();
+    run(hits);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  double seconds = std::chrono::duration<double>(end - start).count();
+  return pairs.size() * (double)REPEATS / seconds / 1e6;
+}
+
+bool same_hits(const std::vector<BroadPhasePair> &l,
+               const std::vector<BroadPhasePair> &r) {
+  if (l.size() != r.size()) return false;
+  for (size_t i = 0; i < l.size(); i++)
+    if (l[i].a != r[i].a || l[i].b != r[i].b) return false;
+  return true;
+}
+
+int main() {
+  bool ok = true;
+  printf("best level on this cpu: %s\n", simd_level_name(simd_best_level()));
+  printf("%10s %12s %8s %12s %12s\n", "pairs", "kernel", "level", "Mpairs/s",
+         "hits");
+  for (size_t pair_count : {1000, 100000, 1000000}) {
+    NarrowPhaseBodies bodies;
+    std::vector<BroadPhasePair> pairs;
+    create_workload(bodies, pairs, pair_count);
+
+    std::vector<BroadPhasePair> hits;
+    double rate = measure(pairs,
+                          [&](std::vector<BroadPhasePair> &out) {
+                            for (const BroadPhasePair &pair : pairs)
+                              if (legacy_circles_collide(
+                                      {bodies.x[pair.a], bodies.y[pair.a]},
+                                      {bodies.x[pair.b], bodies.y[pair.b]}))
+                                out.push_back(pair);
+                          },
+                          hits);
+    printf("%10zu %12s %8s %12.1f %12zu\n", pair_count, "sqrt(pow)", "-", rate,
+           hits.size());
+
+    const char *kernels[] = {"circles", "circle_box", "boxes"};
+    for (int kernel = 0; kernel < 3; kernel++) {
+      std::vector<BroadPhasePair> reference;
+      for (SimdLevel level :
+           {SimdLevel::SCALAR, SimdLevel::SSE, SimdLevel::AVX2}) {
+        if (level > simd_best_level()) continue;
+        set_narrow_phase_simd_level(level);
+        rate = measure(pairs,
+                       [&](std::vector<BroadPhasePair> &out) {
+                         if (kernel == 0)
+                           circle_pairs(bodies, pairs,
+                                        CircleContact::SUM_OF_RADII, out);
+                         else if (kernel == 1)
+                           circle_box_pairs(bodies, pairs, out);
+                         else
+                           box_pairs(bodies, pairs, out);
+                       },
+                       hits);
+        if (level == SimdLevel::SCALAR) {
+          reference = hits;
+        } else if (!same_hits(reference, hits)) {
+          printf("%s with %s differs from the scalar kernel\n",
+                 kernels[kernel], simd_level_name(level));
+          ok = false;
+        }
+        printf("%10zu %12s %8s %12.1f %12zu\n", pair_count, kernels[kernel],
+               simd_level_name(level), rate, hits.size());
+      }
+    }
+    set_narrow_phase_simd_level(simd_best_level());
+  }
+
+  NarrowPhaseBodies bodies;
+  std::vector<BroadPhasePair> pairs;
+  create_tangent_workload(bodies, pairs);
+  const char *kernels[] = {"circles", "circle_box", "boxes"};
+  for (int kernel = 0; kernel < 3; kernel++) {
+    std::vector<BroadPhasePair> reference;
+    for (SimdLevel level :
+         {SimdLevel::SCALAR, SimdLevel::SSE, SimdLevel::AVX2}) {
+      if (level > simd_best_level()) continue;
+      set_narrow_phase_simd_level(level);
+      std::vector<BroadPhasePair> hits;
+      if (kernel == 0)
+        circle_pairs(bodies, pairs, CircleContact::SUM_OF_RADII, hits);
+      else if (kernel == 1)
+        circle_box_pairs(bodies, pairs, hits);
+      else
+        box_pairs(bodies, pairs, hits);
+      if (level == SimdLevel::SCALAR) {
+        reference = hits;
+        printf("%10zu %12s %8s %12s %12zu\n", pairs.size(), kernels[kernel],
+               "tangent", "-", hits.size());
+      } else if (!same_hits(reference, hits)) {
+        printf("%s with %s differs from the scalar kernel on touching pairs\n",
+               kernels[kernel], simd_level_name(level));
+        ok = false;
+      }
+    }
+  }
+  set_narrow_phase_simd_level(simd_best_level());
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file particle_bench.cpp
+ * @author Team Doge
+ * @brief Runs a long lived emitter through the old push_back particle arrays
+ * of the board and through a ParticlePool (src/particle_pool.hpp), and prints
+ * how far the arrays grew and the time per step of each. Then spawns and
+ * steps 1M particles per frame with the board's per particle rng() and
+ * sin/cos against a spawn batch, and with the scalar, SSE and AVX2
+ * integration, checking that every level leaves the same particles.
+ * @version 0.1
+ * @date 2021-12-07
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+// stlib
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// internal
+#include "particle_pool.hpp"
+
+using glm::vec2;
+
+const float STEP_MS = 1000.f / 120.f;
+
+// The arrays the board kept per particle system, dead particles stay
+struct LegacyParticles {
+  std::vector<bool> alive;
+  std::vector<vec2> position;
+  std::vector<vec2> velocity;
+  std::vector<float> size;
+  std::vector<float> life;
+
+  void step(float ms, vec2 acceleration) {
+    for (size_t i = 0; i < alive.size(); i++) {
+      if (alive[i]) {
+        life[i] -= ms;
+        if (life[i] < 0) {
+          alive[i] = false;
+          size[i] = 0;
+        }
+      }
+      position[i] += velocity[i] * ms / 1000.0f;
+      velocity[i] += acceleration * ms / 1000.0f;
+    }
+  }
+
+  void spawn(vec2 p, vec2 v, float s, float l) {
+    alive.push_back(true);
+    position.push_back(p);
+    velocity.push_back(v);
+    size.push_back(s);
+    life.push_back(l);
+  }
+};
+
+const size_t FRAME_PARTICLES = 1000000;
+
+// The spawn loop of the board, four rng() per particle and a sin and cos
+void legacy_spawn(const ParticleEmitter &e, size_t count, vec2 origin,
+                  std::default_random_engine &rng, ParticlePool &pool) {
+  for (size_t i = 0; i < count; i++) {
+    float random_angle = ((rng() % ((e.cone_angle + 1) * 100)) / 100.0f) +
+                         (e.spawning_angle - e.cone_angle / 2.0f);
+    float y = sin(random_angle * 3.14159 / 180.0f);
+    float x = cos(random_angle * 3.14159 / 180.0f);
+    vec2 vel = vec2(x, y) *
+               (e.initial_speed *
+                (1 - ((rng() % 100) / 100.0f) * e.speed_randomness));
+    float size = e.particle_size *
+                 (1 - ((rng() % 100) / 100.0f) * e.size_randomness);
+    float lifetime = e.particle_lifetime_ms *
+                     (1 - ((rng() % 100) / 100.0f) * e.lifetime_randomness);
+    pool.spawn(origin, vel, size, lifetime);
+  }
+}
+
+template <typename Run>
+double milliseconds(Run run) {
+  auto start = std::chrono::high_resolution_clock::now();
+  run();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double>(end - start).count() * 1000.0;
+}
+
+bool same_particles(const ParticlePool &l, const ParticlePool &r) {
+  return l.size() == r.size() &&
+         memcmp(l.position.data(), r.position.data(),
+                l.size() * sizeof(vec2)) == 0 &&
+         memcmp(l.velocity.data(), r.velocity.data(),
+                l.size() * sizeof(vec2)) == 0 &&
+         memcmp(l.life_ms.data(), r.life_ms.data(),
+                l.size() * sizeof(float)) == 0;
+}
+
+int main() {
+  bool ok = true;
+  printf("%8s %10s %12s %12s %12s %12s\n", "steps", "alive", "legacy slots",
+         "legacy ms", "pool slots", "pool ms");
+  for (int steps : {1200, 12000, 72000}) {
+    // spawn a burst of particles per step, each lives a second, so the
+    // live count levels out while the legacy arrays keep growing
+    const int per_step = 8;
+    std::default_random_engine rng(7);
+    std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+
+    LegacyParticles legacy;
+    ParticlePool pool(per_step * 130);
+    double legacy_seconds = 0, pool_seconds = 0;
+    for (int s = 0; s < steps; s++) {
+      auto start = std::chrono::high_resolution_clock::now();
+      legacy.step(STEP_MS, {0, 1000});
+      for (int p = 0; p < per_step; p++)
+        legacy.spawn({600, 400}, {uniform(rng) * 500, uniform(rng) * 500}, 50,
+                     1000);
+      auto middle = std::chrono::high_resolution_clock::now();
+      pool.step(STEP_MS, {0, 1000});
+      for (int p = 0; p < per_step; p++)
+        pool.spawn({600, 400}, {uniform(rng) * 500, uniform(rng) * 500}, 50,
+                   1000);
+      auto end = std::chrono::high_resolution_clock::now();
+      legacy_seconds += std::chrono::duration<double>(middle - start).count();
+      pool_seconds += std::chrono::duration<double>(end - middle).count();
+    }
+    printf("%8d %10zu %12zu %12.4f %12zu %12.4f\n", steps, pool.size(),
+           legacy.alive.size(), legacy_seconds * 1000.0 / steps,
+           pool.capacity(), pool_seconds * 1000.0 / steps);
+  }
+
+  // the coin spray of the board
+  ParticleEmitter coins;
+  coins.spawning_angle = -90.f;
+  coins.cone_angle = 60;
+  coins.initial_speed = 800.f;
+  coins.speed_randomness = 0.55f;
+  coins.particle_lifetime_ms = 2500.f;
+  coins.particle_size = 75.f;
+  coins.acceleration = {0, 900};
+
+  printf("\nbest level on this cpu: %s\n", simd_level_name(simd_best_level()));
+  printf("%10s %14s %10s\n", "particles", "", "ms");
+  {
+    std::default_random_engine rng(7);
+    ParticlePool pool(FRAME_PARTICLES);
+    double ms = milliseconds(
+        [&] { legacy_spawn(coins, FRAME_PARTICLES, {600, 400}, rng, pool); });
+    printf("%10zu %14s %10.2f\n", FRAME_PARTICLES, "rng spawn", ms);
+    pool.clear();
+    ms = milliseconds(
+        [&] { coins.spawn_batch(FRAME_PARTICLES, {600, 400}, pool, rng()); });
+    printf("%10zu %14s %10.2f\n", FRAME_PARTICLES, "batch spawn", ms);
+  }
+
+  // a frame of 1M particles, a fifth of them dying every step
+  std::default_random_engine rng(7);
+  ParticlePool start(FRAME_PARTICLES);
+  coins.spawn_batch(FRAME_PARTICLES, {600, 400}, start, rng());
+  for (size_t i = 0; i < start.size(); i++)
+    start.life_ms[i] = (i * 7919 % 50) * STEP_MS;
+  ParticlePool reference(0);
+  for (SimdLevel level :
+       {SimdLevel::SCALAR, SimdLevel::SSE, SimdLevel::AVX2}) {
+    if (level > simd_best_level()) continue;
+    set_particle_simd_level(level);
+    ParticlePool pool = start;
+    double ms = 0;
+    const int steps = 10;
+    for (int s = 0; s < steps; s++)
+      ms += milliseconds([&] { pool.step(STEP_MS, coins.acceleration); });
+    if (level == SimdLevel::SCALAR) {
+      reference = pool;
+    } else if (!same_particles(reference, pool)) {
+      printf("%s integration differs from the scalar one\n",
+             simd_level_name(level));
+      ok = false;
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "%s step", simd_level_name(level));
+    printf("%10zu %14s %10.2f\n", FRAME_PARTICLES, name, ms / steps);
+  }
+  set_particle_simd_level(simd_best_level());
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
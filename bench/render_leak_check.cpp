@@ -0,0 +1,158 @@
+/**
+ * @file render_leak_check.cpp
+ * @author Team Doge
+ * @brief Renders the three RenderSystem paths (world, text only, text with
+ * background) for 10k frames in a hidden window and asserts that neither the
+ * number of live GL objects nor the registry size grows.
+ * @version 0.1
+ * @date 2021-11-20
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#define GL3W_IMPLEMENTATION
+#include <gl3w.h>
+
+// stlib
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+// internal
+#include "render_system.hpp"
+#include "tiny_ecs_registry.hpp"
+
+const int FRAMES = 10000;
+const int WARMUP_FRAMES = 100;
+
+struct GLObjectCount {
+  int vertex_arrays = 0;
+  int buffers = 0;
+  int textures = 0;
+  int framebuffers = 0;
+
+  bool operator==(const GLObjectCount &other) const {
+    return vertex_arrays == other.vertex_arrays && buffers == other.buffers &&
+           textures == other.textures && framebuffers == other.framebuffers;
+  }
+};
+
+// GL has no query for the number of live objects. Names are handed out from
+// the low end, so generating a probe name gives an upper bound and every name
+// below it is checked with glIs*
+GLObjectCount count_gl_objects() {
+  GLObjectCount count;
+  GLuint probe;
+
+  glGenVertexArrays(1, &probe);
+  for (GLuint i = 1; i < probe; i++) count.vertex_arrays += glIsVertexArray(i);
+  glDeleteVertexArrays(1, &probe);
+
+  glGenBuffers(1, &probe);
+  for (GLuint i = 1; i < probe; i++) count.buffers += glIsBuffer(i);
+  glDeleteBuffers(1, &probe);
+
+  glGenTextures(1, &probe);
+  for (GLuint i = 1; i < probe; i++) count.textures += glIsTexture(i);
+  glDeleteTextures(1, &probe);
+
+  glGenFramebuffers(1, &probe);
+  for (GLuint i = 1; i < probe; i++) count.framebuffers += glIsFramebuffer(i);
+  glDeleteFramebuffers(1, &probe);
+
+  return count;
+}
+
+void print_counts(const char *label, const GLObjectCount &gl,
+                  size_t components) {
+  printf("%-8s vao %4d, buffers %4d, textures %4d, fbos %2d, components %zu\n",
+         label, gl.vertex_arrays, gl.buffers, gl.textures, gl.framebuffers,
+         components);
+}
+
+int main() {
+  if (!glfwInit()) {
+    fprintf(stderr, "Failed to initialize GLFW\n");
+    return EXIT_FAILURE;
+  }
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#if __APPLE__
+  glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  GLFWwindow *window =
+      glfwCreateWindow(1200, 675, "leak check", nullptr, nullptr);
+  if (window == nullptr) {
+    fprintf(stderr, "Failed to create a GL 3.3 context\n");
+    return EXIT_FAILURE;
+  }
+
+  std::shared_ptr<ECSRegistry> registry = std::make_shared<ECSRegistry>();
+  std::shared_ptr<RenderSystem> renderer = std::make_shared<RenderSystem>();
+  int w, h;
+  glfwGetFramebufferSize(window, &w, &h);
+  if (!renderer->init(registry, w, h, window)) return EXIT_FAILURE;
+  // don't wait for vsync, we want to get through the frames
+  glfwSwapInterval(0);
+
+  // a minimal scene: camera, a static background and a moving sprite
+  registry->camera.emplace(Entity());
+  Entity background = Entity();
+  registry->transforms.emplace(background).scale = {1200, 675};
+  registry->renderRequests.insert(
+      background, {TEXTURE_ASSET_ID::BKGD_MAC, EFFECT_ASSET_ID::TEXTURED,
+                   GEOMETRY_BUFFER_ID::SPRITE});
+  registry->staticLayers.emplace(background);
+  Entity sprite = Entity();
+  registry->transforms.emplace(sprite).scale = {100, 100};
+  registry->renderRequests.insert(
+      sprite, {TEXTURE_ASSET_ID::DOGE, EFFECT_ASSET_ID::TEXTURED,
+               GEOMETRY_BUFFER_ID::SPRITE});
+
+  GLObjectCount gl_before;
+  size_t components_before = 0;
+  for (int frame = 0; frame < FRAMES + WARMUP_FRAMES; frame++) {
+    if (frame == WARMUP_FRAMES) {
+      gl_before = count_gl_objects();
+      components_before = registry->count_all_components();
+      print_counts("before", gl_before, components_before);
+    }
+
+    // what a scene step does before queuing its text and moving things
+    registry->snapshot_transforms();
+    renderer->clear_text();
+    registry->transforms.get(sprite).position = {frame % 1200, 300};
+    renderer->add_text_to_be_rendered({"leak check"}, vec2(0.4, 0.5), 1,
+                                      vec3(1), RenderSystem::FONTS::BOLD, 0);
+    switch (frame % 3) {
+      case 0:
+        renderer->show_world();
+        break;
+      case 1:
+        renderer->show_text_only(vec3(0.1, 0.2, 0.7));
+        break;
+      case 2:
+        renderer->show_text_with_background(TEXTURE_ASSET_ID::BKGD_PLANIT,
+                                            vec2(600, 400), vec2(1200, 800));
+        break;
+    }
+    // one thread here, the snapshot is drawn right after it is published
+    renderer->publish();
+    renderer->draw();
+    glfwPollEvents();
+  }
+
+  GLObjectCount gl_after = count_gl_objects();
+  size_t components_after = registry->count_all_components();
+  print_counts("after", gl_after, components_after);
+
+  bool flat = gl_before == gl_after && components_before == components_after;
+  printf("%s after %d frames\n", flat ? "No leaks" : "LEAK DETECTED", FRAMES);
+
+  renderer = nullptr;
+  glfwDestroyWindow(window);
+  glfwTerminate();
+  return flat ? EXIT_SUCCESS : EXIT_FAILURE;
+}
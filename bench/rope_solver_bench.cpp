@@ -0,0 +1,88 @@
+/**
+ * @file rope_solver_bench.cpp
+ * @author Team Doge
+ * @brief Times RopeSolver steps for 10 to 1000 hanging ropes of 8 to 64
+ * segments at 120 Hz with 8 iterations. Also checks that a rigid rope keeps
+ * its pinned end in place and its links close to their rest length.
+ * @version 0.1
+ * @date 2021-12-04
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+// stlib
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include <glm/geometric.hpp>  // length
+
+// internal
+#include "rope_solver.hpp"
+
+using glm::vec2;
+
+const float STEP_SECONDS = 1.f / 120.f;
+const int STEPS = 240;
+const vec2 GRAVITY = {0.f, 980.f};
+
+// Ropes hanging from a ceiling, started horizontal so they all swing
+void create_ropes(RopeSolver &solver, int ropes, int segments) {
+  solver.clear();
+  solver.gravity = GRAVITY;
+  for (int r = 0; r < ropes; r++) {
+    vec2 start = {10.f * r, 0.f};
+    solver.add_rope(start, start + vec2(200.f, 0.f), segments, 1.f, 0.f,
+                    true);
+  }
+}
+
+// Largest relative stretch of a link after two seconds of swinging
+bool check_rigid_rope() {
+  RopeSolver solver;
+  solver.iterations = 20;
+  solver.gravity = GRAVITY;
+  const int segments = 16;
+  const vec2 start = {100.f, 50.f};
+  RopeSolver::Rope rope =
+      solver.add_rope(start, start + vec2(160.f, 0.f), segments, 1.f, 0.f, true);
+  for (int i = 0; i < STEPS; i++) solver.step(STEP_SECONDS);
+
+  float rest = 160.f / segments;
+  float worst = 0.f;
+  for (unsigned int i = 1; i < rope.particle_count; i++) {
+    float link = glm::length(solver.position(rope.first_particle + i) -
+                             solver.position(rope.first_particle + i - 1));
+    worst = std::max(worst, std::abs(link - rest) / rest);
+  }
+  float pin_error = glm::length(solver.position(rope.first_particle) - start);
+  printf("rigid rope: worst stretch %.2f%%, pin moved %.4f px\n",
+         worst * 100.f, pin_error);
+  return worst < 0.05f && pin_error == 0.f;
+}
+
+int main() {
+  bool ok = check_rigid_rope();
+
+  printf("%8s %10s %12s %14s %16s\n", "ropes", "segments", "particles",
+         "ms/step", "ns/constraint");
+  for (int ropes : {10, 100, 1000}) {
+    for (int segments : {8, 32, 64}) {
+      RopeSolver solver;
+      create_ropes(solver, ropes, segments);
+      auto start = std::chrono::high_resolution_clock::now();
+      for (int i = 0; i < STEPS; i++) solver.step(STEP_SECONDS);
+      auto end = std::chrono::high_resolution_clock::now();
+      double ms =
+          std::chrono::duration<double, std::milli>(end - start).count() /
+          STEPS;
+      double ns_per_constraint = ms * 1e6 / (solver.constraint_count() *
+                                             solver.iterations);
+      printf("%8d %10d %12zu %14.4f %16.2f\n", ropes, segments,
+             solver.particle_count(), ms, ns_per_constraint);
+    }
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
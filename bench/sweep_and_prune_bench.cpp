@@ -0,0 +1,132 @@
+/**
+ * @file sweep_and_prune_bench.cpp
+ * @author Team Doge
+ * @brief Compares the SpatialHash and SweepAndPrune broad phases on the Mac
+ * rock workload: 50x50 rocks moving at (-100, +-100) px/s and bouncing off
+ * the walls of the 1200x675 scene, with 25, 250 and 2500 rocks. Also checks
+ * that both report the same pairs.
+ * @version 0.1
+ * @date 2021-12-02
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+// stlib
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// internal
+#include "broad_phase.hpp"
+
+using glm::vec2;
+
+const vec2 WINDOW_SIZE = {1200.f, 675.f};
+const vec2 ROCK_HALF_EXTENTS = {25.f, 25.f};
+const int FRAMES = 600;
+const float STEP_SECONDS = 1.f / 60.f;
+
+struct Rocks {
+  std::vector<vec2> position;
+  std::vector<vec2> velocity;
+};
+
+Rocks create_rocks(int count) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> uniform_dist(0.f, 1.f);
+  Rocks rocks;
+  for (int i = 0; i < count; i++) {
+    rocks.position.push_back(
+        {uniform_dist(rng) * WINDOW_SIZE.x,
+         50.f + uniform_dist(rng) * (WINDOW_SIZE.y - 100.f)});
+    rocks.velocity.push_back(
+        {-100.f, uniform_dist(rng) < 0.5f ? -100.f : 100.f});
+  }
+  return rocks;
+}
+
+// Same wall response as MacPhysicsSystem::handleMeshWallCollisions
+void move(Rocks &rocks) {
+  for (size_t i = 0; i < rocks.position.size(); i++) {
+    vec2 &p = rocks.position[i];
+    vec2 &v = rocks.velocity[i];
+    p += v * STEP_SECONDS;
+    if ((p.y < 0 && v.y < 0) || (p.y > WINDOW_SIZE.y && v.y > 0)) v.y = -v.y;
+    if ((p.x < 0 && v.x < 0) || (p.x > WINDOW_SIZE.x && v.x > 0)) v.x = -v.x;
+  }
+}
+
+void find_pairs(BroadPhase &broad_phase, const Rocks &rocks,
+                std::vector<BroadPhasePair> &out_pairs) {
+  broad_phase.clear();
+  for (size_t i = 0; i < rocks.position.size(); i++)
+    broad_phase.insert((unsigned int)i, rocks.position[i], ROCK_HALF_EXTENTS);
+  broad_phase.find_pairs(out_pairs);
+}
+
+bool same_pairs(std::vector<BroadPhasePair> a, std::vector<BroadPhasePair> b) {
+  auto less = [](const BroadPhasePair &l, const BroadPhasePair &r) {
+    return l.a < r.a || (l.a == r.a && l.b < r.b);
+  };
+  std::sort(a.begin(), a.end(), less);
+  std::sort(b.begin(), b.end(), less);
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); i++)
+    if (a[i].a != b[i].a || a[i].b != b[i].b) return false;
+  return true;
+}
+
+// Milliseconds per frame of moving the rocks and finding the pairs
+double run(BroadPhase &broad_phase, Rocks rocks, size_t &out_pair_count) {
+  std::vector<BroadPhasePair> pairs;
+  size_t pair_count = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int frame = 0; frame < FRAMES; frame++) {
+    move(rocks);
+    find_pairs(broad_phase, rocks, pairs);
+    pair_count += pairs.size();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  out_pair_count = pair_count / FRAMES;
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         FRAMES;
+}
+
+int main() {
+  printf("%8s %12s %16s %16s\n", "rocks", "pairs/frame", "hash ms/frame",
+         "sweep ms/frame");
+  bool ok = true;
+  for (int count : {25, 250, 2500}) {
+    Rocks rocks = create_rocks(count);
+
+    // Both must agree, also once the sweep order has been reused for a while
+    SpatialHash spatial_hash(64.f);
+    SweepAndPrune sweep_and_prune(0);
+    std::vector<BroadPhasePair> hash_pairs, sweep_pairs;
+    Rocks check = rocks;
+    for (int frame = 0; frame < 60; frame++) {
+      move(check);
+      find_pairs(spatial_hash, check, hash_pairs);
+      find_pairs(sweep_and_prune, check, sweep_pairs);
+      if (!same_pairs(hash_pairs, sweep_pairs)) {
+        fprintf(stderr, "%d rocks, frame %d: %zu pairs in the hash, %zu in "
+                "the sweep\n", count, frame, hash_pairs.size(),
+                sweep_pairs.size());
+        ok = false;
+        break;
+      }
+    }
+
+    size_t hash_pair_count, sweep_pair_count;
+    SpatialHash timed_hash(64.f);
+    SweepAndPrune timed_sweep(0);
+    double hash_ms = run(timed_hash, rocks, hash_pair_count);
+    double sweep_ms = run(timed_sweep, rocks, sweep_pair_count);
+    printf("%8d %12zu %16.4f %16.4f\n", count, hash_pair_count, hash_ms,
+           sweep_ms);
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
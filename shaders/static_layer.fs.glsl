@@ -0,0 +1,9 @@
+#version 330
+
+uniform sampler2D layer_texture;
+
+in vec2 texcoord;
+
+layout(location = 0) out vec4 color;
+
+void main() { color = texture(layer_texture, texcoord); }
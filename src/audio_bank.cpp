@@ -0,0 +1,124 @@
+#include "audio_bank.hpp"
+
+// stlib
+#include <chrono>
+#include <cstdio>
+
+// internal
+#include "common.hpp"
+
+AudioBank audio_bank;
+
+AudioBank::~AudioBank() { close(); }
+
+bool AudioBank::open(bool headless) {
+  if (headless) SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+  if (SDL_Init(SDL_INIT_AUDIO) < 0) {
+    fprintf(stderr, "Failed to initialize SDL Audio");
+    return false;
+  }
+  if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) == -1) {
+    fprintf(stderr, "Failed to open audio device");
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = false;
+    is_open = true;
+    loader = std::thread(&AudioBank::load, this);
+  }
+  // the chunks are converted to the format of the device, so sounds asked
+  // for before it was open are only decoded now
+  sound_library.set_on_new([this](const Sound &sample) { enqueue(sample); });
+  return true;
+}
+
+void AudioBank::close() {
+  if (!is_open) return;
+  sound_library.set_on_new(nullptr);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  loader.join();
+
+  Mix_HaltChannel(-1);
+  is_open = false;
+  for (const Sound &sample : samples) {
+    Mix_Chunk *chunk = sample->chunk.exchange(nullptr);
+    if (chunk != nullptr) Mix_FreeChunk(chunk);
+  }
+  samples.clear();
+  queue.clear();
+  decoded_bytes = 0;
+  Mix_CloseAudio();
+  SDL_QuitSubSystem(SDL_INIT_AUDIO);
+  loaded.notify_all();
+}
+
+void AudioBank::enqueue(const Sound &sample) {
+  std::lock_guard<std::mutex> lock(mutex);
+  samples.push_back(sample);
+  queue.push_back(sample);
+  wake.notify_one();
+}
+
+void AudioBank::play(int channel, const Sound &sound, int loops) {
+  if (!is_open || sound == nullptr) return;
+  Mix_Chunk *chunk = sound->chunk;
+  if (chunk != nullptr) Mix_PlayChannel(channel, chunk, loops);
+}
+
+bool AudioBank::playing(int channel) {
+  return is_open && Mix_Playing(channel) != 0;
+}
+
+void AudioBank::wait_loaded() {
+  std::unique_lock<std::mutex> lock(mutex);
+  loaded.wait(lock, [&] { return !is_open || (queue.empty() && !decoding); });
+}
+
+size_t AudioBank::pcm_bytes() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return decoded_bytes;
+}
+
+void AudioBank::load() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    wake.wait(lock, [&] { return stopping || !queue.empty(); });
+    if (stopping) return;
+    Sound sample = queue.front();
+    queue.pop_front();
+    decoding = true;
+
+    lock.unlock();
+    auto start = std::chrono::steady_clock::now();
+    Mix_Chunk *chunk = Mix_LoadWAV(audio_path(sample->file).c_str());
+    if (chunk == nullptr)
+      fprintf(stderr, "Could not load the sound %s: %s\n",
+              sample->file.c_str(), Mix_GetError());
+    float ms = std::chrono::duration<float, std::milli>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+    lock.lock();
+
+    sample->chunk = chunk;
+    if (chunk != nullptr) decoded_bytes += chunk->alen;
+    decode_ms += ms;
+    decoding = false;
+    if (queue.empty()) {
+      size_t sounds = samples.size(), bytes = decoded_bytes;
+      float total_ms = decode_ms;
+      loaded.notify_all();
+      // the library calls enqueue under its own lock
+      lock.unlock();
+      printf("Audio bank: %zu sounds for %zu requests, %zu KB of PCM, "
+             "decoded in %.1f ms\n",
+             sounds, sound_library.requests(), bytes / 1024, total_ms);
+      lock.lock();
+    }
+  }
+}
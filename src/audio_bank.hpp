@@ -0,0 +1,63 @@
+#pragma once
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <SDL_mixer.h>
+
+// stlib
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// internal
+#include "sound.hpp"
+
+// Owns the audio device and decodes the sounds of the sound_library.
+//
+// The scenes ask the library for their sounds by file name when they are
+// created. While the device is open each new file is decoded once, by a
+// loader thread, while the scenes go on loading their textures, and every
+// scene asking for it shares the same sample. A sound played before it is
+// decoded is skipped, as is any sound while the device is not open.
+class AudioBank {
+ public:
+  ~AudioBank();
+
+  // Opens the device and starts decoding, the dummy driver when headless
+  bool open(bool headless);
+
+  // Stops the loader, frees the decoded samples and closes the device
+  void close();
+
+  // Mix_PlayChannel and Mix_Playing that do nothing without the sample or
+  // the device
+  void play(int channel, const Sound &sound, int loops);
+  bool playing(int channel);
+
+  // Blocks until every sound asked for so far is decoded, for the benchmark
+  void wait_loaded();
+
+  // Bytes of decoded PCM held by the bank
+  size_t pcm_bytes();
+
+ private:
+  std::mutex mutex;
+  std::condition_variable wake, loaded;
+  std::vector<Sound> samples;  // handed to the bank while open
+  std::deque<Sound> queue;     // waiting for the loader
+  bool decoding = false;
+  bool stopping = false;
+  std::atomic<bool> is_open{false};
+  std::thread loader;
+
+  // statistics printed each time the loader runs out of work
+  size_t decoded_bytes = 0;
+  float decode_ms = 0.f;
+
+  void enqueue(const Sound &sample);
+  void load();
+};
+extern AudioBank audio_bank;
@@ -0,0 +1,65 @@
+#include "body_sleep.hpp"
+
+// stlib
+#include <algorithm>
+
+SleepStats update_sleeping_bodies(ECSRegistry &registry) {
+  const float sleep_speed_squared = SLEEP_SPEED * SLEEP_SPEED;
+  ComponentContainer<Velocity> &velocities = registry.velocities;
+  SleepStats sleep_stats;
+  for (uint i = 0; i < velocities.size(); i++) {
+    Entity entity = velocities.entities[i];
+    vec2 &velocity = velocities.components[i].velocity;
+    if (registry.sleepers.has(entity)) {
+      if (velocity != vec2(0.f)) {
+        wake_body(registry, entity);
+        sleep_stats.awake++;
+      } else {
+        sleep_stats.asleep++;
+      }
+      continue;
+    }
+
+    if (dot(velocity, velocity) >= sleep_speed_squared) {
+      sleep_stats.awake++;
+      if (registry.stillness.has(entity))
+        registry.stillness.get(entity).steps = 0;
+      continue;
+    }
+    if (!registry.stillness.has(entity)) registry.stillness.emplace(entity);
+    if (++registry.stillness.get(entity).steps >= SLEEP_STEPS) {
+      velocity = vec2(0.f);
+      registry.sleepers.emplace(entity);
+      sleep_stats.asleep++;
+    } else {
+      sleep_stats.awake++;
+    }
+  }
+  return sleep_stats;
+}
+
+void wake_body(ECSRegistry &registry, Entity entity) {
+  if (registry.sleepers.has(entity)) registry.sleepers.remove(entity);
+  if (registry.stillness.has(entity)) registry.stillness.get(entity).steps = 0;
+}
+
+void drop_sleeping_pairs(ECSRegistry &registry,
+                         const std::vector<Entity> &entities,
+                         std::vector<BroadPhasePair> &pairs) {
+  if (registry.sleepers.size() < 2) return;
+  pairs.erase(std::remove_if(pairs.begin(), pairs.end(),
+                             [&](const BroadPhasePair &pair) {
+                               return registry.sleepers.has(
+                                          entities[pair.a]) &&
+                                      registry.sleepers.has(entities[pair.b]);
+                             }),
+              pairs.end());
+}
+
+void wake_contacts(ECSRegistry &registry, const std::vector<Entity> &entities,
+                   const std::vector<BroadPhasePair> &contacts) {
+  for (const BroadPhasePair &contact : contacts) {
+    wake_body(registry, entities[contact.a]);
+    wake_body(registry, entities[contact.b]);
+  }
+}
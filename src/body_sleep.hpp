@@ -0,0 +1,50 @@
+#pragma once
+
+// stlib
+#include <stddef.h>
+
+#include <vector>
+
+// internal
+#include "broad_phase.hpp"
+#include "components.hpp"
+#include "tiny_ecs_registry.hpp"
+
+// Sleeping bodies, shared by the physics systems (see Sleeping).
+//
+// Each physics step starts with update_sleeping_bodies, the integration loops
+// then skip the sleepers and the contact loops wake the bodies they report.
+
+// px/s, slower bodies count as still
+const float SLEEP_SPEED = 1.f;
+// half a second at 120 Hz
+const int SLEEP_STEPS = 60;
+
+// Bodies of a physics step. The physics systems keep those of their last
+// step, the simulation thread prints those of the current scene.
+struct SleepStats {
+  size_t awake = 0;
+  size_t asleep = 0;
+};
+
+// Wakes the sleepers whose velocity was written since the last step and puts
+// the bodies that were still for SLEEP_STEPS steps to sleep. Returns the
+// bodies awake and asleep after it.
+SleepStats update_sleeping_bodies(ECSRegistry &registry);
+
+inline bool is_asleep(ECSRegistry &registry, Entity entity) {
+  return registry.sleepers.has(entity);
+}
+
+// Leaves the body asleep until it was still for SLEEP_STEPS steps again
+void wake_body(ECSRegistry &registry, Entity entity);
+
+// Two sleepers were not moving, they cannot have started touching. Drops
+// their pairs before the narrow phase, the ids of the pairs index entities.
+void drop_sleeping_pairs(ECSRegistry &registry,
+                         const std::vector<Entity> &entities,
+                         std::vector<BroadPhasePair> &pairs);
+
+// Wakes both bodies of every contact
+void wake_contacts(ECSRegistry &registry, const std::vector<Entity> &entities,
+                   const std::vector<BroadPhasePair> &contacts);
@@ -0,0 +1,406 @@
+#include "boids.hpp"
+
+// stlib
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Below this the threads would mostly wait on each other
+const size_t MIN_PARALLEL_BIRDS = 4096;
+// birds per task when the work is not split by grid rows
+const size_t CHUNK_BIRDS = 16384;
+
+SimdLevel selected_level = simd_best_level();
+
+// Runs task for [0, count) on the job system, or on this thread without one
+template <typename Task>
+void run(JobSystem* jobs, unsigned int count, const Task& task) {
+  if (jobs) {
+    jobs->parallel_for(count, 1, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) task((unsigned int)i);
+    });
+  } else {
+    for (unsigned int i = 0; i < count; i++) task(i);
+  }
+}
+
+// Front buffer as seen by the neighbor kernels
+struct Flock {
+  const float *x, *y;
+  const float *vx, *vy;
+};
+
+// What a bird sees of the birds around it
+struct NeighborSums {
+  float pos_x = 0, pos_y = 0;
+  float vel_x = 0, vel_y = 0;
+  float close_x = 0, close_y = 0;
+  float count = 0;
+};
+
+// The runs of the front buffer a bird looks at: the three cells of each
+// neighbor row, without the bird itself
+struct NeighborRuns {
+  unsigned int begin[6], end[6];
+  int count = 0;
+
+  void add(unsigned int first, unsigned int last) {
+    if (first == last) return;
+    begin[count] = first;
+    end[count] = last;
+    count++;
+  }
+};
+
+// The neighbor kernels add the birds of the runs to sums. The squared
+// distances are a multiply and an add in every kernel, so all of them put a
+// bird in the same range; only the order of the additions differs.
+
+inline void accumulate(const Flock& flock, unsigned int begin,
+                       unsigned int end, float px, float py,
+                       float protected_squared, float visual_squared,
+                       NeighborSums& sums) {
+  for (unsigned int j = begin; j < end; j++) {
+    float dx = px - flock.x[j];
+    float dy = py - flock.y[j];
+    float squared_distance = dx * dx + dy * dy;
+    if (squared_distance < protected_squared) {
+      sums.close_x += dx;
+      sums.close_y += dy;
+    } else if (squared_distance < visual_squared) {
+      sums.pos_x += flock.x[j];
+      sums.pos_y += flock.y[j];
+      sums.vel_x += flock.vx[j];
+      sums.vel_y += flock.vy[j];
+      sums.count += 1;
+    }
+  }
+}
+
+void accumulate_scalar(const Flock& flock, const NeighborRuns& runs, float px,
+                       float py, float protected_squared, float visual_squared,
+                       NeighborSums& sums) {
+  for (int r = 0; r < runs.count; r++)
+    accumulate(flock, runs.begin[r], runs.end[r], px, py, protected_squared,
+               visual_squared, sums);
+}
+
+#if SIMD_X86
+
+// The SIMD kernels test a whole batch of birds and add each of them to the
+// sums of its range with a mask. The lanes are only added together once all
+// the runs are done.
+
+inline float sum4(__m128 v) {
+  __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+// SSE: 4 birds per batch, the birds after the last full batch of a run are
+// added one by one
+
+const unsigned int SSE_LANES = 4;
+
+void accumulate_sse(const Flock& flock, const NeighborRuns& runs, float px,
+                    float py, float protected_squared, float visual_squared,
+                    NeighborSums& sums) {
+  const __m128 x_i = _mm_set1_ps(px), y_i = _mm_set1_ps(py);
+  const __m128 protected4 = _mm_set1_ps(protected_squared);
+  const __m128 visual4 = _mm_set1_ps(visual_squared);
+  const __m128 one = _mm_set1_ps(1.f);
+  __m128 pos_x = _mm_setzero_ps(), pos_y = _mm_setzero_ps();
+  __m128 vel_x = _mm_setzero_ps(), vel_y = _mm_setzero_ps();
+  __m128 close_x = _mm_setzero_ps(), close_y = _mm_setzero_ps();
+  __m128 count = _mm_setzero_ps();
+  for (int r = 0; r < runs.count; r++) {
+    unsigned int j = runs.begin[r];
+    for (; j + SSE_LANES <= runs.end[r]; j += SSE_LANES) {
+      __m128 x_j = _mm_loadu_ps(flock.x + j), y_j = _mm_loadu_ps(flock.y + j);
+      __m128 dx = _mm_sub_ps(x_i, x_j), dy = _mm_sub_ps(y_i, y_j);
+      __m128 squared_distance =
+          _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+      __m128 close = _mm_cmplt_ps(squared_distance, protected4);
+      __m128 seen =
+          _mm_andnot_ps(close, _mm_cmplt_ps(squared_distance, visual4));
+      close_x = _mm_add_ps(close_x, _mm_and_ps(close, dx));
+      close_y = _mm_add_ps(close_y, _mm_and_ps(close, dy));
+      pos_x = _mm_add_ps(pos_x, _mm_and_ps(seen, x_j));
+      pos_y = _mm_add_ps(pos_y, _mm_and_ps(seen, y_j));
+      vel_x =
+          _mm_add_ps(vel_x, _mm_and_ps(seen, _mm_loadu_ps(flock.vx + j)));
+      vel_y =
+          _mm_add_ps(vel_y, _mm_and_ps(seen, _mm_loadu_ps(flock.vy + j)));
+      count = _mm_add_ps(count, _mm_and_ps(seen, one));
+    }
+    accumulate(flock, j, runs.end[r], px, py, protected_squared,
+               visual_squared, sums);
+  }
+  sums.pos_x += sum4(pos_x);
+  sums.pos_y += sum4(pos_y);
+  sums.vel_x += sum4(vel_x);
+  sums.vel_y += sum4(vel_y);
+  sums.close_x += sum4(close_x);
+  sums.close_y += sum4(close_y);
+  sums.count += sum4(count);
+}
+
+// AVX2: 8 birds per batch, the last batch of a run is loaded with a mask of
+// the birds left so every bird goes through the vector path
+
+const int AVX2_LANES = 8;
+
+SIMD_TARGET_AVX2_EXACT inline float sum8(__m256 v) {
+  return sum4(_mm_add_ps(_mm256_castps256_ps128(v),
+                         _mm256_extractf128_ps(v, 1)));
+}
+
+struct Lanes8 {
+  __m256 pos_x, pos_y;
+  __m256 vel_x, vel_y;
+  __m256 close_x, close_y;
+  __m256 count;
+};
+
+// Adds the birds of a batch whose lane is set in valid
+SIMD_TARGET_AVX2_EXACT inline void add8(__m256 x_i, __m256 y_i,
+                                        __m256 protected8, __m256 visual8,
+                                        __m256 x_j, __m256 y_j, __m256 vx_j,
+                                        __m256 vy_j, __m256 valid,
+                                        Lanes8& lanes) {
+  __m256 dx = _mm256_sub_ps(x_i, x_j), dy = _mm256_sub_ps(y_i, y_j);
+  // not fused (SIMD_TARGET_AVX2_EXACT), the distance rounds like the others
+  __m256 squared_distance =
+      _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+  __m256 close = _mm256_and_ps(
+      valid, _mm256_cmp_ps(squared_distance, protected8, _CMP_LT_OQ));
+  __m256 seen = _mm256_andnot_ps(
+      close, _mm256_and_ps(valid, _mm256_cmp_ps(squared_distance, visual8,
+                                                _CMP_LT_OQ)));
+  lanes.close_x = _mm256_add_ps(lanes.close_x, _mm256_and_ps(close, dx));
+  lanes.close_y = _mm256_add_ps(lanes.close_y, _mm256_and_ps(close, dy));
+  lanes.pos_x = _mm256_add_ps(lanes.pos_x, _mm256_and_ps(seen, x_j));
+  lanes.pos_y = _mm256_add_ps(lanes.pos_y, _mm256_and_ps(seen, y_j));
+  lanes.vel_x = _mm256_add_ps(lanes.vel_x, _mm256_and_ps(seen, vx_j));
+  lanes.vel_y = _mm256_add_ps(lanes.vel_y, _mm256_and_ps(seen, vy_j));
+  lanes.count = _mm256_add_ps(
+      lanes.count, _mm256_and_ps(seen, _mm256_set1_ps(1.f)));
+}
+
+SIMD_TARGET_AVX2_EXACT void accumulate_avx2(const Flock& flock,
+                                            const NeighborRuns& runs,
+                                            float px, float py,
+                                            float protected_squared,
+                                            float visual_squared,
+                                            NeighborSums& sums) {
+  const __m256 x_i = _mm256_set1_ps(px), y_i = _mm256_set1_ps(py);
+  const __m256 protected8 = _mm256_set1_ps(protected_squared);
+  const __m256 visual8 = _mm256_set1_ps(visual_squared);
+  const __m256 all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+  const __m256i lane_index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  Lanes8 lanes;
+  lanes.pos_x = lanes.pos_y = _mm256_setzero_ps();
+  lanes.vel_x = lanes.vel_y = _mm256_setzero_ps();
+  lanes.close_x = lanes.close_y = _mm256_setzero_ps();
+  lanes.count = _mm256_setzero_ps();
+  for (int r = 0; r < runs.count; r++) {
+    unsigned int j = runs.begin[r];
+    for (; j + AVX2_LANES <= runs.end[r]; j += AVX2_LANES) {
+      add8(x_i, y_i, protected8, visual8, _mm256_loadu_ps(flock.x + j),
+           _mm256_loadu_ps(flock.y + j), _mm256_loadu_ps(flock.vx + j),
+           _mm256_loadu_ps(flock.vy + j), all, lanes);
+    }
+    int left = (int)(runs.end[r] - j);
+    if (left > 0) {
+      // the masked lanes are not read and load as 0
+      __m256i mask =
+          _mm256_cmpgt_epi32(_mm256_set1_epi32(left), lane_index);
+      add8(x_i, y_i, protected8, visual8,
+           _mm256_maskload_ps(flock.x + j, mask),
+           _mm256_maskload_ps(flock.y + j, mask),
+           _mm256_maskload_ps(flock.vx + j, mask),
+           _mm256_maskload_ps(flock.vy + j, mask),
+           _mm256_castsi256_ps(mask), lanes);
+    }
+  }
+  sums.pos_x += sum8(lanes.pos_x);
+  sums.pos_y += sum8(lanes.pos_y);
+  sums.vel_x += sum8(lanes.vel_x);
+  sums.vel_y += sum8(lanes.vel_y);
+  sums.close_x += sum8(lanes.close_x);
+  sums.close_y += sum8(lanes.close_y);
+  sums.count += sum8(lanes.count);
+}
+
+#endif  // SIMD_X86
+
+}  // namespace
+
+void Boids::clear() {
+  x.clear();
+  y.clear();
+  vx.clear();
+  vy.clear();
+}
+
+unsigned int Boids::add(glm::vec2 position, glm::vec2 velocity) {
+  x.push_back(position.x);
+  y.push_back(position.y);
+  vx.push_back(velocity.x);
+  vy.push_back(velocity.y);
+  return (unsigned int)x.size() - 1;
+}
+
+void Boids::set(unsigned int bird, glm::vec2 position, glm::vec2 velocity) {
+  x[bird] = position.x;
+  y[bird] = position.y;
+  vx[bird] = velocity.x;
+  vy[bird] = velocity.y;
+}
+
+void Boids::build_grid(JobSystem* jobs) {
+  columns = std::max(1, (int)std::ceil(bounds.x / visual_range));
+  rows = std::max(1, (int)std::ceil(bounds.y / visual_range));
+  unsigned int cells = (unsigned int)(columns * rows);
+  size_t count = x.size();
+
+  // Birds out of bounds go to the edge cells. The edge cells get larger but
+  // still hold every bird a bird in them can see.
+  cell.resize(count);
+  unsigned int chunks = (unsigned int)((count + CHUNK_BIRDS - 1) / CHUNK_BIRDS);
+  run(jobs, chunks, [&](unsigned int chunk) {
+    size_t end = std::min(count, (chunk + 1) * CHUNK_BIRDS);
+    for (size_t i = chunk * CHUNK_BIRDS; i < end; i++) {
+      int column =
+          std::min(std::max((int)(x[i] / visual_range), 0), columns - 1);
+      int row = std::min(std::max((int)(y[i] / visual_range), 0), rows - 1);
+      cell[i] = (unsigned int)(row * columns + column);
+    }
+  });
+  cell_start.assign(cells + 1, 0);
+  for (size_t i = 0; i < count; i++) cell_start[cell[i] + 1]++;
+  for (unsigned int c = 0; c < cells; c++) cell_start[c + 1] += cell_start[c];
+
+  // counting sort, the birds of a cell keep their order
+  order.resize(count);
+  next_slot.assign(cell_start.begin(), cell_start.end() - 1);
+  for (size_t i = 0; i < count; i++)
+    order[next_slot[cell[i]]++] = (unsigned int)i;
+
+  // fill the front buffer row by row
+  sorted_x.resize(count);
+  sorted_y.resize(count);
+  sorted_vx.resize(count);
+  sorted_vy.resize(count);
+  run(jobs, (unsigned int)rows, [&](unsigned int row) {
+    unsigned int end = cell_start[(row + 1) * columns];
+    for (unsigned int slot = cell_start[row * columns]; slot < end; slot++) {
+      unsigned int bird = order[slot];
+      sorted_x[slot] = x[bird];
+      sorted_y[slot] = y[bird];
+      sorted_vx[slot] = vx[bird];
+      sorted_vy[slot] = vy[bird];
+    }
+  });
+}
+
+void Boids::steer(unsigned int slot, int column, int row) {
+  const float protected_squared = protected_range * protected_range;
+  const float visual_squared = visual_range * visual_range;
+  float px = sorted_x[slot], py = sorted_y[slot];
+
+  const Flock flock = {sorted_x.data(), sorted_y.data(), sorted_vx.data(),
+                       sorted_vy.data()};
+  NeighborSums sums;
+
+  NeighborRuns runs;
+  int first_column = std::max(column - 1, 0);
+  int last_column = std::min(column + 1, columns - 1);
+  for (int r = std::max(row - 1, 0); r <= std::min(row + 1, rows - 1); r++) {
+    unsigned int begin = cell_start[r * columns + first_column];
+    unsigned int end = cell_start[r * columns + last_column + 1];
+    // around the bird itself
+    if (slot >= begin && slot < end) {
+      runs.add(begin, slot);
+      begin = slot + 1;
+    }
+    runs.add(begin, end);
+  }
+#if SIMD_X86
+  if (selected_level == SimdLevel::AVX2) {
+    accumulate_avx2(flock, runs, px, py, protected_squared, visual_squared,
+                    sums);
+  } else if (selected_level == SimdLevel::SSE) {
+    accumulate_sse(flock, runs, px, py, protected_squared, visual_squared,
+                   sums);
+  } else
+#endif
+  {
+    accumulate_scalar(flock, runs, px, py, protected_squared, visual_squared,
+                      sums);
+  }
+
+  float vel_x = sorted_vx[slot], vel_y = sorted_vy[slot];
+  if (sums.count > 0) {
+    float inverse = 1.f / sums.count;
+    vel_x += (sums.pos_x * inverse - px) * centering_factor +
+             (sums.vel_x * inverse - vel_x) * matching_factor;
+    vel_y += (sums.pos_y * inverse - py) * centering_factor +
+             (sums.vel_y * inverse - vel_y) * matching_factor;
+  }
+  vel_x += sums.close_x * avoid_factor;
+  vel_y += sums.close_y * avoid_factor;
+
+  // turn back at the edges of the screen
+  if (py < 0) {
+    py = 0;
+    vel_y += turn_factor;
+  } else if (py > bounds.y) {
+    py = bounds.y;
+    vel_y -= turn_factor;
+  }
+  if (px < 0) {
+    px = 0;
+    vel_x += turn_factor;
+  } else if (px > bounds.x) {
+    px = bounds.x;
+    vel_x -= turn_factor;
+  }
+
+  float speed = std::sqrt(vel_x * vel_x + vel_y * vel_y);
+  if (speed > 0 && speed < min_speed) {
+    vel_x = vel_x / speed * min_speed;
+    vel_y = vel_y / speed * min_speed;
+  } else if (speed > max_speed) {
+    vel_x = vel_x / speed * max_speed;
+    vel_y = vel_y / speed * max_speed;
+  }
+
+  unsigned int bird = order[slot];
+  x[bird] = px;
+  y[bird] = py;
+  vx[bird] = vel_x;
+  vy[bird] = vel_y;
+}
+
+void Boids::steer_row(int row) {
+  for (int column = 0; column < columns; column++) {
+    unsigned int c = (unsigned int)(row * columns + column);
+    for (unsigned int slot = cell_start[c]; slot < cell_start[c + 1]; slot++)
+      steer(slot, column, row);
+  }
+}
+
+void Boids::step(JobSystem* jobs) {
+  if (x.empty()) return;
+  if (x.size() < MIN_PARALLEL_BIRDS) jobs = nullptr;
+  build_grid(jobs);
+  // row by row, the birds of a cell look at the same neighbors
+  run(jobs, (unsigned int)rows, [&](unsigned int row) { steer_row(row); });
+}
+
+SimdLevel boids_simd_level() { return selected_level; }
+
+void set_boids_simd_level(SimdLevel level) {
+  selected_level = std::min(level, simd_best_level());
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+// stlib
+#include <vector>
+
+// The glm library provides vector and matrix operations as in GLSL
+#include <glm/vec2.hpp>  // vec2
+
+// internal
+#include "simd.hpp"
+#include "job_system.hpp"
+
+// Grid accelerated boids for the shower swarm.
+//
+// The birds live in flat arrays, one per field. Every step sorts them into a
+// uniform grid whose cells are visual_range wide, so all the birds a bird can
+// see are in the 3x3 cells around its own. The cells are stored row by row,
+// which makes the three cells of a neighbor row one contiguous run of the
+// sorted arrays.
+//
+// A step only changes the velocities (and pushes the birds that left the
+// bounds back to the edge), moving the birds along their velocity is left to
+// the physics system.
+//
+// The neighbors in a row of cells are tested 8 at a time with AVX2, 4 with
+// SSE, or one by one on other CPUs. The SIMD kernels add up the birds in a
+// different order than the scalar one, so their results differ from it by
+// rounding.
+//
+// The step is double buffered: sorting into the grid copies the birds into a
+// front buffer that stays untouched while every bird writes its new state to
+// the back buffer, the arrays by bird index. A bird only reads the front
+// buffer, so the grid rows can be steered as jobs of a JobSystem and the
+// result is the same bit for bit whatever the thread count.
+//
+// Like the broad phase, nothing in here touches the ECS or OpenGL.
+class Boids {
+ public:
+  // Speed added per step towards the inside when a bird is out of bounds
+  float turn_factor = 20.f;
+  // Birds closer than visual_range are flockmates, closer than
+  // protected_range they are pushed apart
+  float visual_range = 30.f;
+  float protected_range = 10.f;
+  // Steering towards the center, away from close birds and along the heading
+  // of the flockmates
+  float centering_factor = 0.f;
+  float avoid_factor = 0.1f;
+  float matching_factor = 0.01f;
+  // Speed limits in px/s
+  float min_speed = 20.f;
+  float max_speed = 40.f;
+  // The birds stay in [0, bounds]
+  glm::vec2 bounds = {1200.f, 675.f};
+
+  // Removes all birds
+  void clear();
+
+  // Returns the index of the bird
+  unsigned int add(glm::vec2 position, glm::vec2 velocity);
+
+  // Steers every bird once, splitting the grid rows into jobs when there are
+  // enough birds
+  void step(JobSystem* jobs = nullptr);
+
+  glm::vec2 position(unsigned int bird) const { return {x[bird], y[bird]}; }
+  glm::vec2 velocity(unsigned int bird) const { return {vx[bird], vy[bird]}; }
+  void set(unsigned int bird, glm::vec2 position, glm::vec2 velocity);
+
+  size_t size() const { return x.size(); }
+
+ private:
+  // back buffer, by bird index
+  std::vector<float> x, y;
+  std::vector<float> vx, vy;
+
+  // grid of the current step and front buffer, by cell
+  int columns = 0, rows = 0;
+  std::vector<unsigned int> cell;        // of each bird
+  std::vector<unsigned int> cell_start;  // in the sorted arrays, cells + 1
+  std::vector<unsigned int> order;       // bird of each sorted slot
+  std::vector<unsigned int> next_slot;   // of each cell while sorting
+  std::vector<float> sorted_x, sorted_y;
+  std::vector<float> sorted_vx, sorted_vy;
+
+  void build_grid(JobSystem* jobs);
+  void steer(unsigned int slot, int column, int row);
+  void steer_row(int row);
+};
+
+// Level of the neighbor kernels, simd_best_level() unless overridden. Setting a
+// level above what the CPU supports falls back to the best supported one.
+SimdLevel boids_simd_level();
+void set_boids_simd_level(SimdLevel level);
@@ -0,0 +1,172 @@
+#include "broad_phase.hpp"
+
+// stlib
+#include <algorithm>
+#include <cmath>
+
+#include <glm/common.hpp>  // abs, max
+
+namespace {
+
+// Work of one job when the pair search is split
+const size_t CELLS_PER_JOB = 256;
+const size_t BODIES_PER_JOB = 512;
+
+}  // namespace
+
+void BroadPhase::for_each_pair(
+    const std::function<void(unsigned int, unsigned int)> &narrow_phase) {
+  find_pairs(pairs);
+  for (const BroadPhasePair &pair : pairs) narrow_phase(pair.a, pair.b);
+}
+
+void BroadPhase::clear() { bodies.clear(); }
+
+void BroadPhase::find_in_chunks(
+    size_t count, size_t grain,
+    const std::function<void(size_t, size_t, std::vector<BroadPhasePair> &)>
+        &find,
+    std::vector<BroadPhasePair> &out_pairs) {
+  if (!jobs || bodies.size() < MIN_PARALLEL_BODIES) {
+    find(0, count, out_pairs);
+    return;
+  }
+  chunk_pairs.resize((count + grain - 1) / grain);
+  jobs->parallel_for(count, grain, [&](size_t begin, size_t end) {
+    std::vector<BroadPhasePair> &chunk = chunk_pairs[begin / grain];
+    chunk.clear();
+    find(begin, end, chunk);
+  });
+  for (size_t c = 0; c < (count + grain - 1) / grain; c++)
+    out_pairs.insert(out_pairs.end(), chunk_pairs[c].begin(),
+                     chunk_pairs[c].end());
+}
+
+void BroadPhase::insert(unsigned int id, glm::vec2 position,
+                        glm::vec2 half_extents, unsigned int category,
+                        unsigned int mask) {
+  if (category == 0 || mask == 0) return;
+  half_extents = glm::abs(half_extents);
+  bodies.push_back({id, position - half_extents, position + half_extents,
+                    category, mask});
+}
+
+SpatialHash::SpatialHash(float cell_size)
+    : cell_size(cell_size), inv_cell_size(1.f / cell_size) {}
+
+glm::ivec2 SpatialHash::cell_of(glm::vec2 point) const {
+  return {(int)std::floor(point.x * inv_cell_size),
+          (int)std::floor(point.y * inv_cell_size)};
+}
+
+uint64_t SpatialHash::cell_key(glm::ivec2 cell) {
+  return (uint64_t)(uint32_t)cell.x << 32 | (uint32_t)cell.y;
+}
+
+void SpatialHash::find_pairs(std::vector<BroadPhasePair> &out_pairs) {
+  out_pairs.clear();
+  entries.clear();
+  large_bodies.clear();
+
+  // Bucket every body into the cells it touches
+  for (unsigned int i = 0; i < bodies.size(); i++) {
+    glm::ivec2 lo = cell_of(bodies[i].min);
+    glm::ivec2 hi = cell_of(bodies[i].max);
+    int64_t cells = (int64_t)(hi.x - lo.x + 1) * (hi.y - lo.y + 1);
+    if (cells > MAX_CELLS_PER_BODY) {
+      large_bodies.push_back(i);
+      continue;
+    }
+    for (int y = lo.y; y <= hi.y; y++)
+      for (int x = lo.x; x <= hi.x; x++) entries.push_back({cell_key({x, y}), i});
+  }
+  // Sorting by cell then by body keeps the output deterministic
+  std::sort(entries.begin(), entries.end(),
+            [](const CellEntry &l, const CellEntry &r) {
+              return l.cell < r.cell || (l.cell == r.cell && l.body < r.body);
+            });
+
+  cell_begin.clear();
+  for (size_t e = 0; e < entries.size(); e++)
+    if (e == 0 || entries[e].cell != entries[e - 1].cell)
+      cell_begin.push_back(e);
+  cell_begin.push_back(entries.size());
+
+  find_in_chunks(
+      cell_begin.size() - 1, CELLS_PER_JOB,
+      [&](size_t first, size_t last, std::vector<BroadPhasePair> &found) {
+        for (size_t c = first; c < last; c++) {
+          size_t begin = cell_begin[c], end = cell_begin[c + 1];
+          for (size_t p = begin; p < end; p++) {
+            const Body &a = bodies[entries[p].body];
+            for (size_t q = p + 1; q < end; q++) {
+              const Body &b = bodies[entries[q].body];
+              if (!overlaps(a, b)) continue;
+              // Only the cell owning the corner of the intersection reports it
+              if (cell_key(cell_of(glm::max(a.min, b.min))) !=
+                  entries[begin].cell)
+                continue;
+              found.push_back({a.id, b.id});
+            }
+          }
+        }
+      },
+      out_pairs);
+
+  // Large bodies against everything, pairs of large bodies only once
+  is_large.assign(bodies.size(), false);
+  for (unsigned int l : large_bodies) is_large[l] = true;
+  for (unsigned int l : large_bodies) {
+    for (unsigned int i = 0; i < bodies.size(); i++) {
+      if (i == l || (is_large[i] && i < l)) continue;
+      if (!overlaps(bodies[l], bodies[i])) continue;
+      if (i < l)
+        out_pairs.push_back({bodies[i].id, bodies[l].id});
+      else
+        out_pairs.push_back({bodies[l].id, bodies[i].id});
+    }
+  }
+}
+
+SweepAndPrune::SweepAndPrune(int axis) : axis(axis) {}
+
+void SweepAndPrune::find_pairs(std::vector<BroadPhasePair> &out_pairs) {
+  out_pairs.clear();
+  const unsigned int count = (unsigned int)bodies.size();
+
+  // Keep last frame's order for the bodies still there, append the new ones
+  unsigned int previous_count = (unsigned int)order.size();
+  order.erase(std::remove_if(order.begin(), order.end(),
+                             [count](unsigned int i) { return i >= count; }),
+              order.end());
+  for (unsigned int i = previous_count; i < count; i++) order.push_back(i);
+
+  // Insertion sort, few swaps when the bodies barely moved
+  for (unsigned int k = 1; k < count; k++) {
+    unsigned int body = order[k];
+    float start = bodies[body].min[axis];
+    unsigned int j = k;
+    for (; j > 0 && bodies[order[j - 1]].min[axis] > start; j--)
+      order[j] = order[j - 1];
+    order[j] = body;
+  }
+
+  // Sweep: only the bodies starting before this one ends can overlap it
+  find_in_chunks(
+      count, BODIES_PER_JOB,
+      [&](size_t first, size_t last, std::vector<BroadPhasePair> &found) {
+        for (size_t k = first; k < last; k++) {
+          const Body &a = bodies[order[k]];
+          for (size_t m = k + 1;
+               m < count && bodies[order[m]].min[axis] <= a.max[axis]; m++) {
+            const Body &b = bodies[order[m]];
+            if (!overlaps(a, b)) continue;
+            if (order[k] < order[m])
+              found.push_back({a.id, b.id});
+            else
+              found.push_back({b.id, a.id});
+          }
+        }
+      },
+      out_pairs);
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+// stlib
+#include <stdint.h>
+
+#include <functional>
+#include <vector>
+
+// The glm library provides vector and matrix operations as in GLSL
+#include <glm/ext/vector_int2.hpp>  // ivec2
+#include <glm/vec2.hpp>             // vec2
+
+// internal
+#include "job_system.hpp"
+
+// Broad phase collision detection shared by the physics systems of all scenes.
+//
+// Every frame the physics system clears the broad phase, inserts one axis
+// aligned box per body and asks for the overlapping pairs. Each unordered pair
+// is reported exactly once, with the lower insertion index first, and the
+// scene runs its own narrow phase test on it. Ids are chosen by the caller,
+// usually the index of the body in its ComponentContainer so the narrow phase
+// can read the components without a map lookup.
+//
+// Given a job system, the pair search of large worlds is split into chunks
+// that run as jobs. Each chunk collects its own pairs and the chunks are
+// appended in order, so the pairs come out the same as on one thread.
+//
+// Nothing in here touches the ECS or OpenGL so the benchmarks can run it
+// headless.
+
+struct BroadPhasePair {
+  unsigned int a;  // id of the body inserted first
+  unsigned int b;
+};
+
+class BroadPhase {
+ public:
+  virtual ~BroadPhase() {}
+
+  // Forget all bodies, keeps the allocations for the next frame
+  virtual void clear();
+
+  // Add a body centered at position covering position +- half_extents.
+  // Two bodies are only paired when the mask of each has a bit of the other's
+  // category (see CollisionFilter), bodies that can never pair are dropped.
+  virtual void insert(unsigned int id, glm::vec2 position,
+                      glm::vec2 half_extents, unsigned int category = ~0u,
+                      unsigned int mask = ~0u);
+
+  // Overlapping pairs of the bodies inserted since the last clear
+  virtual void find_pairs(std::vector<BroadPhasePair> &out_pairs) = 0;
+
+  // Runs narrow_phase on every pair reported by find_pairs
+  void for_each_pair(
+      const std::function<void(unsigned int, unsigned int)> &narrow_phase);
+
+  size_t size() const { return bodies.size(); }
+
+  // Runs the pair search on jobs, nullptr keeps it on the calling thread
+  void set_job_system(JobSystem *jobs) { this->jobs = jobs; }
+
+  // Below this the jobs cost more than they save
+  static const size_t MIN_PARALLEL_BODIES = 2048;
+
+ protected:
+  struct Body {
+    unsigned int id;
+    glm::vec2 min;
+    glm::vec2 max;
+    unsigned int category;
+    unsigned int mask;
+  };
+  std::vector<Body> bodies;
+  std::vector<BroadPhasePair> pairs;
+  JobSystem *jobs = nullptr;
+  std::vector<std::vector<BroadPhasePair>> chunk_pairs;
+
+  // Calls find(begin, end, pairs) on chunks of grain items of [0, count),
+  // as jobs when there are enough bodies, and appends the pairs of every
+  // chunk to out_pairs in the order of the chunks
+  void find_in_chunks(
+      size_t count, size_t grain,
+      const std::function<void(size_t, size_t, std::vector<BroadPhasePair> &)>
+          &find,
+      std::vector<BroadPhasePair> &out_pairs);
+
+  // Layers first, they are cheaper than the boxes
+  static bool overlaps(const Body &a, const Body &b) {
+    return (a.mask & b.category) && (b.mask & a.category) &&
+           a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y &&
+           b.min.y <= a.max.y;
+  }
+};
+
+// Uniform grid hashed on the cell coordinates, rebuilt every frame.
+//
+// Bodies are bucketed into every cell their box touches. A pair sharing
+// several cells is only reported by the cell holding the top left corner of
+// the intersection of the two boxes, so no pair set is needed to deduplicate.
+// Bodies covering more than MAX_CELLS_PER_BODY cells (backgrounds) are kept
+// aside and tested against everything instead.
+class SpatialHash : public BroadPhase {
+ public:
+  // cell_size should be about the diameter of the typical body
+  explicit SpatialHash(float cell_size = 64.f);
+
+  void find_pairs(std::vector<BroadPhasePair> &out_pairs) override;
+
+  static const int MAX_CELLS_PER_BODY = 64;
+
+ private:
+  struct CellEntry {
+    uint64_t cell;
+    unsigned int body;  // index in bodies
+  };
+
+  float cell_size;
+  float inv_cell_size;
+  std::vector<CellEntry> entries;
+  std::vector<size_t> cell_begin;  // first entry of every cell, then the end
+  std::vector<unsigned int> large_bodies;
+  std::vector<bool> is_large;
+
+  glm::ivec2 cell_of(glm::vec2 point) const;
+  static uint64_t cell_key(glm::ivec2 cell);
+};
+
+// Sort and sweep along one axis.
+//
+// The bodies stay sorted by the start of their box on the axis from one frame
+// to the next and the order is repaired with an insertion sort, close to
+// linear when bodies move a little per frame. This relies on bodies keeping
+// their insertion index between frames, as ComponentContainer indices do.
+// Works best when the bodies are spread along the axis (rocks drifting across
+// the Mac scene) and degrades when many of them share the same stretch.
+class SweepAndPrune : public BroadPhase {
+ public:
+  // axis 0 sweeps along x, 1 along y
+  explicit SweepAndPrune(int axis = 0);
+
+  void find_pairs(std::vector<BroadPhasePair> &out_pairs) override;
+
+ private:
+  int axis;
+  std::vector<unsigned int> order;  // indices in bodies, sorted along axis
+};
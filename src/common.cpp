@@ -19,35 +19,102 @@ void Transform::translate(vec2 offset) {
   mat = mat * T;
 }
 
+double simulation_time_ms = 0;
+
+GLErrorState gl_error_state;
+
+static void APIENTRY gl_debug_callback(GLenum source, GLenum type, GLuint id,
+                                       GLenum severity, GLsizei length,
+                                       const GLchar *message,
+                                       const void *user_param) {
+  (void)source;
+  (void)id;
+  (void)length;
+  (void)user_param;
+
+  // notifications (buffer placement hints etc.) are just noise
+  if (severity == GL_DEBUG_SEVERITY_NOTIFICATION) return;
+
+  if (type == GL_DEBUG_TYPE_ERROR) {
+    gl_error_state.frame_errors++;
+    fprintf(stderr, "OpenGL: %s\n", message);
+    assert(false);
+  } else if (severity == GL_DEBUG_SEVERITY_HIGH) {
+    fprintf(stderr, "OpenGL warning: %s\n", message);
+  }
+}
+
+bool gl_init_debug_output() {
+  // every scene initializes its own renderer on the same context
+  if (gl_error_state.debug_output) return true;
+
+  GLint context_flags = 0;
+  glGetIntegerv(GL_CONTEXT_FLAGS, &context_flags);
+  if (!(context_flags & GL_CONTEXT_FLAG_DEBUG_BIT) ||
+      !glfwExtensionSupported("GL_KHR_debug") ||
+      glDebugMessageCallback == nullptr) {
+    printf("KHR_debug not available, falling back to glGetError\n");
+    return false;
+  }
+
+  glDebugMessageCallback((GLDEBUGPROC)gl_debug_callback, nullptr);
+#ifndef NDEBUG
+  // report errors from within the faulting call, so the assert has a useful
+  // stack trace. Release builds keep the faster asynchronous reporting
+  glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+#endif
+  if (gl_error_state.enabled) glEnable(GL_DEBUG_OUTPUT);
+  gl_error_state.debug_output = true;
+  return true;
+}
+
+void gl_set_error_checking(bool enabled) {
+  gl_error_state.enabled = enabled;
+  if (gl_error_state.debug_output) {
+    if (enabled)
+      glEnable(GL_DEBUG_OUTPUT);
+    else
+      glDisable(GL_DEBUG_OUTPUT);
+  }
+  printf("OpenGL error checking %s\n", enabled ? "enabled" : "disabled");
+}
+
+unsigned int gl_end_frame_errors() {
+  return gl_error_state.frame_errors.exchange(0);
+}
+
+#ifndef NDEBUG
+static const char *gl_error_string(GLenum error) {
+  switch (error) {
+    case GL_INVALID_OPERATION:
+      return "INVALID_OPERATION";
+    case GL_INVALID_ENUM:
+      return "INVALID_ENUM";
+    case GL_INVALID_VALUE:
+      return "INVALID_VALUE";
+    case GL_OUT_OF_MEMORY:
+      return "OUT_OF_MEMORY";
+    case GL_INVALID_FRAMEBUFFER_OPERATION:
+      return "INVALID_FRAMEBUFFER_OPERATION";
+  }
+  return "";
+}
+
 bool gl_has_errors() {
+  // the debug callback already reports errors without stalling
+  if (!gl_error_state.enabled || gl_error_state.debug_output) return false;
+
   GLenum error = glGetError();
 
   if (error == GL_NO_ERROR) return false;
 
   while (error != GL_NO_ERROR) {
-    const char *error_str = "";
-    switch (error) {
-      case GL_INVALID_OPERATION:
-        error_str = "INVALID_OPERATION";
-        break;
-      case GL_INVALID_ENUM:
-        error_str = "INVALID_ENUM";
-        break;
-      case GL_INVALID_VALUE:
-        error_str = "INVALID_VALUE";
-        break;
-      case GL_OUT_OF_MEMORY:
-        error_str = "OUT_OF_MEMORY";
-        break;
-      case GL_INVALID_FRAMEBUFFER_OPERATION:
-        error_str = "INVALID_FRAMEBUFFER_OPERATION";
-        break;
-    }
-
-    fprintf(stderr, "OpenGL: %s\n", error_str);
+    gl_error_state.frame_errors++;
+    fprintf(stderr, "OpenGL: %s\n", gl_error_string(error));
     error = glGetError();
     assert(false);
   }
 
   return true;
-}
\ No newline at end of file
+}
+#endif
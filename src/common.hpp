@@ -1,6 +1,7 @@
 #pragma once
 
 // stlib
+#include <atomic>
 #include <fstream>  // stdout, stderr..
 #include <string>
 #include <vector>
@@ -53,6 +54,22 @@ inline std::string font_path(const std::string &name) {
 #define M_PI 3.14159265358979323846f
 #endif
 
+// The scenes are simulated in fixed steps of SIMULATION_STEP_MS whatever the
+// frame rate, see main. A frame runs at most MAX_SIMULATION_STEPS_PER_FRAME
+// steps so a long stall (window drag, breakpoint) slows the game down instead
+// of spiraling into ever longer frames.
+const float SIMULATION_STEP_MS = 1000.f / 120.f;
+const int MAX_SIMULATION_STEPS_PER_FRAME = 8;
+
+// Milliseconds simulated since the start of the run, advanced by SceneManager
+// every step on the simulation thread. Shader animations use the time of the
+// snapshot they draw (see RenderSystem::publish) instead of glfwGetTime so a
+// replay draws the same frames.
+extern double simulation_time_ms;
+
+// Story and tutorial text is typed one character per 60 Hz tick
+const float TYPIST_MS_PER_CHARACTER = 1000.f / 60.f;
+
 // The 'Transform' component handles transformations passed to the Vertex shader
 // (similar to the gl Immediate mode equivalent, e.g., glTranslate()...)
 // We recomment making all components non-copyable by derving from
@@ -66,4 +83,31 @@ struct Transform {
   void translate(vec2 offset);
 };
 
+// OpenGL error checking. If the context is a debug context with KHR_debug, the
+// driver reports errors through a callback (see gl_init_debug_output) and the
+// per call checks below do nothing. Otherwise gl_has_errors() polls glGetError,
+// which forces the driver to synchronize, so it is compiled out of release
+// (NDEBUG) builds.
+struct GLErrorState {
+  bool enabled = true;          // runtime toggle for all error checking
+  bool debug_output = false;    // errors are reported by the KHR_debug callback
+  // errors reported since the last frame end, the asynchronous debug output
+  // of release builds may report them from a thread of the driver
+  std::atomic<unsigned int> frame_errors{0};
+};
+extern GLErrorState gl_error_state;
+
+// installs the KHR_debug callback if the current context supports it
+bool gl_init_debug_output();
+
+// toggles error checking at runtime, including the KHR_debug callback
+void gl_set_error_checking(bool enabled);
+
+// returns the number of errors of the finished frame and resets the counter
+unsigned int gl_end_frame_errors();
+
+#ifdef NDEBUG
+inline bool gl_has_errors() { return false; }
+#else
 bool gl_has_errors();
+#endif
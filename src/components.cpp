@@ -4,6 +4,7 @@
 #include "../ext/stb_image/stb_image.h"
 
 // stlib
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -113,3 +114,67 @@ bool Mesh::loadFromOBJFile(std::string obj_path,
 
   return true;
 }
+
+// Andrew's monotone chain on the vertex positions
+void Mesh::compute_bounds(bool with_hull) {
+  hull.clear();
+  if (vertices.empty()) return;
+
+  local_min = {vertices[0].position.x, vertices[0].position.y};
+  local_max = local_min;
+  bounding_radius = 0.f;
+  std::vector<vec2> points;
+  for (const ColoredVertex &vertex : vertices) {
+    vec2 p = vertex.position;
+    local_min = min(local_min, p);
+    local_max = max(local_max, p);
+    bounding_radius = max(bounding_radius, length(p));
+    points.push_back(p);
+  }
+  if (!with_hull || points.size() < 3) return;
+
+  std::sort(points.begin(), points.end(), [](vec2 a, vec2 b) {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+  });
+  auto cross = [](vec2 o, vec2 a, vec2 b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+  };
+  hull.resize(2 * points.size());
+  size_t k = 0;
+  for (size_t i = 0; i < points.size(); i++) {  // lower hull
+    while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) k--;
+    hull[k++] = points[i];
+  }
+  for (size_t i = points.size() - 1, t = k + 1; i > 0; i--) {  // upper hull
+    while (k >= t && cross(hull[k - 2], hull[k - 1], points[i - 1]) <= 0) k--;
+    hull[k++] = points[i - 1];
+  }
+  hull.resize(k - 1);  // the last point is the first one again
+}
+
+void Mesh::world_extents(const TransformComponent &transform, vec2 &out_min,
+                         vec2 &out_max) const {
+  // same order as the renderer: scale, then rotate, then translate
+  float c = cos(transform.rotation);
+  float s = sin(transform.rotation);
+  if (!hull.empty()) {
+    out_min = vec2(INFINITY);
+    out_max = vec2(-INFINITY);
+    for (vec2 p : hull) {
+      p *= transform.scale;
+      vec2 world = transform.position + vec2(c * p.x - s * p.y,
+                                             s * p.x + c * p.y);
+      out_min = min(out_min, world);
+      out_max = max(out_max, world);
+    }
+    return;
+  }
+  vec2 center = (local_min + local_max) * 0.5f * transform.scale;
+  vec2 half = abs((local_max - local_min) * 0.5f * transform.scale);
+  center = transform.position + vec2(c * center.x - s * center.y,
+                                     s * center.x + c * center.y);
+  vec2 extent = {abs(c) * half.x + abs(s) * half.y,
+                 abs(s) * half.x + abs(c) * half.y};
+  out_min = center - extent;
+  out_max = center + extent;
+}
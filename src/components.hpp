@@ -4,6 +4,7 @@
 
 #include "../ext/stb_image/stb_image.h"
 #include "common.hpp"
+#include "particle_pool.hpp"
 
 enum class ITEMS {
   NONE,
@@ -46,6 +47,12 @@ struct TransformComponent {
   vec2 position = {0, 0};
   float rotation = 0;
   vec2 scale = {10, 10};
+
+  // Pose at the start of the current simulation step, the renderer blends
+  // from it to position/rotation (see ECSRegistry::snapshot_transforms)
+  vec2 previous_position = {0, 0};
+  float previous_rotation = 0;
+  bool has_previous = false;  // false until the first step, nothing to blend
 };
 
 struct Velocity {
@@ -75,15 +82,58 @@ struct UIPass {
   bool display = 1;
 };
 
+struct StaticLayer {
+  // Flag such that the entity is drawn into the cached static layer instead of
+  // every frame. The layer is only re-rendered when the camera or one of the
+  // static entities changes, so only use it for backgrounds and board pieces
+};
+
 // Stucture to store collision information
 struct Collision {
   // Note, the first object is stored in the ECS container.entities
   Entity other;  // the second object involved in the collision
   Collision(Entity &other) { this->other = other; };
 };
-// Flag to check for collision (instead of checking all entities with a
-// Transform component)
-struct Collider {};
+// Collision categories, one bit each, for CollisionFilter
+const unsigned int COLLISION_PLAYER = 1 << 0;
+const unsigned int COLLISION_OBSTACLE = 1 << 1;  // rocks, planets, hard shells
+const unsigned int COLLISION_PICKUP = 1 << 2;    // soft shells, targets
+const unsigned int COLLISION_SPACE = 1 << 3;     // board spaces
+
+// Only entities with a filter enter the broad phase (instead of checking all
+// entities with a Transform component). Two of them are tested when each one's
+// mask contains the category of the other, so backgrounds, debug lines and
+// birds never take part in pair generation.
+struct CollisionFilter {
+  unsigned int category = 0;
+  unsigned int mask = 0;
+
+  bool accepts(const CollisionFilter &other) const {
+    return (mask & other.category) && (other.mask & category);
+  }
+};
+
+// Bodies that can cross a whole obstacle in one step (launched or jumping
+// players). The physics systems sweep them from where they were instead of
+// only testing where they end up (see swept_collision.hpp), and split their
+// step when they follow a curved path.
+struct FastBody {
+  int max_substeps = 8;
+};
+
+// Bodies with a Velocity that stayed slower than SLEEP_SPEED for SLEEP_STEPS
+// physics steps (see body_sleep.hpp). The physics systems do not integrate
+// them nor test them against each other. Their velocity is zeroed when they
+// fall asleep so the game code wakes them by writing it, contacts wake them
+// too.
+struct Sleeping {
+  // Note, an empty struct has size 1
+};
+
+// Physics steps a moving body has been slower than SLEEP_SPEED
+struct Stillness {
+  int steps = 0;
+};
 
 enum class SPACE_TYPE {
   SPACE_BLUE,
@@ -169,6 +219,28 @@ struct Mesh {
   vec2 original_size = {1, 1};
   std::vector<ColoredVertex> vertices;
   std::vector<uint16_t> vertex_indices;
+
+  // Bounds in the local space the vertices are normalized to (-0.5 ... 0.5),
+  // computed once at load by compute_bounds. Meshes that are not loaded from
+  // a file (sprites) keep the unit square.
+  vec2 local_min = {-0.5f, -0.5f};
+  vec2 local_max = {0.5f, 0.5f};
+  float bounding_radius = 0.70710678f;  // around the local origin
+  std::vector<vec2> hull;  // convex hull, counter clockwise, may be empty
+
+  void compute_bounds(bool with_hull);
+
+  // Radius of a circle around the mesh drawn with transform, centered on the
+  // position. O(1), for early outs.
+  float world_radius(const TransformComponent &transform) const {
+    return bounding_radius *
+           max(abs(transform.scale.x), abs(transform.scale.y));
+  }
+
+  // Axis aligned box around the mesh drawn with transform. Exact when the
+  // mesh has a hull, otherwise the box around the rotated local box.
+  void world_extents(const TransformComponent &transform, vec2 &out_min,
+                     vec2 &out_max) const;
 };
 
 /**
@@ -260,6 +332,7 @@ enum class EFFECT_ASSET_ID {
   TEXT,
   TEXTURED_PARTICLE,
   CLOUD,
+  STATIC_LAYER,
   EFFECT_COUNT
 };
 const int effect_count = (int)EFFECT_ASSET_ID::EFFECT_COUNT;
@@ -282,41 +355,12 @@ struct RenderRequest {
   GEOMETRY_BUFFER_ID used_geometry = GEOMETRY_BUFFER_ID::GEOMETRY_COUNT;
 };
 
+// A spray of particles, emitted at the position of the entity
 struct ParticleSystem {
-  float particleSystemLifetime = 2000;  // how long the particle system lives
-                                        // for before deleting itself in ms
-  float spawningRate = 0.1f;  // how often a particle spawns in seconds
-  float spawningAngle =
-      90.0f;          // angle to spawn particles in (degrees, 0 is axis {1,0})
-  int coneAngle = 0;  // makes it spawn around a cone of angle coneAngle from
-                      // the axis specified by spawningAngle
-  float initialSpeed = 500.0f;
-  float speedRandomness =
-      0.25f;  // float from 0 - 1 where 0 is no ramdomness and where 1 can spawn
-              // with speed between 0 and initialSpeed
-
-  float initialLifetime = 5000.0f;  // in milliseconds how long an individual
-                                    // particle lives for before killing itself
-  float lifetimeRandomness = 0.25f;
-
-  float particleSize = 50.0f;            // size of particle sprites
-  float particleSizeRandomness = 0.25f;  // randomness to size
-
-  vec2 particleAcceleration = {0, 1000};
-
+  ParticleEmitter emitter;
   TEXTURE_ASSET_ID texture = TEXTURE_ASSET_ID::COIN;  // texture to use
-
-  float life = 0.0f;  // current life of system, not a parameter will only die
-                      // after it reaches lifetime and all particles are dead
-  float particleSpawnTimeout = 0.0f;
-  int num_alive = 0;
-
-  // particles the system has emmited
-  std::vector<bool> particles_alive;
-  std::vector<vec2> particles_position;
-  std::vector<vec2> particles_velocity;
-  std::vector<float> particles_size;
-  std::vector<float> particles_life;
+  // particles the system has emitted
+  ParticlePool particles;
 };
 
 /**
@@ -0,0 +1,31 @@
+#include "input_queue.hpp"
+
+bool InputQueue::push_key(int key, int action, int mods) {
+  return push({InputEventType::KEY, key, action, mods, {0, 0},
+               std::chrono::steady_clock::now()});
+}
+
+bool InputQueue::push_mouse_move(glm::vec2 position) {
+  return push({InputEventType::MOUSE_MOVE, 0, 0, 0, position,
+               std::chrono::steady_clock::now()});
+}
+
+bool InputQueue::push(const WindowInputEvent &event) {
+  size_t t = tail.load(std::memory_order_relaxed);
+  // the consumer is done with a slot once it moved head past it
+  if (t - head.load(std::memory_order_acquire) == CAPACITY) {
+    dropped++;
+    return false;
+  }
+  events[t % CAPACITY] = event;
+  tail.store(t + 1, std::memory_order_release);
+  return true;
+}
+
+bool InputQueue::pop(WindowInputEvent &event) {
+  size_t h = head.load(std::memory_order_relaxed);
+  if (h == tail.load(std::memory_order_acquire)) return false;
+  event = events[h % CAPACITY];
+  head.store(h + 1, std::memory_order_release);
+  return true;
+}
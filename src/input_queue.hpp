@@ -0,0 +1,51 @@
+#pragma once
+
+// stlib
+#include <array>
+#include <atomic>
+#include <chrono>
+
+// internal
+#include "input_recorder.hpp"
+
+// Input of the window on its way from the GLFW callbacks, on the main thread,
+// to the scenes, on the simulation thread.
+//
+// A ring of events with one producer and one consumer: the callbacks push()
+// and the simulation pop()s them at the start of each step. Neither side
+// takes a lock, each only writes its own end of the ring. When the simulation
+// falls so far behind that the ring fills up, new events are dropped and
+// counted.
+struct WindowInputEvent {
+  InputEventType type;  // KEY or MOUSE_MOVE
+  int key;
+  int action;
+  int mods;
+  glm::vec2 position;
+  std::chrono::steady_clock::time_point time;  // when GLFW reported it
+};
+
+class InputQueue {
+ public:
+  static const size_t CAPACITY = 1024;  // a power of two
+
+  // Producer side, false when the ring is full and the event was dropped
+  bool push_key(int key, int action, int mods);
+  bool push_mouse_move(glm::vec2 position);
+
+  // Consumer side, false when the ring is empty
+  bool pop(WindowInputEvent &event);
+
+  // Events dropped since the last call
+  unsigned int take_dropped() { return dropped.exchange(0); }
+
+ private:
+  std::array<WindowInputEvent, CAPACITY> events;
+  // counted up forever, the slot is the count modulo CAPACITY. The two ends
+  // sit on their own cache lines so the threads do not share one.
+  alignas(64) std::atomic<size_t> head{0};  // next to pop, consumer
+  alignas(64) std::atomic<size_t> tail{0};  // next to push, producer
+  std::atomic<unsigned int> dropped{0};
+
+  bool push(const WindowInputEvent &event);
+};
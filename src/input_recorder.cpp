@@ -0,0 +1,129 @@
+#include "input_recorder.hpp"
+
+// stlib
+#include <assert.h>
+#include <string.h>
+
+namespace {
+
+const char MAGIC[4] = {'P', 'T', 'I', 'N'};
+const uint32_t VERSION = 1;
+
+template <typename T>
+void write(FILE *file, T value) {
+  fwrite(&value, sizeof(T), 1, file);
+}
+
+template <typename T>
+bool read(FILE *file, T &value) {
+  return fread(&value, sizeof(T), 1, file) == 1;
+}
+
+}  // namespace
+
+InputRecorder::~InputRecorder() {
+  if (file) fclose(file);
+}
+
+bool InputRecorder::start(const std::string &path, uint32_t seed) {
+  assert(!file);
+  file = fopen(path.c_str(), "wb");
+  if (!file) {
+    fprintf(stderr, "Failed to open %s to record the input\n", path.c_str());
+    return false;
+  }
+  fwrite(MAGIC, 1, sizeof(MAGIC), file);
+  write(file, VERSION);
+  write(file, seed);
+  printf("Recording the input to %s, seed %u\n", path.c_str(), seed);
+  return true;
+}
+
+void InputRecorder::key(uint32_t step, int key, int action, int mods) {
+  if (!file) return;
+  write(file, step);
+  write(file, InputEventType::KEY);
+  write(file, (int16_t)key);
+  write(file, (uint8_t)action);
+  write(file, (uint8_t)mods);
+}
+
+void InputRecorder::mouse_move(uint32_t step, glm::vec2 position) {
+  if (!file) return;
+  write(file, step);
+  write(file, InputEventType::MOUSE_MOVE);
+  write(file, position.x);
+  write(file, position.y);
+}
+
+void InputRecorder::finish(uint32_t step) {
+  if (!file) return;
+  write(file, step);
+  write(file, InputEventType::END);
+  fclose(file);
+  file = nullptr;
+}
+
+bool InputReplay::load(const std::string &path) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file) {
+    fprintf(stderr, "Failed to open the input recording %s\n", path.c_str());
+    return false;
+  }
+  char magic[4];
+  uint32_t version = 0;
+  if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+      memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !read(file, version) ||
+      version != VERSION || !read(file, run_seed)) {
+    fprintf(stderr, "%s is not an input recording\n", path.c_str());
+    fclose(file);
+    return false;
+  }
+
+  events.clear();
+  next_event = 0;
+  end_step = 0;
+  bool ended = false;
+  InputEvent event = {};
+  while (!ended && read(file, event.step) && read(file, event.type)) {
+    bool complete = true;
+    if (event.type == InputEventType::KEY) {
+      int16_t key;
+      uint8_t action, mods;
+      complete = read(file, key) && read(file, action) && read(file, mods);
+      event.key = key;
+      event.action = action;
+      event.mods = mods;
+    } else if (event.type == InputEventType::MOUSE_MOVE) {
+      complete = read(file, event.position.x) && read(file, event.position.y);
+    } else if (event.type == InputEventType::END) {
+      ended = true;
+    } else {
+      complete = false;
+    }
+    if (!complete) break;
+    end_step = event.step;
+    if (!ended) events.push_back(event);
+  }
+  fclose(file);
+
+  // a crashed recording has no END, it is replayed up to its last event
+  if (!ended)
+    fprintf(stderr, "%s was cut short, replaying %u steps\n", path.c_str(),
+            end_step);
+  printf("Replaying %zu input events over %u steps, seed %u\n", events.size(),
+         end_step, run_seed);
+  return true;
+}
+
+void InputReplay::play(uint32_t step,
+                       const std::function<void(int, int, int)> &on_key,
+                       const std::function<void(glm::vec2)> &on_mouse_move) {
+  while (next_event < events.size() && events[next_event].step <= step) {
+    const InputEvent &event = events[next_event++];
+    if (event.type == InputEventType::KEY)
+      on_key(event.key, event.action, event.mods);
+    else
+      on_mouse_move(event.position);
+  }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+// stlib
+#include <stdint.h>
+#include <stdio.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// The glm library provides vector and matrix operations as in GLSL
+#include <glm/vec2.hpp>  // vec2
+
+// Recording and replay of the player input of a deterministic run.
+//
+// Every key and mouse move event is stored with the number of the simulation
+// step it arrived before, together with the run seed (see RandomService).
+// Stepping the same scenes with the same seed and feeding the events back at
+// the same steps plays the same match again, whatever the frame rate.
+//
+// File layout, little endian:
+//   header  "PTIN", uint32 version, uint32 seed
+//   events  uint32 step, uint8 type, then for
+//             KEY         int16 key, uint8 action, uint8 mods
+//             MOUSE_MOVE  float x, float y
+//             END         nothing, step is the length of the recording
+
+enum class InputEventType : uint8_t { KEY = 0, MOUSE_MOVE = 1, END = 2 };
+
+struct InputEvent {
+  uint32_t step;
+  InputEventType type;
+  int key;
+  int action;
+  int mods;
+  glm::vec2 position;
+};
+
+class InputRecorder {
+ public:
+  ~InputRecorder();
+
+  bool start(const std::string &path, uint32_t seed);
+  bool is_recording() const { return file != nullptr; }
+
+  void key(uint32_t step, int key, int action, int mods);
+  void mouse_move(uint32_t step, glm::vec2 position);
+
+  // Writes the END event and closes the file
+  void finish(uint32_t step);
+
+ private:
+  FILE *file = nullptr;
+};
+
+class InputReplay {
+ public:
+  bool load(const std::string &path);
+
+  uint32_t seed() const { return run_seed; }
+  // Number of steps recorded
+  uint32_t length() const { return end_step; }
+  bool finished(uint32_t step) const { return step >= end_step; }
+
+  // Calls the callbacks with the events recorded before step, in order
+  void play(uint32_t step,
+            const std::function<void(int, int, int)> &on_key,
+            const std::function<void(glm::vec2)> &on_mouse_move);
+
+ private:
+  std::vector<InputEvent> events;
+  size_t next_event = 0;
+  uint32_t run_seed = 0;
+  uint32_t end_step = 0;
+};
@@ -0,0 +1,156 @@
+#include "job_system.hpp"
+
+// stlib
+#include <algorithm>
+
+JobSystem job_system;
+
+struct JobSystem::Job {
+  std::function<void()> task;
+  // unfinished dependencies, plus one until submit() is done with the job
+  std::atomic<int> waiting{1};
+  std::atomic<bool> done{false};
+  std::mutex mutex;
+  std::vector<JobHandle> dependents;  // queued once this one is done
+};
+
+namespace {
+
+// Queue of the current thread, -1 on threads outside the system. Thread 0 is
+// the one that called start().
+thread_local int thread_index = -1;
+
+}  // namespace
+
+JobSystem::~JobSystem() { stop(); }
+
+void JobSystem::start(unsigned int threads) {
+  stop();
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  stopping = false;
+  queues.clear();
+  for (unsigned int i = 0; i < threads; i++)
+    queues.emplace_back(new Queue());
+  thread_index = 0;
+  for (unsigned int i = 1; i < threads; i++)
+    workers.emplace_back(&JobSystem::work, this, i);
+}
+
+void JobSystem::stop() {
+  wait_frame();
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (std::thread& worker : workers) worker.join();
+  workers.clear();
+}
+
+void JobSystem::work(unsigned int index) {
+  thread_index = (int)index;
+  while (true) {
+    if (run_one()) continue;
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    wake.wait(lock, [&] { return stopping || queued > 0; });
+    if (stopping && queued == 0) return;
+  }
+}
+
+JobSystem::JobHandle JobSystem::submit(
+    std::function<void()> task, const std::vector<JobHandle>& dependencies) {
+  JobHandle job = std::make_shared<Job>();
+  job->task = std::move(task);
+  pending++;
+  for (const JobHandle& dependency : dependencies) {
+    std::lock_guard<std::mutex> lock(dependency->mutex);
+    if (dependency->done) continue;
+    job->waiting++;
+    dependency->dependents.push_back(job);
+  }
+  if (--job->waiting == 0) push(job);
+  return job;
+}
+
+void JobSystem::push(const JobHandle& job) {
+  if (queues.empty()) queues.emplace_back(new Queue());
+  // threads outside the system hand their jobs to thread 0
+  Queue& queue = *queues[std::max(thread_index, 0) % queues.size()];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.jobs.push_back(job);
+  }
+  queued++;
+  // taking the lock orders this with a worker about to sleep
+  { std::lock_guard<std::mutex> lock(sleep_mutex); }
+  wake.notify_one();
+}
+
+bool JobSystem::run_one() {
+  if (queued == 0 || queues.empty()) return false;
+  size_t own = std::max(thread_index, 0) % queues.size();
+  JobHandle job;
+  // newest of our own first, it is likely still in the cache, then the
+  // oldest of the others
+  for (size_t i = 0; i < queues.size() && !job; i++) {
+    Queue& queue = *queues[(own + i) % queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) continue;
+    if (i == 0) {
+      job = std::move(queue.jobs.back());
+      queue.jobs.pop_back();
+    } else {
+      job = std::move(queue.jobs.front());
+      queue.jobs.pop_front();
+    }
+  }
+  if (!job) return false;
+  queued--;
+  job->task();
+  finish(job);
+  return true;
+}
+
+void JobSystem::finish(const JobHandle& job) {
+  std::vector<JobHandle> dependents;
+  {
+    std::lock_guard<std::mutex> lock(job->mutex);
+    job->done = true;
+    dependents.swap(job->dependents);
+  }
+  for (const JobHandle& dependent : dependents)
+    if (--dependent->waiting == 0) push(dependent);
+  pending--;
+}
+
+void JobSystem::wait(const JobHandle& job) {
+  while (!job->done)
+    if (!run_one()) std::this_thread::yield();
+}
+
+void JobSystem::wait_frame() {
+  while (pending > 0)
+    if (!run_one()) std::this_thread::yield();
+}
+
+void JobSystem::parallel_for(
+    size_t count, size_t grain,
+    const std::function<void(size_t, size_t)>& body) {
+  grain = std::max<size_t>(grain, 1);
+  if (workers.empty() || count <= grain) {
+    if (count > 0) body(0, count);
+    return;
+  }
+  // the chunks are pushed on our deque, the others steal them from the front
+  // while we pop from the back
+  std::atomic<size_t> left{(count + grain - 1) / grain};
+  for (size_t begin = 0; begin < count; begin += grain) {
+    size_t end = std::min(count, begin + grain);
+    submit([&body, &left, begin, end] {
+      body(begin, end);
+      left--;
+    });
+  }
+  while (left > 0)
+    if (!run_one()) std::this_thread::yield();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+// stlib
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work stealing job system shared by all scenes.
+//
+// Every thread of the system has its own deque of jobs. A thread pushes and
+// pops the jobs it submits at the back of its deque, and when it runs out it
+// steals from the front of the others', so the jobs split from one loop end
+// up spread over the idle threads. The thread that called start() is thread
+// 0 and only runs jobs while it waits: in wait(), wait_frame() and
+// parallel_for().
+//
+// A job can depend on other jobs and only starts once they finished. Jobs
+// must not depend on which thread runs them, each writes its own part of the
+// output, so the result of a step is the same on any number of threads.
+//
+// Until start() is called, and with one thread, every job runs on the calling
+// thread when it is waited for.
+class JobSystem {
+ public:
+  struct Job;
+  using JobHandle = std::shared_ptr<Job>;
+
+  ~JobSystem();
+
+  // Starts threads - 1 workers next to the calling thread, 0 starts one
+  // thread per core
+  void start(unsigned int threads);
+  // Runs the jobs left and joins the workers
+  void stop();
+
+  unsigned int thread_count() const {
+    return (unsigned int)workers.size() + 1;
+  }
+
+  // Queues task, it runs once every job in dependencies finished
+  JobHandle submit(std::function<void()> task,
+                   const std::vector<JobHandle>& dependencies = {});
+
+  // Runs queued jobs until job finished
+  void wait(const JobHandle& job);
+
+  // Runs queued jobs until every job submitted so far finished, the scene
+  // manager calls it after each step so no job outlives the step it was
+  // submitted in
+  void wait_frame();
+
+  // Calls body(begin, end) for chunks of at most grain indices covering
+  // [0, count) and returns once all of them are done. The calling thread
+  // runs chunks too.
+  void parallel_for(size_t count, size_t grain,
+                    const std::function<void(size_t, size_t)>& body);
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<JobHandle> jobs;
+  };
+
+  std::vector<std::thread> workers;
+  std::vector<std::unique_ptr<Queue>> queues;  // one per thread
+
+  std::atomic<int> queued{0};   // in the queues
+  std::atomic<int> pending{0};  // submitted and not finished
+
+  // idle workers sleep until a job is queued
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+  bool stopping = false;
+
+  void work(unsigned int index);
+  void push(const JobHandle& job);
+  bool run_one();
+  void finish(const JobHandle& job);
+};
+
+extern JobSystem job_system;
@@ -3,11 +3,23 @@
 #include <gl3w.h>
 
 // stlib
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <memory>
+#include <random>
+#include <string>
 #include <thread>
 
 // internal
+#include "audio_bank.hpp"
+#include "body_sleep.hpp"
+#include "input_recorder.hpp"
+#include "job_system.hpp"
+#include "random_service.hpp"
 #include "scene_manager.hpp"
 #include "window_manager.hpp"
 
@@ -17,16 +29,77 @@ using Clock = std::chrono::high_resolution_clock;
 const int window_height_px = 1200;
 const int window_width_px = 675;
 
+// Replays the recorded input as fast as the scenes step, without drawing
+int run_replay(SceneManager &scene_manager) {
+  auto start = Clock::now();
+  while (!scene_manager.replay_finished() && !scene_manager.is_quit_game() &&
+         scene_manager.rounds_left > 0) {
+    // keeps the hidden window responsive, its input is ignored
+    if (scene_manager.steps_simulated() % 120 == 0) glfwPollEvents();
+    scene_manager.step_current_scene(SIMULATION_STEP_MS);
+  }
+  float ms = (float)(std::chrono::duration_cast<std::chrono::microseconds>(
+                         Clock::now() - start))
+                 .count() /
+             1000;
+  uint32_t steps = scene_manager.steps_simulated();
+  printf("Replay: %u steps in %.1f ms, %.4f ms per step\n", steps, ms,
+         steps > 0 ? ms / steps : 0.f);
+  scene_manager.finish_run();
+  return EXIT_SUCCESS;
+}
+
 // Entry point
-int main() {
+//   --seed N       deterministic run, every scene rng derives from N
+//   --record FILE  records the input to FILE, with a random seed unless --seed
+//   --replay FILE  replays FILE headless and prints the timings and end state
+//   --workers N    threads of the job system, one per core when 0 or missing
+int main(int argc, char *argv[]) {
+  bool deterministic = false;
+  uint32_t seed = 0;
+  std::string record_path;
+  std::string replay_path;
+  unsigned int workers = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      deterministic = true;
+      seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+      record_path = argv[++i];
+    } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      replay_path = argv[++i];
+    } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+      workers = (unsigned int)strtoul(argv[++i], nullptr, 10);
+    } else {
+      fprintf(stderr, "Unknown argument %s\n", argv[i]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The scenes take their rng when they are created, so the seed comes first
+  InputReplay replay;
+  if (!replay_path.empty()) {
+    if (!replay.load(replay_path)) return EXIT_FAILURE;
+    deterministic = true;
+    seed = replay.seed();
+  } else if (!record_path.empty() && !deterministic) {
+    deterministic = true;
+    seed = std::random_device()();
+  }
+  if (deterministic) random_service.seed(seed);
+
+  // The results do not depend on the thread count, replays included
+  job_system.start(workers);
+  printf("Job system: %u threads\n", job_system.thread_count());
+
   // Global systems
 
   std::shared_ptr<WindowManager> window_manager =
       std::make_shared<WindowManager>();
 
   // Initializing window
-  auto window =
-      window_manager->create_window(window_width_px, window_height_px);
+  auto window = window_manager->create_window(
+      window_width_px, window_height_px, replay_path.empty());
 
   if (!window) {
     // Time to read the error message
@@ -35,44 +108,105 @@ int main() {
     return EXIT_FAILURE;
   }
 
+  // The sounds the scenes ask for are decoded while they load their textures
+  if (!audio_bank.open(!replay_path.empty())) {
+    printf("Press any key to exit");
+    getchar();
+    return EXIT_FAILURE;
+  }
+
   // initialize board scene
+  auto load_start = Clock::now();
   SceneManager scene_manager;
   scene_manager.init(window_manager);
+  printf("Scenes loaded in %.1f ms\n",
+         std::chrono::duration<float, std::milli>(Clock::now() - load_start)
+             .count());
+
+  if (!replay_path.empty()) {
+    scene_manager.replay_input(replay);
+    return run_replay(scene_manager);
+  }
+  if (!record_path.empty() && !scene_manager.record_input(record_path))
+    return EXIT_FAILURE;
+
+  // The simulation thread steps the scenes SIMULATION_STEP_MS at a time and
+  // publishes each step, the main thread owns the window and the GL context:
+  // it polls the input, which the next step picks up, and draws the newest
+  // step published. A slow frame or a vsync wait only delays the drawing.
+  std::atomic<bool> running{true};
+  std::thread simulation([&] {
+    const auto step = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float, std::milli>(SIMULATION_STEP_MS));
+    auto next_step = Clock::now();
+    long step_counter = 0;
+    auto step_timer = Clock::now();
+    while (!scene_manager.is_quit_game() && scene_manager.rounds_left != 0) {
+      auto now = Clock::now();
+      int steps = 0;
+      while (next_step <= now && steps < MAX_SIMULATION_STEPS_PER_FRAME &&
+             !scene_manager.is_quit_game()) {
+        scene_manager.step_current_scene(SIMULATION_STEP_MS);
+        next_step += step;
+        steps++;
+      }
+      // too far behind, drop the time instead of catching up in the next
+      // steps
+      if (steps == MAX_SIMULATION_STEPS_PER_FRAME && next_step < now)
+        next_step = now;
+
+      step_counter += steps;
+      float last_stats_update =
+          (float)(std::chrono::duration_cast<std::chrono::seconds>(
+                      now - step_timer))
+              .count();
+      if (last_stats_update > 5) {
+        SleepStats sleep_stats = scene_manager.sleep_stats();
+        printf(
+            "steps/s: %d, input latency: %.1f ms, input dropped: %u, bodies "
+            "awake: %zu, asleep: %zu\n",
+            int(step_counter / last_stats_update),
+            scene_manager.take_input_latency_ms(),
+            scene_manager.take_dropped_input(), sleep_stats.awake,
+            sleep_stats.asleep);
+        step_timer = now;
+        step_counter = 0;
+      }
+      std::this_thread::sleep_until(next_step);
+    }
+    running = false;
+  });
 
-  // variable timestep loop
-  auto t = Clock::now();
   long frame_counter = 0;
+  unsigned int gl_error_counter = 0;
   auto frame_timer = Clock::now();
 
-  while (!scene_manager.is_quit_game()) {
+  while (running) {
     // Processes system messages, if this wasn't present the window would become
     // unresponsive
-    glfwPollEvents();
+    window_manager->poll_events();
 
-    // Calculating elapsed times in milliseconds from the previous iteration
     auto now = Clock::now();
-    float elapsed_ms =
-        (float)(std::chrono::duration_cast<std::chrono::microseconds>(now - t))
-            .count() /
-        1000;
-    t = now;
-
     frame_counter += 1;
     float last_fps_update =
         (float)(std::chrono::duration_cast<std::chrono::seconds>(now -
                                                                  frame_timer))
             .count();
     if (last_fps_update > 5) {
-      printf("fps: %d\n", int(frame_counter / last_fps_update));
+      printf("fps: %d, OpenGL errors: %u\n",
+             int(frame_counter / last_fps_update), gl_error_counter);
       frame_timer = now;
       frame_counter = 0;
+      gl_error_counter = 0;
     }
 
-    scene_manager.step_current_scene(elapsed_ms);
-
-    if (scene_manager.rounds_left == 0) break;
+    // blocks on vsync, the simulation steps on meanwhile
+    scene_manager.draw_current_scene();
+    gl_error_counter += gl_end_frame_errors();
   }
+  simulation.join();
 
+  if (deterministic) scene_manager.finish_run();
   printf("Thank you for playing our game!\n");
 
   return EXIT_SUCCESS;
@@ -0,0 +1,349 @@
+#include "narrow_phase.hpp"
+
+// stlib
+#include <algorithm>
+#include <cmath>
+
+void NarrowPhaseBodies::clear() {
+  x.clear();
+  y.clear();
+  radius.clear();
+  half_width.clear();
+  half_height.clear();
+}
+
+unsigned int NarrowPhaseBodies::add(glm::vec2 position, float radius,
+                                    glm::vec2 half_extents) {
+  x.push_back(position.x);
+  y.push_back(position.y);
+  this->radius.push_back(radius);
+  half_width.push_back(half_extents.x);
+  half_height.push_back(half_extents.y);
+  return (unsigned int)x.size() - 1;
+}
+
+namespace {
+
+SimdLevel selected_level = simd_best_level();
+
+// Scalar tests, also used for the pairs left over after the last full batch
+
+bool circle_hit(const NarrowPhaseBodies &bodies, const BroadPhasePair &pair,
+                CircleContact contact) {
+  const float dx = bodies.x[pair.a] - bodies.x[pair.b];
+  const float dy = bodies.y[pair.a] - bodies.y[pair.b];
+  const float ra = bodies.radius[pair.a];
+  const float rb = bodies.radius[pair.b];
+  const float r = contact == CircleContact::SUM_OF_RADII ? ra + rb
+                                                         : std::max(ra, rb);
+  return dx * dx + dy * dy < r * r;
+}
+
+bool circle_box_hit(const NarrowPhaseBodies &bodies,
+                    const BroadPhasePair &pair) {
+  // distance from the circle to the closest point of the box, per axis
+  const float dx = std::max(
+      std::abs(bodies.x[pair.a] - bodies.x[pair.b]) - bodies.half_width[pair.b],
+      0.f);
+  const float dy = std::max(std::abs(bodies.y[pair.a] - bodies.y[pair.b]) -
+                                bodies.half_height[pair.b],
+                            0.f);
+  const float r = bodies.radius[pair.a];
+  return dx * dx + dy * dy <= r * r;
+}
+
+bool box_hit(const NarrowPhaseBodies &bodies, const BroadPhasePair &pair) {
+  return std::abs(bodies.x[pair.a] - bodies.x[pair.b]) <=
+             bodies.half_width[pair.a] + bodies.half_width[pair.b] &&
+         std::abs(bodies.y[pair.a] - bodies.y[pair.b]) <=
+             bodies.half_height[pair.a] + bodies.half_height[pair.b];
+}
+
+// Writes the pairs of the batch starting at first whose bit is set in mask at
+// out + hits. Every lane is written and only the hits advance, about half of
+// the candidates touch so a branch per lane would be mispredicted a lot.
+template <int LANES>
+inline void append_hits(const BroadPhasePair *pairs, size_t first, int mask,
+                        BroadPhasePair *out, size_t &hits) {
+  for (int lane = 0; lane < LANES; lane++) {
+    out[hits] = pairs[first + lane];
+    hits += (mask >> lane) & 1;
+  }
+}
+
+#if SIMD_X86
+
+// SSE: 4 pairs per batch. There is no gather before AVX2 so the lanes are
+// loaded one by one, the arithmetic is still done 4 at a time.
+
+const int SSE_LANES = 4;
+
+inline __m128 load4(const std::vector<float> &values,
+                    const BroadPhasePair *pairs, bool second) {
+  return second ? _mm_setr_ps(values[pairs[0].b], values[pairs[1].b],
+                              values[pairs[2].b], values[pairs[3].b])
+                : _mm_setr_ps(values[pairs[0].a], values[pairs[1].a],
+                              values[pairs[2].a], values[pairs[3].a]);
+}
+
+inline __m128 abs4(__m128 v) {
+  return _mm_andnot_ps(_mm_set1_ps(-0.f), v);
+}
+
+size_t circle_pairs_sse(const NarrowPhaseBodies &bodies,
+                        const std::vector<BroadPhasePair> &pairs,
+                        CircleContact contact,
+                        BroadPhasePair *out) {
+  size_t hits = 0;
+  const size_t batches = pairs.size() / SSE_LANES * SSE_LANES;
+  for (size_t i = 0; i < batches; i += SSE_LANES) {
+    const BroadPhasePair *batch = &pairs[i];
+    __m128 dx = _mm_sub_ps(load4(bodies.x, batch, false),
+                           load4(bodies.x, batch, true));
+    __m128 dy = _mm_sub_ps(load4(bodies.y, batch, false),
+                           load4(bodies.y, batch, true));
+    __m128 ra = load4(bodies.radius, batch, false);
+    __m128 rb = load4(bodies.radius, batch, true);
+    __m128 r = contact == CircleContact::SUM_OF_RADII ? _mm_add_ps(ra, rb)
+                                                      : _mm_max_ps(ra, rb);
+    __m128 distance_squared =
+        _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    int mask = _mm_movemask_ps(_mm_cmplt_ps(distance_squared, _mm_mul_ps(r, r)));
+    append_hits<SSE_LANES>(pairs.data(), i, mask, out, hits);
+  }
+  return hits;
+}
+
+size_t circle_box_pairs_sse(const NarrowPhaseBodies &bodies,
+                            const std::vector<BroadPhasePair> &pairs,
+                            BroadPhasePair *out) {
+  size_t hits = 0;
+  const size_t batches = pairs.size() / SSE_LANES * SSE_LANES;
+  const __m128 zero = _mm_setzero_ps();
+  for (size_t i = 0; i < batches; i += SSE_LANES) {
+    const BroadPhasePair *batch = &pairs[i];
+    __m128 dx = abs4(_mm_sub_ps(load4(bodies.x, batch, false),
+                                load4(bodies.x, batch, true)));
+    __m128 dy = abs4(_mm_sub_ps(load4(bodies.y, batch, false),
+                                load4(bodies.y, batch, true)));
+    dx = _mm_max_ps(_mm_sub_ps(dx, load4(bodies.half_width, batch, true)),
+                    zero);
+    dy = _mm_max_ps(_mm_sub_ps(dy, load4(bodies.half_height, batch, true)),
+                    zero);
+    __m128 r = load4(bodies.radius, batch, false);
+    __m128 distance_squared =
+        _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    int mask = _mm_movemask_ps(_mm_cmple_ps(distance_squared, _mm_mul_ps(r, r)));
+    append_hits<SSE_LANES>(pairs.data(), i, mask, out, hits);
+  }
+  return hits;
+}
+
+size_t box_pairs_sse(const NarrowPhaseBodies &bodies,
+                     const std::vector<BroadPhasePair> &pairs,
+                     BroadPhasePair *out) {
+  size_t hits = 0;
+  const size_t batches = pairs.size() / SSE_LANES * SSE_LANES;
+  for (size_t i = 0; i < batches; i += SSE_LANES) {
+    const BroadPhasePair *batch = &pairs[i];
+    __m128 dx = abs4(_mm_sub_ps(load4(bodies.x, batch, false),
+                                load4(bodies.x, batch, true)));
+    __m128 dy = abs4(_mm_sub_ps(load4(bodies.y, batch, false),
+                                load4(bodies.y, batch, true)));
+    __m128 reach_x = _mm_add_ps(load4(bodies.half_width, batch, false),
+                                load4(bodies.half_width, batch, true));
+    __m128 reach_y = _mm_add_ps(load4(bodies.half_height, batch, false),
+                                load4(bodies.half_height, batch, true));
+    int mask = _mm_movemask_ps(
+        _mm_and_ps(_mm_cmple_ps(dx, reach_x), _mm_cmple_ps(dy, reach_y)));
+    append_hits<SSE_LANES>(pairs.data(), i, mask, out, hits);
+  }
+  return hits;
+}
+
+// AVX2: 8 pairs per batch, the ids are split into a and b lanes and the body
+// fields gathered with them. Not fused (SIMD_TARGET_AVX2_EXACT), a pair just
+// touching is a contact on every path.
+
+const int AVX2_LANES = 8;
+
+struct PairLanes {
+  __m256i a, b;
+};
+
+SIMD_TARGET_AVX2_EXACT inline PairLanes load_pairs8(
+    const BroadPhasePair *pairs) {
+  static_assert(sizeof(BroadPhasePair) == 2 * sizeof(unsigned int),
+                "pairs are loaded as interleaved ids");
+  // a0 b0 a1 b1 a2 b2 a3 b3 -> a0 a1 a2 a3 b0 b1 b2 b3
+  const __m256i split = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  __m256i low = _mm256_permutevar8x32_epi32(
+      _mm256_loadu_si256((const __m256i *)pairs), split);
+  __m256i high = _mm256_permutevar8x32_epi32(
+      _mm256_loadu_si256((const __m256i *)(pairs + 4)), split);
+  return {_mm256_permute2x128_si256(low, high, 0x20),
+          _mm256_permute2x128_si256(low, high, 0x31)};
+}
+
+SIMD_TARGET_AVX2_EXACT inline __m256 gather8(
+    const std::vector<float> &values, __m256i ids) {
+  return _mm256_i32gather_ps(values.data(), ids, 4);
+}
+
+SIMD_TARGET_AVX2_EXACT inline __m256 abs8(__m256 v) {
+  return _mm256_andnot_ps(_mm256_set1_ps(-0.f), v);
+}
+
+SIMD_TARGET_AVX2_EXACT size_t circle_pairs_avx2(
+    const NarrowPhaseBodies &bodies, const std::vector<BroadPhasePair> &pairs,
+    CircleContact contact, BroadPhasePair *out) {
+  size_t hits = 0;
+  const size_t batches = pairs.size() / AVX2_LANES * AVX2_LANES;
+  for (size_t i = 0; i < batches; i += AVX2_LANES) {
+    PairLanes ids = load_pairs8(&pairs[i]);
+    __m256 dx = _mm256_sub_ps(gather8(bodies.x, ids.a), gather8(bodies.x, ids.b));
+    __m256 dy = _mm256_sub_ps(gather8(bodies.y, ids.a), gather8(bodies.y, ids.b));
+    __m256 ra = gather8(bodies.radius, ids.a);
+    __m256 rb = gather8(bodies.radius, ids.b);
+    __m256 r = contact == CircleContact::SUM_OF_RADII ? _mm256_add_ps(ra, rb)
+                                                      : _mm256_max_ps(ra, rb);
+    __m256 distance_squared =
+        _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    int mask = _mm256_movemask_ps(
+        _mm256_cmp_ps(distance_squared, _mm256_mul_ps(r, r), _CMP_LT_OQ));
+    append_hits<AVX2_LANES>(pairs.data(), i, mask, out, hits);
+  }
+  return hits;
+}
+
+SIMD_TARGET_AVX2_EXACT size_t circle_box_pairs_avx2(
+    const NarrowPhaseBodies &bodies, const std::vector<BroadPhasePair> &pairs,
+    BroadPhasePair *out) {
+  size_t hits = 0;
+  const size_t batches = pairs.size() / AVX2_LANES * AVX2_LANES;
+  const __m256 zero = _mm256_setzero_ps();
+  for (size_t i = 0; i < batches; i += AVX2_LANES) {
+    PairLanes ids = load_pairs8(&pairs[i]);
+    __m256 dx = abs8(
+        _mm256_sub_ps(gather8(bodies.x, ids.a), gather8(bodies.x, ids.b)));
+    __m256 dy = abs8(
+        _mm256_sub_ps(gather8(bodies.y, ids.a), gather8(bodies.y, ids.b)));
+    dx = _mm256_max_ps(_mm256_sub_ps(dx, gather8(bodies.half_width, ids.b)),
+                       zero);
+    dy = _mm256_max_ps(_mm256_sub_ps(dy, gather8(bodies.half_height, ids.b)),
+                       zero);
+    __m256 r = gather8(bodies.radius, ids.a);
+    __m256 distance_squared =
+        _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    int mask = _mm256_movemask_ps(
+        _mm256_cmp_ps(distance_squared, _mm256_mul_ps(r, r), _CMP_LE_OQ));
+    append_hits<AVX2_LANES>(pairs.data(), i, mask, out, hits);
+  }
+  return hits;
+}
+
+SIMD_TARGET_AVX2_EXACT size_t box_pairs_avx2(
+    const NarrowPhaseBodies &bodies, const std::vector<BroadPhasePair> &pairs,
+    BroadPhasePair *out) {
+  size_t hits = 0;
+  const size_t batches = pairs.size() / AVX2_LANES * AVX2_LANES;
+  for (size_t i = 0; i < batches; i += AVX2_LANES) {
+    PairLanes ids = load_pairs8(&pairs[i]);
+    __m256 dx = abs8(
+        _mm256_sub_ps(gather8(bodies.x, ids.a), gather8(bodies.x, ids.b)));
+    __m256 dy = abs8(
+        _mm256_sub_ps(gather8(bodies.y, ids.a), gather8(bodies.y, ids.b)));
+    __m256 reach_x = _mm256_add_ps(gather8(bodies.half_width, ids.a),
+                                   gather8(bodies.half_width, ids.b));
+    __m256 reach_y = _mm256_add_ps(gather8(bodies.half_height, ids.a),
+                                   gather8(bodies.half_height, ids.b));
+    int mask = _mm256_movemask_ps(
+        _mm256_and_ps(_mm256_cmp_ps(dx, reach_x, _CMP_LE_OQ),
+                      _mm256_cmp_ps(dy, reach_y, _CMP_LE_OQ)));
+    append_hits<AVX2_LANES>(pairs.data(), i, mask, out, hits);
+  }
+  return hits;
+}
+
+#endif  // SIMD_X86
+
+}  // namespace
+
+// The kernels write every lane of a batch, so out_hits is first grown by the
+// number of pairs then shrunk to the hits.
+
+void circle_pairs(const NarrowPhaseBodies &bodies,
+                  const std::vector<BroadPhasePair> &pairs,
+                  CircleContact contact,
+                  std::vector<BroadPhasePair> &out_hits) {
+  const size_t first = out_hits.size();
+  out_hits.resize(first + pairs.size());
+  BroadPhasePair *out = out_hits.data() + first;
+  size_t hits = 0, done = 0;
+#if SIMD_X86
+  if (selected_level == SimdLevel::AVX2) {
+    hits = circle_pairs_avx2(bodies, pairs, contact, out);
+    done = pairs.size() / AVX2_LANES * AVX2_LANES;
+  } else if (selected_level == SimdLevel::SSE) {
+    hits = circle_pairs_sse(bodies, pairs, contact, out);
+    done = pairs.size() / SSE_LANES * SSE_LANES;
+  }
+#endif
+  for (size_t i = done; i < pairs.size(); i++) {
+    out[hits] = pairs[i];
+    hits += circle_hit(bodies, pairs[i], contact);
+  }
+  out_hits.resize(first + hits);
+}
+
+void circle_box_pairs(const NarrowPhaseBodies &bodies,
+                      const std::vector<BroadPhasePair> &pairs,
+                      std::vector<BroadPhasePair> &out_hits) {
+  const size_t first = out_hits.size();
+  out_hits.resize(first + pairs.size());
+  BroadPhasePair *out = out_hits.data() + first;
+  size_t hits = 0, done = 0;
+#if SIMD_X86
+  if (selected_level == SimdLevel::AVX2) {
+    hits = circle_box_pairs_avx2(bodies, pairs, out);
+    done = pairs.size() / AVX2_LANES * AVX2_LANES;
+  } else if (selected_level == SimdLevel::SSE) {
+    hits = circle_box_pairs_sse(bodies, pairs, out);
+    done = pairs.size() / SSE_LANES * SSE_LANES;
+  }
+#endif
+  for (size_t i = done; i < pairs.size(); i++) {
+    out[hits] = pairs[i];
+    hits += circle_box_hit(bodies, pairs[i]);
+  }
+  out_hits.resize(first + hits);
+}
+
+void box_pairs(const NarrowPhaseBodies &bodies,
+               const std::vector<BroadPhasePair> &pairs,
+               std::vector<BroadPhasePair> &out_hits) {
+  const size_t first = out_hits.size();
+  out_hits.resize(first + pairs.size());
+  BroadPhasePair *out = out_hits.data() + first;
+  size_t hits = 0, done = 0;
+#if SIMD_X86
+  if (selected_level == SimdLevel::AVX2) {
+    hits = box_pairs_avx2(bodies, pairs, out);
+    done = pairs.size() / AVX2_LANES * AVX2_LANES;
+  } else if (selected_level == SimdLevel::SSE) {
+    hits = box_pairs_sse(bodies, pairs, out);
+    done = pairs.size() / SSE_LANES * SSE_LANES;
+  }
+#endif
+  for (size_t i = done; i < pairs.size(); i++) {
+    out[hits] = pairs[i];
+    hits += box_hit(bodies, pairs[i]);
+  }
+  out_hits.resize(first + hits);
+}
+
+SimdLevel narrow_phase_simd_level() { return selected_level; }
+
+void set_narrow_phase_simd_level(SimdLevel level) {
+  selected_level = std::min(level, simd_best_level());
+}
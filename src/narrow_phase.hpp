@@ -0,0 +1,65 @@
+#pragma once
+
+// stlib
+#include <vector>
+
+#include <glm/vec2.hpp>  // vec2
+
+// internal
+#include "broad_phase.hpp"
+#include "simd.hpp"
+
+// Batched narrow phase over the candidate pairs of a BroadPhase.
+//
+// The physics system adds its bodies to a NarrowPhaseBodies in the order it
+// inserts them in the broad phase, so the ids of the pairs index these arrays,
+// then runs one of the kernels below on the pair list. The kernels test 8
+// pairs at a time with AVX2, 4 with SSE, or one by one on other CPUs, and only
+// compare squared distances. The pairs that touch are appended to out_hits in
+// their input order.
+//
+// Like the broad phase, nothing in here touches the ECS or OpenGL.
+
+struct NarrowPhaseBodies {
+  std::vector<float> x, y;
+  std::vector<float> radius;
+  std::vector<float> half_width, half_height;
+
+  void clear();
+
+  // Returns the id of the body, radius is for the circle tests, half_extents
+  // for the box tests
+  unsigned int add(glm::vec2 position, float radius,
+                   glm::vec2 half_extents = {0.f, 0.f});
+
+  size_t size() const { return x.size(); }
+};
+
+// How far apart two circles may be
+enum class CircleContact {
+  SUM_OF_RADII,   // the circles overlap
+  LARGER_RADIUS,  // a center is inside the larger circle (collides1/2/3)
+};
+
+// Circle against circle, touching when the squared distance of the centers
+// is below the squared contact radius
+void circle_pairs(const NarrowPhaseBodies &bodies,
+                  const std::vector<BroadPhasePair> &pairs,
+                  CircleContact contact,
+                  std::vector<BroadPhasePair> &out_hits);
+
+// Circle of pair.a against box of pair.b, touching when the closest point of
+// the box is within the radius
+void circle_box_pairs(const NarrowPhaseBodies &bodies,
+                      const std::vector<BroadPhasePair> &pairs,
+                      std::vector<BroadPhasePair> &out_hits);
+
+// Box against box
+void box_pairs(const NarrowPhaseBodies &bodies,
+               const std::vector<BroadPhasePair> &pairs,
+               std::vector<BroadPhasePair> &out_hits);
+
+// Level used by the kernels, simd_best_level() unless overridden. Setting a
+// level above what the CPU supports falls back to the best supported one.
+SimdLevel narrow_phase_simd_level();
+void set_narrow_phase_simd_level(SimdLevel level);
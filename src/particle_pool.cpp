@@ -0,0 +1,256 @@
+#include "particle_pool.hpp"
+
+// stlib
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+SimdLevel selected_level = simd_best_level();
+
+// Directions of the spawn angle table, a power of two so the angles wrap
+// around with a mask
+const unsigned int ANGLE_STEPS = 4096;
+const float DEGREES_PER_STEP = 360.f / ANGLE_STEPS;
+const double PI = 3.14159265358979323846;
+
+struct AngleTable {
+  float x[ANGLE_STEPS], y[ANGLE_STEPS];
+
+  AngleTable() {
+    for (unsigned int i = 0; i < ANGLE_STEPS; i++) {
+      double radians = i * 2.0 * PI / ANGLE_STEPS;
+      x[i] = (float)cos(radians);
+      y[i] = (float)sin(radians);
+    }
+  }
+};
+
+const AngleTable& angle_table() {
+  static const AngleTable table;
+  return table;
+}
+
+// Counter based random numbers: the splitmix64 finalizer of the key and the
+// counter, each particle gets 64 independent bits from one multiply chain
+inline uint64_t random_bits(uint32_t key, uint32_t counter) {
+  uint64_t z = (((uint64_t)key << 32) | counter) + 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+// 16 of the bits as a number in [0, 1)
+inline float unit(uint64_t bits, int shift) {
+  return ((bits >> shift) & 0xFFFF) / 65536.f;
+}
+
+// The integration kernels update the particles in [0, count) and append the
+// ones whose life ran out to dead, in order. Position and velocity are read
+// as count * 2 floats, the acceleration is the same for every x and every y.
+// None of them fuses the multiplies and adds, so every level gets the same
+// bits.
+
+void integrate_scalar(size_t begin, size_t count, float* position,
+                      float* velocity, float* life, float ms, float seconds,
+                      glm::vec2 acceleration,
+                      std::vector<unsigned int>& dead) {
+  for (size_t i = begin; i < count; i++) {
+    position[2 * i] += velocity[2 * i] * seconds;
+    position[2 * i + 1] += velocity[2 * i + 1] * seconds;
+    velocity[2 * i] += acceleration.x * seconds;
+    velocity[2 * i + 1] += acceleration.y * seconds;
+    life[i] -= ms;
+    if (life[i] < 0) dead.push_back((unsigned int)i);
+  }
+}
+
+#if SIMD_X86
+
+// Adds the lanes of the batch at first whose bit is set in mask
+inline void append_dead(size_t first, int lanes, int mask,
+                        std::vector<unsigned int>& dead) {
+  if (mask == 0) return;
+  for (int lane = 0; lane < lanes; lane++)
+    if ((mask >> lane) & 1) dead.push_back((unsigned int)(first + lane));
+}
+
+// SSE: 4 particles per batch, their 8 position and velocity floats in two
+// registers each
+
+const size_t SSE_LANES = 4;
+
+size_t integrate_sse(size_t count, float* position, float* velocity,
+                     float* life, float ms, float seconds,
+                     glm::vec2 acceleration,
+                     std::vector<unsigned int>& dead) {
+  const __m128 dt = _mm_set1_ps(seconds);
+  const __m128 age = _mm_set1_ps(ms);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 dv = _mm_mul_ps(
+      _mm_setr_ps(acceleration.x, acceleration.y, acceleration.x,
+                  acceleration.y),
+      dt);
+  size_t i = 0;
+  for (; i + SSE_LANES <= count; i += SSE_LANES) {
+    for (size_t half = 0; half < 2 * SSE_LANES; half += SSE_LANES) {
+      float* p = position + 2 * i + half;
+      float* v = velocity + 2 * i + half;
+      __m128 vel = _mm_loadu_ps(v);
+      _mm_storeu_ps(p, _mm_add_ps(_mm_loadu_ps(p), _mm_mul_ps(vel, dt)));
+      _mm_storeu_ps(v, _mm_add_ps(vel, dv));
+    }
+    __m128 left = _mm_sub_ps(_mm_loadu_ps(life + i), age);
+    _mm_storeu_ps(life + i, left);
+    append_dead(i, SSE_LANES, _mm_movemask_ps(_mm_cmplt_ps(left, zero)),
+                dead);
+  }
+  return i;
+}
+
+// AVX2: 8 particles per batch
+
+const size_t AVX2_LANES = 8;
+
+SIMD_TARGET_AVX2_EXACT size_t integrate_avx2(
+    size_t count, float* position, float* velocity, float* life, float ms,
+    float seconds, glm::vec2 acceleration, std::vector<unsigned int>& dead) {
+  const __m256 dt = _mm256_set1_ps(seconds);
+  const __m256 age = _mm256_set1_ps(ms);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 dv = _mm256_mul_ps(
+      _mm256_setr_ps(acceleration.x, acceleration.y, acceleration.x,
+                     acceleration.y, acceleration.x, acceleration.y,
+                     acceleration.x, acceleration.y),
+      dt);
+  size_t i = 0;
+  for (; i + AVX2_LANES <= count; i += AVX2_LANES) {
+    for (size_t half = 0; half < 2 * AVX2_LANES; half += AVX2_LANES) {
+      float* p = position + 2 * i + half;
+      float* v = velocity + 2 * i + half;
+      __m256 vel = _mm256_loadu_ps(v);
+      _mm256_storeu_ps(
+          p, _mm256_add_ps(_mm256_loadu_ps(p), _mm256_mul_ps(vel, dt)));
+      _mm256_storeu_ps(v, _mm256_add_ps(vel, dv));
+    }
+    __m256 left = _mm256_sub_ps(_mm256_loadu_ps(life + i), age);
+    _mm256_storeu_ps(life + i, left);
+    append_dead(i, AVX2_LANES,
+                _mm256_movemask_ps(_mm256_cmp_ps(left, zero, _CMP_LT_OQ)),
+                dead);
+  }
+  return i;
+}
+
+#endif  // SIMD_X86
+
+}  // namespace
+
+ParticlePool::ParticlePool(size_t capacity)
+    : position(capacity),
+      velocity(capacity),
+      size_px(capacity),
+      life_ms(capacity) {
+  dead.reserve(capacity);
+}
+
+bool ParticlePool::spawn(glm::vec2 position, glm::vec2 velocity,
+                         float size_px, float life_ms) {
+  if (count == capacity()) return false;
+  this->position[count] = position;
+  this->velocity[count] = velocity;
+  this->size_px[count] = size_px;
+  this->life_ms[count] = life_ms;
+  count++;
+  return true;
+}
+
+size_t ParticlePool::allocate(size_t wanted, size_t& first) {
+  first = count;
+  size_t added = std::min(wanted, capacity() - count);
+  count += added;
+  return added;
+}
+
+void ParticlePool::kill(size_t particle) {
+  count--;
+  position[particle] = position[count];
+  velocity[particle] = velocity[count];
+  size_px[particle] = size_px[count];
+  life_ms[particle] = life_ms[count];
+}
+
+void ParticlePool::step(float ms, glm::vec2 acceleration) {
+  if (count == 0) return;
+  const float seconds = ms / 1000.0f;
+  // a vec2 is two floats, the kernels see the x and y of the particles
+  float* p = &position[0].x;
+  float* v = &velocity[0].x;
+  dead.clear();
+  size_t done = 0;
+#if SIMD_X86
+  if (selected_level == SimdLevel::AVX2) {
+    done = integrate_avx2(count, p, v, life_ms.data(), ms, seconds,
+                          acceleration, dead);
+  } else if (selected_level == SimdLevel::SSE) {
+    done = integrate_sse(count, p, v, life_ms.data(), ms, seconds,
+                         acceleration, dead);
+  }
+#endif
+  integrate_scalar(done, count, p, v, life_ms.data(), ms, seconds,
+                   acceleration, dead);
+
+  // From the last one down the particle moved into a dead slot is always
+  // alive, the dead after it are gone already
+  for (size_t i = dead.size(); i-- > 0;) kill(dead[i]);
+}
+
+void ParticleEmitter::emit(float ms, glm::vec2 origin, ParticlePool& pool,
+                           std::default_random_engine& rng) {
+  life_ms += ms;
+  spawn_timeout_ms -= ms;
+  if (spawn_timeout_ms > 0 || life_ms >= lifetime_ms) return;
+
+  size_t due = (size_t)(-spawn_timeout_ms / spawning_rate_ms);  // fps agnostic
+  if (due == 0) return;
+  spawn_batch(due, origin, pool, (unsigned int)rng());
+  spawn_timeout_ms = spawning_rate_ms;
+}
+
+size_t ParticleEmitter::spawn_batch(size_t wanted, glm::vec2 origin,
+                                    ParticlePool& pool,
+                                    unsigned int key) const {
+  size_t first;
+  size_t added = pool.allocate(wanted, first);
+
+  // the cone in steps of the angle table, from its first edge
+  const AngleTable& table = angle_table();
+  float first_angle = spawning_angle - cone_angle / 2.0f;
+  int first_step =
+      (int)std::floor(first_angle / DEGREES_PER_STEP + 0.5f);
+  float cone_steps = cone_angle / DEGREES_PER_STEP + 1.f;
+
+  for (size_t i = 0; i < added; i++) {
+    uint64_t bits = random_bits(key, (uint32_t)i);
+    unsigned int angle =
+        (unsigned int)(first_step + (int)(unit(bits, 0) * cone_steps)) &
+        (ANGLE_STEPS - 1);
+    float speed = initial_speed * (1 - unit(bits, 16) * speed_randomness);
+
+    size_t slot = first + i;
+    pool.position[slot] = origin;
+    pool.velocity[slot] = {table.x[angle] * speed, table.y[angle] * speed};
+    pool.size_px[slot] = particle_size * (1 - unit(bits, 32) * size_randomness);
+    pool.life_ms[slot] =
+        particle_lifetime_ms * (1 - unit(bits, 48) * lifetime_randomness);
+  }
+  return added;
+}
+
+SimdLevel particle_simd_level() { return selected_level; }
+
+void set_particle_simd_level(SimdLevel level) {
+  selected_level = std::min(level, simd_best_level());
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+// stlib
+#include <random>
+#include <vector>
+
+// The glm library provides vector and matrix operations as in GLSL
+#include <glm/vec2.hpp>  // vec2
+
+// internal
+#include "simd.hpp"
+
+// Particle storage and emitters for any scene.
+//
+// A ParticlePool holds up to a fixed number of particles in one array per
+// field. The live particles are always the first size() entries: a dying
+// particle is replaced by the last live one, so nothing is ever allocated
+// after construction, the arrays never grow and the renderer can upload the
+// positions and sizes as they are.
+//
+// step() integrates 8 particles at a time with AVX2, 4 with SSE, or one by
+// one on other CPUs, and finds the dead ones with a mask of the lifetimes
+// that ran out. The dead are then swapped out from the last one down, so every
+// level leaves the same particles in the same slots.
+//
+// A ParticleEmitter holds the parameters of a spray of particles and the
+// timers of its spawning, and spawns into a pool it is given. The particles
+// due in a step are spawned as one batch: their random numbers come from a
+// hash of a per batch key and the particle's number in the batch, and their
+// directions from a table, so there is no sin or cos per particle.
+//
+// Like the broad phase, nothing in here touches the ECS or OpenGL.
+
+const size_t DEFAULT_PARTICLE_CAPACITY = 1024;
+
+class ParticlePool {
+ public:
+  explicit ParticlePool(size_t capacity = DEFAULT_PARTICLE_CAPACITY);
+
+  // live particles in [0, size()), the rest is free space
+  std::vector<glm::vec2> position;
+  std::vector<glm::vec2> velocity;
+  std::vector<float> size_px;
+  std::vector<float> life_ms;  // left to live
+
+  // Adds a particle, dropped when the pool is full
+  bool spawn(glm::vec2 position, glm::vec2 velocity, float size_px,
+             float life_ms);
+
+  // Makes room for up to count particles after the live ones, sets first to
+  // the slot of the first and returns how many fit. The caller fills all the
+  // fields of the new slots.
+  size_t allocate(size_t count, size_t& first);
+
+  // Moves the last live particle into the slot of particle
+  void kill(size_t particle);
+
+  // Ages every particle by ms, moves it along its velocity then accelerates
+  // it, and removes the ones whose life ran out
+  void step(float ms, glm::vec2 acceleration);
+
+  void clear() { count = 0; }
+
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  size_t capacity() const { return position.size(); }
+
+ private:
+  size_t count = 0;
+  std::vector<unsigned int> dead;  // of the current step, in order
+};
+
+struct ParticleEmitter {
+  float lifetime_ms = 2000;  // spawns until then
+  float spawning_rate_ms = 0.1f;  // time between two particles
+  float spawning_angle = 90.0f;  // in degrees, 0 is axis {1,0}
+  int cone_angle = 0;  // spawns in a cone of cone_angle degrees around it
+  float initial_speed = 500.0f;
+  // from 0 - 1 where 0 is no randomness and 1 can spawn with a speed
+  // between 0 and initial_speed, same for the others
+  float speed_randomness = 0.25f;
+  float particle_lifetime_ms = 5000.0f;
+  float lifetime_randomness = 0.25f;
+  float particle_size = 50.0f;
+  float size_randomness = 0.25f;
+  glm::vec2 acceleration = {0, 1000};
+
+  // state
+  float life_ms = 0.0f;
+  float spawn_timeout_ms = 0.0f;
+
+  // Advances the emitter by ms and spawns the particles due at origin. rng
+  // is drawn once per batch.
+  void emit(float ms, glm::vec2 origin, ParticlePool& pool,
+            std::default_random_engine& rng);
+
+  // Spawns count particles at origin as one batch with the random numbers of
+  // key, returns how many fit in the pool
+  size_t spawn_batch(size_t count, glm::vec2 origin, ParticlePool& pool,
+                     unsigned int key) const;
+
+  // Done spawning, remove it once its particles are gone too
+  bool expired() const { return life_ms > lifetime_ms; }
+};
+
+// Level of the integration kernels, simd_best_level() unless overridden.
+// Setting a level above what the CPU supports falls back to the best
+// supported one.
+SimdLevel particle_simd_level();
+void set_particle_simd_level(SimdLevel level);
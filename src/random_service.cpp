@@ -0,0 +1,28 @@
+#include "random_service.hpp"
+
+RandomService random_service;
+
+void RandomService::seed(uint32_t run_seed) {
+  std::lock_guard<std::mutex> lock(mutex);
+  deterministic = true;
+  seed_value = run_seed;
+  engines_handed_out.clear();
+}
+
+std::default_random_engine RandomService::engine(const std::string &scene) {
+  if (!deterministic) return std::default_random_engine(std::random_device()());
+
+  // FNV-1a over the run seed, the scene name and the request count
+  uint32_t hash = 2166136261u;
+  auto mix = [&hash](uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+      hash ^= (value >> (8 * i)) & 0xff;
+      hash *= 16777619u;
+    }
+  };
+  std::lock_guard<std::mutex> lock(mutex);
+  mix(seed_value);
+  for (char c : scene) mix((uint8_t)c);
+  mix(engines_handed_out[scene]++);
+  return std::default_random_engine(hash);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+// stlib
+#include <stdint.h>
+
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+
+// Hands out the random engines of the scenes.
+//
+// In normal play every engine is seeded from std::random_device. After
+// seed(), for --seed or a replay, an engine is derived from the run seed, the
+// name of the scene and how many engines that scene asked for before, so a
+// scene reseeding on restart still gets a new sequence each round while the
+// whole run repeats exactly. The scenes preparing their next round ask for
+// engines off the simulation thread, see Scene::prepare.
+class RandomService {
+ public:
+  void seed(uint32_t run_seed);
+
+  bool is_deterministic() const { return deterministic; }
+  uint32_t run_seed() const { return seed_value; }
+
+  std::default_random_engine engine(const std::string &scene);
+
+ private:
+  bool deterministic = false;
+  uint32_t seed_value = 0;
+  std::map<std::string, uint32_t> engines_handed_out;
+  std::mutex mutex;
+};
+extern RandomService random_service;
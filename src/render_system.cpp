@@ -2,13 +2,27 @@
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <cmath>
 #include <iostream>
+#include <functional>
 #include <map>
 
 #include "common.hpp"
 
 void RenderSystem::drawTexturedMesh(Entity entity, const mat3 &projection) {
   TransformComponent &transformcomp = registry->transforms.get(entity);
+  // Blend from the pose before the last simulation step to the current one by
+  // how far this frame is into the next step
+  vec2 position = transformcomp.position;
+  float rotation = transformcomp.rotation;
+  if (transformcomp.has_previous && interpolation_alpha < 1.f) {
+    position = mix(transformcomp.previous_position, position,
+                   interpolation_alpha);
+    // shortest way around, rotations may wrap at 2 pi
+    float turn = std::remainder(rotation - transformcomp.previous_rotation,
+                                2.f * M_PI);
+    rotation = rotation - turn * (1.f - interpolation_alpha);
+  }
   // Transformation code, see Rendering and Transformation in the template
   // specification for more info Incrementally updates transformation matrix,
   // thus ORDER IS IMPORTANT
@@ -21,12 +35,12 @@ void RenderSystem::drawTexturedMesh(Entity entity, const mat3 &projection) {
   Transform transform;
   if (registry->UIelements.has(entity)) {
     transform.translate(cameraPosition);
-    transform.translate(transformcomp.position * cameraFOV);
-    transform.rotate(transformcomp.rotation);
+    transform.translate(position * cameraFOV);
+    transform.rotate(rotation);
     transform.scale(transformcomp.scale);
   } else {
-    transform.translate(transformcomp.position);
-    transform.rotate(transformcomp.rotation);
+    transform.translate(position);
+    transform.rotate(rotation);
     transform.scale(transformcomp.scale);
   }
 
@@ -172,7 +186,7 @@ void RenderSystem::drawTexturedMesh(Entity entity, const mat3 &projection) {
     GLuint time_uloc = glGetUniformLocation(program, "time");
     assert(time_uloc >= 0);
 
-    glUniform1f(time_uloc, (float)(glfwGetTime() * 10.0f));
+    glUniform1f(time_uloc, (float)(draw_time_ms / 1000.0 * 10.0));
   }
   else {
     assert(false && "Type of render request not supported");
@@ -206,6 +220,51 @@ void RenderSystem::drawTexturedMesh(Entity entity, const mat3 &projection) {
   gl_has_errors();
 }
 
+void RenderSystem::drawTexturedQuad(TEXTURE_ASSET_ID texture_id,
+                                    vec2 position, vec2 scale,
+                                    const mat3 &projection) {
+  Transform transform;
+  transform.translate(position);
+  transform.scale(scale);
+
+  const GLuint program = effects[(GLuint)EFFECT_ASSET_ID::TEXTURED];
+  glUseProgram(program);
+  gl_has_errors();
+
+  glBindBuffer(GL_ARRAY_BUFFER,
+               vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE]);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,
+               index_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE]);
+  gl_has_errors();
+
+  GLint in_position_loc = glGetAttribLocation(program, "in_position");
+  GLint in_texcoord_loc = glGetAttribLocation(program, "in_texcoord");
+  assert(in_texcoord_loc >= 0);
+  glEnableVertexAttribArray(in_position_loc);
+  glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE,
+                        sizeof(TexturedVertex), (void *)0);
+  glEnableVertexAttribArray(in_texcoord_loc);
+  glVertexAttribPointer(in_texcoord_loc, 2, GL_FLOAT, GL_FALSE,
+                        sizeof(TexturedVertex), (void *)sizeof(vec3));
+  gl_has_errors();
+
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, texture_gl_handles[(GLuint)texture_id]);
+  gl_has_errors();
+
+  const vec3 color = vec3(1);
+  glUniform3fv(glGetUniformLocation(program, "fcolor"), 1, (float *)&color);
+  glUniformMatrix3fv(glGetUniformLocation(program, "transform"), 1, GL_FALSE,
+                     (float *)&transform.mat);
+  glUniformMatrix3fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE,
+                     (float *)&projection);
+  gl_has_errors();
+
+  // the sprite is two triangles
+  glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
+  gl_has_errors();
+}
+
 // draw the intermediate texture to the screen, with some distortion to simulate
 // water
 void RenderSystem::drawToScreen() {
@@ -255,7 +314,7 @@ void RenderSystem::drawToScreen() {
 
   // update uniform with screen states
   ScreenState &screen = registry->screenStates.get(screen_state_entity);
-  glUniform1f(time_uloc, (float)(glfwGetTime() * 10.0f));
+  glUniform1f(time_uloc, (float)(draw_time_ms / 1000.0 * 10.0));
   glUniform1f(screen_brightness_uloc, screen.screen_brightness);
   glUniform1f(blur_size_uloc, screen.blur_size);
   glUniform1i(blur_uloc, screen.blur_fullscreen);
@@ -283,15 +342,114 @@ void RenderSystem::drawToScreen() {
   gl_has_errors();
 }
 
-// Render our game world
-// http://www.opengl-tutorial.org/intermediate-tutorials/tutorial-14-render-to-texture/
-void RenderSystem::draw() {
+// Cheap CPU side check if the cached static layer is still up to date. Anything
+// that changes how a static entity is drawn has to be part of the signature
+bool RenderSystem::staticLayerChanged() {
+  Camera &camera = registry->camera.get(registry->camera.entities[0]);
+
+  size_t signature = registry->staticLayers.size();
+  auto hash_combine = [&signature](size_t value) {
+    signature ^= value + 0x9e3779b9 + (signature << 6) + (signature >> 2);
+  };
+  std::hash<float> hash_float;
+  for (Entity entity : registry->staticLayers.entities) {
+    hash_combine((unsigned int)entity);
+    if (!registry->transforms.has(entity) ||
+        !registry->renderRequests.has(entity))
+      continue;
+
+    const TransformComponent &transform = registry->transforms.get(entity);
+    hash_combine(hash_float(transform.position.x));
+    hash_combine(hash_float(transform.position.y));
+    hash_combine(hash_float(transform.rotation));
+    hash_combine(hash_float(transform.scale.x));
+    hash_combine(hash_float(transform.scale.y));
+
+    const RenderRequest &request = registry->renderRequests.get(entity);
+    hash_combine((size_t)request.used_texture);
+    hash_combine((size_t)request.used_effect);
+
+    if (registry->colors.has(entity)) {
+      const vec3 &color = registry->colors.get(entity);
+      hash_combine(hash_float(color.r));
+      hash_combine(hash_float(color.g));
+      hash_combine(hash_float(color.b));
+    }
+    // spaces light up once a player stepped on them
+    if (registry->spaces.has(entity))
+      hash_combine((size_t)registry->spaces.get(entity).player_stepped_on);
+  }
+
+  bool changed = !static_layer_valid ||
+                 camera.cameraPosition != static_layer_camera_position ||
+                 camera.cameraFOV != static_layer_camera_fov ||
+                 signature != static_layer_signature;
+
+  static_layer_camera_position = camera.cameraPosition;
+  static_layer_camera_fov = camera.cameraFOV;
+  static_layer_signature = signature;
+  return changed;
+}
+
+// Render all static entities into the static layer texture. The layer is
+// cleared with the same colour as the frame buffer so compositing it fully
+// replaces the clear
+void RenderSystem::renderStaticLayer(const mat3 &projection) {
+  int w, h;
+  glfwGetFramebufferSize(window, &w, &h);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, static_layer_frame_buffer);
+  glViewport(0, 0, w, h);
+  glClearColor(0, 0, 1, 1.0);
+  glClear(GL_COLOR_BUFFER_BIT);
+  gl_has_errors();
+
+  // iterate the render requests to keep the order the entities were created in
+  for (Entity entity : registry->renderRequests.entities) {
+    if (!registry->staticLayers.has(entity) ||
+        !registry->transforms.has(entity))
+      continue;
+    drawTexturedMesh(entity, projection);
+  }
+
+  glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+  gl_has_errors();
+  static_layer_valid = true;
+}
+
+// Composite the cached static layer onto the bound frame buffer
+void RenderSystem::drawStaticLayer() {
+  const GLuint program = effects[(GLuint)EFFECT_ASSET_ID::STATIC_LAYER];
+  glUseProgram(program);
+  glDisable(GL_BLEND);
+  gl_has_errors();
+
+  glBindBuffer(GL_ARRAY_BUFFER,
+               vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::SCREEN_TRIANGLE]);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,
+               index_buffers[(GLuint)GEOMETRY_BUFFER_ID::SCREEN_TRIANGLE]);
+  gl_has_errors();
+
+  GLint in_position_loc = glGetAttribLocation(program, "in_position");
+  glEnableVertexAttribArray(in_position_loc);
+  glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE, sizeof(vec3),
+                        (void *)0);
+  gl_has_errors();
+
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, static_layer_color);
+  glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_SHORT, nullptr);
+  gl_has_errors();
+
+  glEnable(GL_BLEND);
+}
+
+// Bind the persistent VAO and prepare the off screen frame buffer
+void RenderSystem::beginOffScreenPass() {
   // Getting size of window
   int w, h;
   glfwGetFramebufferSize(window, &w, &h);
 
-  GLuint vao;
-  glGenVertexArrays(1, &vao);
   glBindVertexArray(vao);
   gl_has_errors();
 
@@ -310,13 +468,109 @@ void RenderSystem::draw() {
                              // and alpha blending, one would have to sort
                              // sprites back to front
   gl_has_errors();
+}
+
+void RenderSystem::show_world() { frame = FRAME::WORLD; }
+
+void RenderSystem::show_text_only(glm::vec3 background_color) {
+  frame = FRAME::TEXT_ONLY;
+  this->background_color = background_color;
+}
+
+void RenderSystem::show_text_with_background(TEXTURE_ASSET_ID bkg_id,
+                                             vec2 position, vec2 scale) {
+  frame = FRAME::TEXT_WITH_BACKGROUND;
+  background = bkg_id;
+  background_position = position;
+  background_scale = scale;
+}
+
+void RenderSystem::publish() {
+  RenderSnapshot &snapshot = snapshots.back();
+  snapshot.registry.copy_render_components(*simulated);
+  snapshot.text = text_render_array;
+  snapshot.frame = frame;
+  snapshot.background_color = background_color;
+  snapshot.background = background;
+  snapshot.background_position = background_position;
+  snapshot.background_scale = background_scale;
+  snapshot.published = std::chrono::steady_clock::now();
+  snapshot.simulation_time_ms = simulation_time_ms;
+  snapshots.publish();
+}
+
+void RenderSystem::draw() {
+  if (snapshots.acquire()) {
+    snapshot_drawn = true;
+    // adopt the camera position only when the simulation moved it, between
+    // two moves it is eased here
+    std::vector<Camera> &cameras = snapshots.front().registry.camera.components;
+    if (!cameras.empty()) {
+      vec2 simulated_position = cameras[0].cameraPosition;
+      if (!camera_valid || simulated_position != last_simulated_camera_position)
+        camera_position = simulated_position;
+      last_simulated_camera_position = simulated_position;
+      camera_valid = true;
+    }
+  }
+  if (!snapshot_drawn) return;
+  RenderSnapshot &snapshot = snapshots.front();
+  registry = &snapshot.registry;
+
+  // the snapshot is the state after its step, the frame lies between that
+  // step and the next one
+  float since_ms = std::chrono::duration<float, std::milli>(
+                       std::chrono::steady_clock::now() - snapshot.published)
+                       .count();
+  interpolation_alpha = clamp(since_ms / SIMULATION_STEP_MS, 0.f, 1.f);
+  draw_time_ms = snapshot.simulation_time_ms -
+                 (1.0 - interpolation_alpha) * SIMULATION_STEP_MS;
+
+  if (registry->camera.size() > 0) {
+    Camera &camera = registry->camera.components[0];
+    camera_position += clamp(camera.cameraTarget - camera_position, -10.0f,
+                             10.0f);  // max velocity to our camera
+    camera.cameraPosition = camera_position;
+  }
+
+  switch (snapshot.frame) {
+    case FRAME::WORLD:
+      drawWorld();
+      break;
+    case FRAME::TEXT_ONLY:
+      drawTextOnly(snapshot.background_color);
+      break;
+    case FRAME::TEXT_WITH_BACKGROUND:
+      drawTextWithBackground(snapshot.background,
+                             snapshot.background_position,
+                             snapshot.background_scale);
+      break;
+  }
+  drawText(snapshot.text);
+
+  glfwSwapBuffers(window);
+  gl_has_errors();
+}
+
+// Render our game world
+// http://www.opengl-tutorial.org/intermediate-tutorials/tutorial-14-render-to-texture/
+void RenderSystem::drawWorld() {
+  beginOffScreenPass();
 
   mat3 projection_2D = createProjectionMatrix();
 
+  // Static entities (backgrounds, board) come from the cached layer, which is
+  // only re-rendered when the camera or one of them changed
+  if (registry->staticLayers.size() > 0) {
+    if (staticLayerChanged()) renderStaticLayer(projection_2D);
+    drawStaticLayer();
+  }
+
   // Draw all textured meshes that have a position and size component but are
   // not ui elements
   for (Entity entity : registry->renderRequests.entities) {
-    if (!registry->transforms.has(entity) || registry->UIpasses.has(entity))
+    if (!registry->transforms.has(entity) || registry->UIpasses.has(entity) ||
+        registry->staticLayers.has(entity))
       continue;
     // Note, its not very efficient to access elements indirectly via the entity
     // albeit iterating through all Sprites in sequence. A good point to
@@ -327,40 +581,21 @@ void RenderSystem::draw() {
   // draw particle systems
   for (Entity entity : registry->particleSystems.entities) {
     ParticleSystem &ps = registry->particleSystems.get(entity);
-    if (ps.particles_alive.size() > 0) {
+    const ParticlePool &particles = ps.particles;
+    if (!particles.empty()) {
       // set shader
       const GLuint program =
           (GLuint)effects[(GLuint)EFFECT_ASSET_ID::TEXTURED_PARTICLE];
       glUseProgram(program);
 
-      const GLuint vbo = vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE];
-      const GLuint ibo = index_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE];
-
-      // Setting vertex and index buffers
-      glBindBuffer(GL_ARRAY_BUFFER, vbo);
-      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+      // the attribute layout lives in particle_vao, see
+      // initializeGlVertexArrays
+      glBindVertexArray(particle_vao);
       gl_has_errors();
 
-      GLint in_position_loc = glGetAttribLocation(program, "in_position");
-      GLint in_texcoord_loc = glGetAttribLocation(program, "in_texcoord");
-      gl_has_errors();
-      assert(in_texcoord_loc >= 0);
-
-      glEnableVertexAttribArray(in_position_loc);
-      glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE,
-                            sizeof(TexturedVertex), (void *)0);
-      gl_has_errors();
-
-      glEnableVertexAttribArray(in_texcoord_loc);
-      // note the stride to skip the preceeding vertex position
-      glVertexAttribPointer(in_texcoord_loc, 2, GL_FLOAT, GL_FALSE,
-                            sizeof(TexturedVertex), (void *)sizeof(vec3));
       // Enabling and binding texture to slot 0
       glActiveTexture(GL_TEXTURE0);
-      gl_has_errors();
-
       GLuint texture_id = texture_gl_handles[(GLuint)ps.texture];
-
       glBindTexture(GL_TEXTURE_2D, texture_id);
       gl_has_errors();
 
@@ -368,45 +603,20 @@ void RenderSystem::draw() {
       glUniformMatrix3fv(projection_loc, 1, GL_FALSE, (float *)&projection_2D);
       gl_has_errors();
 
-      // instance stuff
-      unsigned int instanceVBO;
-      glGenBuffers(1, &instanceVBO);
-      glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
-      glBufferData(GL_ARRAY_BUFFER,
-                   sizeof(glm::vec2) * ps.particles_alive.size(),
-                   &ps.particles_position[0], GL_STATIC_DRAW);
-      glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glEnableVertexAttribArray(2);
-      glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
-      glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float),
-                            (void *)0);
-      glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glVertexAttribDivisor(2, 1);
-
-      unsigned int instanceVBOsize;
-      glGenBuffers(1, &instanceVBOsize);
-      glBindBuffer(GL_ARRAY_BUFFER, instanceVBOsize);
-      glBufferData(GL_ARRAY_BUFFER, sizeof(float) * ps.particles_alive.size(),
-                   &ps.particles_size[0], GL_STATIC_DRAW);
-      glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glEnableVertexAttribArray(3);
-      glBindBuffer(GL_ARRAY_BUFFER, instanceVBOsize);
-      glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float),
-                            (void *)0);
+      // refill the instance buffers, orphaning last frame's storage
+      glBindBuffer(GL_ARRAY_BUFFER, particle_position_vbo);
+      glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec2) * particles.size(),
+                   particles.position.data(), GL_STREAM_DRAW);
+      glBindBuffer(GL_ARRAY_BUFFER, particle_size_vbo);
+      glBufferData(GL_ARRAY_BUFFER, sizeof(float) * particles.size(),
+                   particles.size_px.data(), GL_STREAM_DRAW);
       glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glVertexAttribDivisor(3, 1);
       gl_has_errors();
 
-      GLint size = 0;
-      glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+      glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 6, (GLsizei)particles.size());
       gl_has_errors();
 
-      GLsizei num_indices = size / sizeof(uint16_t);
-      (void)num_indices;
-
-      // glDrawElements(GL_TRIANGLES, num_indices, GL_UNSIGNED_SHORT, nullptr);
-      glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 6, ps.particles_alive.size());
-      gl_has_errors();
+      glBindVertexArray(vao);
     }
   }
 
@@ -431,35 +641,13 @@ void RenderSystem::draw() {
       continue;
     drawTexturedMesh(entity, projection_2D);
   }
-
-  for (auto text : text_render_array) {
-    _renderText(text.text_block, text.pos, text.scale, text.color,
-                text.font_type, text.line_space);
-  }
-  text_render_array.clear();
-
-  glfwSwapBuffers(window);
-  gl_has_errors();
 }
 
 mat3 RenderSystem::createProjectionMatrix() {
-  vec2 cameraTarget =
-      registry->camera.get(registry->camera.entities[0]).cameraTarget;
+  // the camera was eased towards its target in draw()
   vec2 cameraPosition =
       registry->camera.get(registry->camera.entities[0]).cameraPosition;
   vec2 cameraFOV = registry->camera.get(registry->camera.entities[0]).cameraFOV;
-  vec2 cameraMotion =
-      cameraTarget - cameraPosition;  // Get vector to target position
-  cameraMotion =
-      clamp(cameraMotion, -10.0f, 10.0f);  // max velocity to our camera
-
-  cameraPosition = cameraPosition + cameraMotion;
-  registry->camera.get(registry->camera.entities[0]).cameraPosition =
-      cameraPosition;
-
-  int w, h;
-  glfwGetFramebufferSize(window, &w, &h);
-  gl_has_errors();
   // Fake projection matrix, scales with respect to window coordinates
   // float aspectRatio = float(h) / float(w);
 
@@ -477,12 +665,14 @@ mat3 RenderSystem::createProjectionMatrix() {
   return {{sx, 0.f, 0.f}, {0.f, sy, 0.f}, {tx, ty, 1.f}};
 }
 
+void RenderSystem::clear_text() { text_render_array.clear(); }
+
 void RenderSystem::add_text_to_be_rendered(std::vector<std::string> text_block,
                                            glm::vec2 pos_percent, float scale,
                                            glm::vec3 color, FONTS font_type,
                                            float line_space) {
-  int w, h;
-  glfwGetFramebufferSize(window, &w, &h);
+  // called by the simulation thread, which may not ask GLFW
+  int w = framebuffer_width, h = framebuffer_height;
 
   assert(pos_percent.x > 0 && pos_percent.x < 1);
   assert(pos_percent.y > 0 && pos_percent.y < 1);
@@ -496,8 +686,8 @@ void RenderSystem::add_text_to_be_rendered(std::vector<std::string> text_block,
 void RenderSystem::add_text_block_to_be_rendered(
     const std::string text_block, const int LINE_LENGTH, glm::vec2 pos_percent,
     float scale, glm::vec3 color, FONTS font_type, float line_space) {
-  int w, h;
-  glfwGetFramebufferSize(window, &w, &h);
+  // called by the simulation thread, which may not ask GLFW
+  int w = framebuffer_width, h = framebuffer_height;
 
   assert(pos_percent.x > 0 && pos_percent.x < 1);
   assert(pos_percent.y > 0 && pos_percent.y < 1);
@@ -540,30 +730,16 @@ void RenderSystem::add_text_block_to_be_rendered(
 }
 
 void RenderSystem::render_text_only(glm::vec3 background_color) {
-  // Getting size of window
-  int w, h;
-  glfwGetFramebufferSize(window, &w, &h);
+  registry = simulated.get();
+  drawTextOnly(background_color);
+  drawText(text_render_array);
 
-  GLuint vao;
-  glGenVertexArrays(1, &vao);
-  glBindVertexArray(vao);
+  glfwSwapBuffers(window);
   gl_has_errors();
+}
 
-  // First render to the custom framebuffer
-  glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
-  gl_has_errors();
-  // Clearing backbuffer
-  glViewport(0, 0, w, h);
-  glDepthRange(0.00001, 10);
-  glClearColor(0, 0, 1, 1.0);
-  glClearDepth(1.f);
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-  glDisable(GL_DEPTH_TEST);  // native OpenGL does not work with a depth buffer
-                             // and alpha blending, one would have to sort
-                             // sprites back to front
-  gl_has_errors();
+void RenderSystem::drawTextOnly(glm::vec3 background_color) {
+  beginOffScreenPass();
 
   glClearColor(background_color.r, background_color.g, background_color.b,
                1.0f);
@@ -571,79 +747,28 @@ void RenderSystem::render_text_only(glm::vec3 background_color) {
 
   // Truly render to the screen
   drawToScreen();
-
-  for (auto text : text_render_array) {
-    _renderText(text.text_block, text.pos, text.scale, text.color,
-                text.font_type, text.line_space);
-  }
-  text_render_array.clear();
-
-  glfwSwapBuffers(window);
-  gl_has_errors();
 }
 
-void RenderSystem::render_text_with_background(TEXTURE_ASSET_ID bkg_id,
-                                               vec2 position, vec2 scale) {
-  auto background = Entity();
-  Mesh &mesh = getMesh(GEOMETRY_BUFFER_ID::SPRITE);
-  registry->meshPtrs.emplace(background, &mesh);
-
-  // Initialize the position, scale, and physics components
-  // Setting initial motion values
-  TransformComponent &transform = registry->transforms.emplace(background);
-  transform.position = position;
-  transform.rotation = 0.f;
-  transform.scale = scale;
-
-  // Create and (empty) Cat component to be able to refer to all cats
-  registry->renderRequests.insert(
-      background,
-      {bkg_id, EFFECT_ASSET_ID::TEXTURED, GEOMETRY_BUFFER_ID::SPRITE});
-
-  // Getting size of window
-
-  int w, h;
-  glfwGetFramebufferSize(window, &w, &h);
-
-  GLuint vao;
-  glGenVertexArrays(1, &vao);
-  glBindVertexArray(vao);
-  gl_has_errors();
-
-  // First render to the custom framebuffer
-  glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
-  gl_has_errors();
-  // Clearing backbuffer
-  glViewport(0, 0, w, h);
-  glDepthRange(0.00001, 10);
-  glClearColor(0, 0, 1, 1.0);
-  glClearDepth(1.f);
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-  glDisable(GL_DEPTH_TEST);  // native OpenGL does not work with a depth buffer
-                             // and alpha blending, one would have to sort
-                             // sprites back to front
-  gl_has_errors();
+void RenderSystem::drawTextWithBackground(TEXTURE_ASSET_ID bkg_id,
+                                          vec2 position, vec2 scale) {
+  beginOffScreenPass();
 
   mat3 projection_2D = createProjectionMatrix();
 
-  drawTexturedMesh(background, projection_2D);
-
-  registry->renderRequests.remove(background);
+  // the background is drawn directly, it does not need an entity
+  drawTexturedQuad(bkg_id, position, scale, projection_2D);
 
   // Truly render to the screen
   drawToScreen();
+}
 
-  for (auto text : text_render_array) {
-    _renderText(text.text_block, text.pos, text.scale, text.color,
-                text.font_type, text.line_space);
+void RenderSystem::drawText(const std::vector<Text2Display> &text) {
+  for (const Text2Display &block : text) {
+    _renderText(block.text_block, block.pos, block.scale, block.color,
+                block.font_type, block.line_space);
   }
-  text_render_array.clear();
-
-  glfwSwapBuffers(window);
-  gl_has_errors();
 }
+
 void RenderSystem::_renderText(std::vector<std::string> text_block,
                                glm::vec2 pos, float scale, glm::vec3 color,
                                FONTS font_type, float line_space) {
@@ -652,21 +777,8 @@ void RenderSystem::_renderText(std::vector<std::string> text_block,
   // Setting shaders
   glUseProgram(program);
 
-  GLint in_position_loc = glGetAttribLocation(program, "in_position");
-
-  // Generate vertex arrays and buffers
-  glGenVertexArrays(1, &VAO);
-  glGenBuffers(1, &VBO);
-
+  // the glyph quad buffer is created once, see initializeGlVertexArrays
   glBindVertexArray(VAO);
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-
-  glEnableVertexAttribArray(in_position_loc);
-  glVertexAttribPointer(in_position_loc, 4, GL_FLOAT, GL_FALSE,
-                        4 * sizeof(float), 0);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  // glBindVertexArray(0);
   gl_has_errors();
 
   glUniform3f(glGetUniformLocation(program, "fcolor"), color.x, color.y,
@@ -741,10 +853,8 @@ void RenderSystem::_renderText(std::vector<std::string> text_block,
     }
     pos_line_y -= max_vertical_height * (1.0 + line_space);
   }
-  // unbind the vertex array
-  glBindVertexArray(0);
+  // restore the vertex array used by the other render passes
+  glBindVertexArray(vao);
   glBindTexture(GL_TEXTURE_2D, 0);
-  glDeleteBuffers(1, &VBO);
-  glDeleteVertexArrays(1, &VAO);
   gl_has_errors();
 }
\ No newline at end of file
@@ -4,19 +4,49 @@
 #include <ft2build.h>
 
 #include <array>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <utility>
 
 #include "common.hpp"
 #include "components.hpp"
+#include "scene_io.hpp"
 #include "tiny_ecs.hpp"
 #include "tiny_ecs_registry.hpp"
+#include "triple_buffer.hpp"
 #include FT_FREETYPE_H
 
+// How a texture is stored and sampled. Compressed textures are read from
+// data/textures/compressed/<name>.dds (see tools/texture_compressor) and fall
+// back to the PNG when the file is missing.
+struct TextureSettings {
+  GLint min_filter;
+  GLint mag_filter;
+  GLint wrap;
+  bool mipmaps;     // prebuilt in the .dds or generated from the PNG
+  bool compressed;  // BC3, decoded at load if the driver lacks S3TC
+};
+// Single images drawn at many sizes
+const TextureSettings SPRITE_TEXTURE = {GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR,
+                                        GL_CLAMP_TO_EDGE, true, true};
+// Scrolled by the parallaxed shader past the texture borders
+const TextureSettings PARALLAX_TEXTURE = {GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR,
+                                          GL_REPEAT, true, true};
+// Sprite sheets: mips and 4x4 blocks would bleed between frames
+const TextureSettings ATLAS_TEXTURE = {GL_LINEAR, GL_LINEAR, GL_REPEAT, false,
+                                       false};
+
 // System responsible for setting up OpenGL and for rendering all the
-// visual entities in the game
-class RenderSystem {
+// visual entities in the game.
+//
+// The simulation and the drawing run on different threads. At the end of each
+// step the simulation thread publish()es a snapshot of what the renderer
+// draws: the render components, the text queue and which kind of frame to
+// draw. draw() runs on the thread owning the GL context and draws the newest
+// snapshot, so a slow GPU frame or a vsync wait never holds the simulation up
+// and the simulation never touches GL.
+class RenderSystem : public MeshLibrary {
   /**
    * The following arrays store the assets the game will use. They are loaded
    * at initialization and are assumed to not be modified by the render loop.
@@ -27,18 +57,6 @@ class RenderSystem {
   std::array<GLuint, texture_count> texture_gl_handles;
   std::array<ivec2, texture_count> texture_dimensions;
 
-  // Make sure these paths remain in sync with the associated enumerators.
-  // Associated id with .obj path
-  const std::vector<std::pair<GEOMETRY_BUFFER_ID, std::string>> mesh_paths = {
-      std::pair<GEOMETRY_BUFFER_ID, std::string>(GEOMETRY_BUFFER_ID::BOARD,
-                                                 mesh_path("board.obj")),
-      std::pair<GEOMETRY_BUFFER_ID, std::string>(GEOMETRY_BUFFER_ID::SALMON,
-                                                 mesh_path("salmon.obj")),
-      std::pair<GEOMETRY_BUFFER_ID, std::string>(GEOMETRY_BUFFER_ID::CLOUD,
-                                                 mesh_path("cloud_3d.obj"))
-      // specify meshes of other assets here
-  };
-
   // Make sure these paths remain in sync with the associated enumerators.
   const std::array<std::string, texture_count> texture_paths = {
       textures_path("space_blue.png"),
@@ -88,6 +106,55 @@ class RenderSystem {
       textures_path("water_bowl_empty.png"),
   };
 
+  // How each texture is stored and sampled, in the same order as
+  // texture_paths
+  const std::array<TextureSettings, texture_count> texture_settings = {
+      ATLAS_TEXTURE,     // SPACE_BLUE
+      ATLAS_TEXTURE,     // SPACE_RED
+      ATLAS_TEXTURE,     // SPACE_MUSHROOM
+      ATLAS_TEXTURE,     // SPACE_BOMB
+      ATLAS_TEXTURE,     // SPACE_SPRING
+      ATLAS_TEXTURE,     // SPACE_QUESTION
+      ATLAS_TEXTURE,     // SPACE_FORTUNE
+      ATLAS_TEXTURE,     // SPACE_DIRECTION
+      ATLAS_TEXTURE,     // DOGE
+      SPRITE_TEXTURE,    // HELP_MAINBOARD
+      ATLAS_TEXTURE,     // DICE
+      SPRITE_TEXTURE,    // BKGD_0
+      PARALLAX_TEXTURE,  // BKGD_1
+      ATLAS_TEXTURE,     // DIGITS_WHITE
+      ATLAS_TEXTURE,     // PLAYER_INFO
+      ATLAS_TEXTURE,     // RANKINGS
+      ATLAS_TEXTURE,     // ITEMS
+      ATLAS_TEXTURE,     // ITEMCARDS
+      ATLAS_TEXTURE,     // TEXT
+      SPRITE_TEXTURE,    // FISH
+      SPRITE_TEXTURE,    // ENEMY
+      SPRITE_TEXTURE,    // BLOCK
+      SPRITE_TEXTURE,    // BKGD_SHOWER
+      SPRITE_TEXTURE,    // BLOCK_1
+      SPRITE_TEXTURE,    // CAT
+      SPRITE_TEXTURE,    // FOOD
+      SPRITE_TEXTURE,    // PLAYER_DOGE
+      SPRITE_TEXTURE,    // BKGD_PLANIT
+      SPRITE_TEXTURE,    // BKGD_MAC
+      SPRITE_TEXTURE,    // ROCK_MAC
+      SPRITE_TEXTURE,    // PLANET_PLANIT
+      SPRITE_TEXTURE,    // ENERGY_PLANIT
+      SPRITE_TEXTURE,    // DOGE_ROCKET
+      SPRITE_TEXTURE,    // DOGE_MAC
+      SPRITE_TEXTURE,    // COIN
+      SPRITE_TEXTURE,    // BKGD_CONSTRAINED
+      SPRITE_TEXTURE,    // DOGE_CONSTRAINED
+      SPRITE_TEXTURE,    // BKGD_DAYCARE
+      SPRITE_TEXTURE,    // BKGD_GESTURE
+      SPRITE_TEXTURE,    // CHEW_TOYS
+      SPRITE_TEXTURE,    // FOOD_BOWL_FULL
+      SPRITE_TEXTURE,    // FOOD_BOWL_EMPTY
+      SPRITE_TEXTURE,    // WATER_BOWL_FULL
+      SPRITE_TEXTURE,    // WATER_BOWL_EMPTY
+  };
+
   std::array<GLuint, effect_count> effects;
   // Make sure these paths remain in sync with the associated enumerators.
   const std::array<std::string, effect_count> effect_paths = {
@@ -97,14 +164,13 @@ class RenderSystem {
       shader_path("animated"), shader_path("parallaxed"),
       shader_path("salmon"),   shader_path("water"),
       shader_path("text"),     shader_path("textured_particle"),
-      shader_path("cloud")};
+      shader_path("cloud"),    shader_path("static_layer")};
 
   std::array<GLuint, geometry_count> vertex_buffers;
   std::array<GLuint, geometry_count> index_buffers;
-  std::array<Mesh, geometry_count> meshes;
 
  public:
-  enum class FONTS { REGULAR, BOLD, ITALIC, LIGHT };
+  using FONTS = TextFont;
   // Initialize the window
   bool init(std::shared_ptr<ECSRegistry> registry, int width, int height,
             GLFWwindow *window);
@@ -114,24 +180,49 @@ class RenderSystem {
                      std::vector<uint16_t> indices);
 
   void initializeGlTextures();
+  // Upload one texture following texture_settings, returns the bytes it uses
+  // in video memory
+  size_t loadTexture(uint i);
 
   void initializeGlEffects();
 
   void initializeGlMeshes();
-  Mesh &getMesh(GEOMETRY_BUFFER_ID id) { return meshes[(int)id]; };
 
   void initializeGlGeometryBuffers();
+
+  // Create the vertex arrays reused every frame by text and particles
+  void initializeGlVertexArrays();
   // Initialize the screen texture used as intermediate render target
   // The draw loop first renders to this texture, then it is used for the water
   // shader
   bool initScreenTexture();
+  // Initialize the texture holding the cached static layer (see StaticLayer)
+  bool initStaticLayerTexture();
 
   // Destroy resources associated to one or all entities created by the system
   ~RenderSystem();
 
-  // Draw all entities
+  // What the next published snapshot shows, the world is the default. Called
+  // by the simulation thread.
+  void show_world();
+  void show_text_only(glm::vec3 background_color);
+  void show_text_with_background(TEXTURE_ASSET_ID bkg_id, vec2 position,
+                                 vec2 scale);
+
+  // Hands a copy of the render components of the registry and of the queued
+  // text to draw(), called by the simulation thread after each step
+  void publish();
+
+  // Draws the newest published snapshot, does nothing until the first one.
+  // Moving entities are drawn blended between their pose before the step of
+  // the snapshot and after it, by how far the frame is into the next step.
   void draw();
 
+  // Drops the queued text. The queue is kept across publishes so every
+  // snapshot shows the text of its simulation step, the scenes clear it when
+  // a step starts.
+  void clear_text();
+
   mat3 createProjectionMatrix();
 
   /**
@@ -167,29 +258,40 @@ class RenderSystem {
                                      float line_space);
 
   /**
-   * @brief Just render the text
+   * @brief Just render the text, right away and without a snapshot. Only for
+   * the loading screens of the scene inits, before the simulation thread runs.
    *
    * @param background_color
    */
   void render_text_only(glm::vec3 background_color);
 
-  /**
-   * @brief
-   *
-   * @param bkg_id
-   * @param position
-   * @param scale
-   */
-  void render_text_with_background(TEXTURE_ASSET_ID bkg_id, vec2 position,
-                                   vec2 scale);
-
  private:
+  // Draws of the kinds of frame a snapshot can show
+  void drawWorld();
+  void drawTextOnly(glm::vec3 background_color);
+  void drawTextWithBackground(TEXTURE_ASSET_ID bkg_id, vec2 position,
+                              vec2 scale);
+
   // Internal drawing functions for each entity type
   void drawTexturedMesh(Entity entity, const mat3 &projection);
   void drawToScreen();
 
-  // Window handle
-  GLFWwindow *window;
+  // Draw a textured sprite that is not part of the ECS (e.g. the background of
+  // the story screens)
+  void drawTexturedQuad(TEXTURE_ASSET_ID texture_id, vec2 position, vec2 scale,
+                        const mat3 &projection);
+
+  // Bind and clear the off screen frame buffer all render passes start with
+  void beginOffScreenPass();
+
+  // Static layer caching: entities flagged StaticLayer are rendered into
+  // static_layer_color, which is composited with a single screen triangle
+  bool staticLayerChanged();
+  void renderStaticLayer(const mat3 &projection);
+  void drawStaticLayer();
+
+  // Window handle, null until init
+  GLFWwindow *window = nullptr;
   float screen_scale;  // Screen to pixel coordinates scale factor (for apple
                        // retina display?)
 
@@ -198,10 +300,25 @@ class RenderSystem {
   GLuint off_screen_render_buffer_color;
   GLuint off_screen_render_buffer_depth;
 
+  // Static layer handles and the state it was last rendered with
+  GLuint static_layer_frame_buffer;
+  GLuint static_layer_color;
+  bool static_layer_valid = false;
+  vec2 static_layer_camera_position;
+  vec2 static_layer_camera_fov;
+  size_t static_layer_signature = 0;
+
   Entity screen_state_entity;
 
-  // holds the scene state
-  std::shared_ptr<ECSRegistry> registry;
+  // holds the scene state, written by the simulation thread
+  std::shared_ptr<ECSRegistry> simulated;
+
+  // the registry the draw functions read, the front snapshot's
+  ECSRegistry *registry = nullptr;
+
+  // framebuffer size, cached at init since only the main thread may ask GLFW
+  int framebuffer_width = 0;
+  int framebuffer_height = 0;
 
   // text related functions
   struct Character {
@@ -216,7 +333,12 @@ class RenderSystem {
   std::map<char, Character> italic_characters;
   std::map<char, Character> light_characters;
 
-  GLuint VAO, VBO;
+  // Vertex arrays and buffers, created once in init and reused every frame
+  GLuint vao;                // shared by all meshes and the screen triangle
+  GLuint VAO, VBO;           // text quads
+  GLuint particle_vao;       // instanced particles
+  GLuint particle_position_vbo;
+  GLuint particle_size_vbo;
 
   /**
    * @brief private text renderer that actually render the text
@@ -238,6 +360,43 @@ class RenderSystem {
     float line_space;
   };
   std::vector<Text2Display> text_render_array;
+  void drawText(const std::vector<Text2Display> &text);
+
+  enum class FRAME { WORLD, TEXT_ONLY, TEXT_WITH_BACKGROUND };
+
+  // Everything draw() needs from a simulation step
+  struct RenderSnapshot {
+    ECSRegistry registry;  // only the render components, see publish()
+    std::vector<Text2Display> text;
+    FRAME frame = FRAME::WORLD;
+    glm::vec3 background_color = {0, 0, 0};  // TEXT_ONLY
+    TEXTURE_ASSET_ID background = TEXTURE_ASSET_ID::BKGD_PLANIT;
+    vec2 background_position = {0, 0};  // TEXT_WITH_BACKGROUND
+    vec2 background_scale = {0, 0};
+    std::chrono::steady_clock::time_point published;
+    double simulation_time_ms = 0;  // at the end of the step
+  };
+  TripleBuffer<RenderSnapshot> snapshots;
+  bool snapshot_drawn = false;  // an acquired snapshot is in front
+
+  // the kind of frame of the next snapshot, see show_world()
+  FRAME frame = FRAME::WORLD;
+  glm::vec3 background_color = {0, 0, 0};
+  TEXTURE_ASSET_ID background = TEXTURE_ASSET_ID::BKGD_PLANIT;
+  vec2 background_position = {0, 0};
+  vec2 background_scale = {0, 0};
+
+  // The camera eases towards its target by at most 10 px per frame. The eased
+  // position is state of the draw thread; a snapshot only moves it when the
+  // simulation placed the camera somewhere else since the last one.
+  vec2 camera_position;
+  vec2 last_simulated_camera_position;
+  bool camera_valid = false;
+
+  // alpha of the current draw, see draw()
+  float interpolation_alpha = 1.f;
+  // simulation time the current draw shows, for the shader animations
+  double draw_time_ms = 0;
 };
 
 bool loadEffectFromFile(const std::string &vs_path, const std::string &fs_path,
@@ -6,18 +6,24 @@
 #include "../ext/stb_image/stb_image.h"
 #include "common.hpp"
 #include "render_system.hpp"
+#include "texture_codec.hpp"
 
 // This creates circular header inclusion, that is quite bad.
 #include "tiny_ecs_registry.hpp"
 
 // stlib
+#include <sys/stat.h>
+
 #include <iostream>
 #include <sstream>
 
 // World initialization
 bool RenderSystem::init(std::shared_ptr<ECSRegistry> registry, int width,
                         int height, GLFWwindow *window_arg) {
-  this->registry = registry;
+  // the loading screens of the inits draw the registry itself, see
+  // render_text_only
+  this->simulated = registry;
+  this->registry = registry.get();
   this->window = window_arg;
 
   glfwMakeContextCurrent(window);
@@ -37,6 +43,8 @@ bool RenderSystem::init(std::shared_ptr<ECSRegistry> registry, int width,
   // https://stackoverflow.com/questions/36672935/why-retina-screen-coordinate-value-is-twice-the-value-of-pixel-value
   int fb_width, fb_height;
   glfwGetFramebufferSize(window, &fb_width, &fb_height);
+  framebuffer_width = fb_width;
+  framebuffer_height = fb_height;
   screen_scale = static_cast<float>(fb_width) / width;
   (void)height;  // dummy to avoid warning
 
@@ -217,15 +225,13 @@ bool RenderSystem::init(std::shared_ptr<ECSRegistry> registry, int width,
   FT_Done_Face(light);
 
   FT_Done_FreeType(ft);
-  // ASK(Camilo): Setup error callback. This can not be done in mac os, so do
-  // not enable it unless you are on Linux or Windows. You will need to change
-  // the window creation code to use OpenGL 4.3 (not suported on mac) and add
-  // additional .h and .cpp glDebugMessageCallback((GLDEBUGPROC)errorCallback,
-  // nullptr);
+  // Route error checking through KHR_debug when the driver supports it, so
+  // gl_has_errors() does not have to stall the pipeline with glGetError
+  gl_init_debug_output();
 
   // We are not really using VAO's but without at least one bound we will crash
-  // in some systems.
-  GLuint vao;
+  // in some systems. It is kept for the lifetime of the renderer and bound at
+  // the start of every render pass
   glGenVertexArrays(1, &vao);
   glBindVertexArray(vao);
   gl_has_errors();
@@ -233,39 +239,117 @@ bool RenderSystem::init(std::shared_ptr<ECSRegistry> registry, int width,
   //registry->screenStates.emplace(screen_state_entity);
 
   initScreenTexture();
+  initStaticLayerTexture();
   initializeGlTextures();
   initializeGlEffects();
   initializeGlGeometryBuffers();
+  initializeGlVertexArrays();
 
   gl_has_errors();
   return true;
 }
 
+// data/textures/bkgd_0.png -> data/textures/compressed/bkgd_0.dds
+static std::string compressed_texture_path(const std::string &png_path) {
+  size_t slash = png_path.find_last_of('/');
+  size_t dot = png_path.find_last_of('.');
+  return png_path.substr(0, slash + 1) + "compressed/" +
+         png_path.substr(slash + 1, dot - slash - 1) + ".dds";
+}
+
+// The .dds files are only rebuilt with the compress_textures target, one
+// older than its PNG would show the art from before the PNG was edited
+static bool compressed_texture_is_stale(const std::string &png_path,
+                                        const std::string &dds_path) {
+  struct stat png, dds;
+  if (stat(png_path.c_str(), &png) != 0 || stat(dds_path.c_str(), &dds) != 0)
+    return false;
+  if (dds.st_mtime >= png.st_mtime) return false;
+  printf("%s is older than %s, loading the PNG. Build compress_textures to "
+         "update it\n",
+         dds_path.c_str(), png_path.c_str());
+  return true;
+}
+
 void RenderSystem::initializeGlTextures() {
-  
   glGenTextures((GLsizei)texture_gl_handles.size(), texture_gl_handles.data());
 
+  size_t vram_bytes = 0;
+  size_t rgba_bytes = 0;  // what every texture cost before compression and mips
   for (uint i = 0; i < texture_paths.size(); i++) {
-    const std::string &path = texture_paths[i];
-    ivec2 &dimensions = texture_dimensions[i];
+    vram_bytes += loadTexture(i);
+    rgba_bytes += (size_t)texture_dimensions[i].x * texture_dimensions[i].y * 4;
+  }
+  gl_has_errors();
 
-    stbi_uc *data;
-    data = stbi_load(path.c_str(), &dimensions.x, &dimensions.y, NULL, 4);
+  printf("Textures: %.1f MB in video memory, %.1f MB as plain RGBA (%.1f MB "
+         "saved)\n",
+         vram_bytes / 1048576.0, rgba_bytes / 1048576.0,
+         ((double)rgba_bytes - (double)vram_bytes) / 1048576.0);
+}
 
-    if (data == NULL) {
-      const std::string message = "Could not load the file " + path + ".";
-      fprintf(stderr, "%s", message.c_str());
-      assert(false);
+size_t RenderSystem::loadTexture(uint i) {
+  const TextureSettings &settings = texture_settings[i];
+  ivec2 &dimensions = texture_dimensions[i];
+
+  glBindTexture(GL_TEXTURE_2D, texture_gl_handles[i]);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, settings.mag_filter);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, settings.min_filter);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, settings.wrap);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, settings.wrap);
+
+  size_t bytes = 0;
+  std::vector<TextureLevel> levels;
+  const std::string dds_path = compressed_texture_path(texture_paths[i]);
+  if (settings.compressed &&
+      !compressed_texture_is_stale(texture_paths[i], dds_path) &&
+      read_dds_bc3(dds_path, levels)) {
+    // Drivers without S3TC (e.g. some Mesa builds) get the decoded mip chain
+    static const bool has_s3tc =
+        glfwExtensionSupported("GL_EXT_texture_compression_s3tc");
+    dimensions = {levels[0].width, levels[0].height};
+    if (!settings.mipmaps) levels.resize(1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL,
+                    (GLint)levels.size() - 1);
+
+    for (uint level = 0; level < levels.size(); level++) {
+      const TextureLevel &bc3 = levels[level];
+      if (has_s3tc) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, level,
+                               GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, bc3.width,
+                               bc3.height, 0, (GLsizei)bc3.data.size(),
+                               bc3.data.data());
+        bytes += bc3.data.size();
+      } else {
+        TextureLevel rgba = decompress_bc3(bc3);
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, rgba.width, rgba.height, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, rgba.data.data());
+        bytes += rgba.data.size();
+      }
     }
-    glBindTexture(GL_TEXTURE_2D, texture_gl_handles[i]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, dimensions.x, dimensions.y, 0,
-                 GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     gl_has_errors();
-    stbi_image_free(data);
+    return bytes;
+  }
+
+  const std::string &path = texture_paths[i];
+  stbi_uc *data;
+  data = stbi_load(path.c_str(), &dimensions.x, &dimensions.y, NULL, 4);
+
+  if (data == NULL) {
+    const std::string message = "Could not load the file " + path + ".";
+    fprintf(stderr, "%s", message.c_str());
+    assert(false);
+  }
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, dimensions.x, dimensions.y, 0,
+               GL_RGBA, GL_UNSIGNED_BYTE, data);
+  bytes = (size_t)dimensions.x * dimensions.y * 4;
+  if (settings.mipmaps) {
+    glGenerateMipmap(GL_TEXTURE_2D);
+    bytes = bytes * 4 / 3;
   }
   gl_has_errors();
+  stbi_image_free(data);
+  return bytes;
 }
 
 void RenderSystem::initializeGlEffects() {
@@ -296,14 +380,9 @@ void RenderSystem::bindVBOandIBO(GEOMETRY_BUFFER_ID gid,
 }
 
 void RenderSystem::initializeGlMeshes() {
+  loadMeshes();
   for (uint i = 0; i < mesh_paths.size(); i++) {
-    // Initialize meshes
     GEOMETRY_BUFFER_ID geom_index = mesh_paths[i].first;
-    std::string name = mesh_paths[i].second;
-    Mesh::loadFromOBJFile(name, meshes[(int)geom_index].vertices,
-                          meshes[(int)geom_index].vertex_indices,
-                          meshes[(int)geom_index].original_size);
-
     bindVBOandIBO(geom_index, meshes[(int)geom_index].vertices,
                   meshes[(int)geom_index].vertex_indices);
   }
@@ -400,7 +479,71 @@ void RenderSystem::initializeGlGeometryBuffers() {
                 screen_indices);
 }
 
+void RenderSystem::initializeGlVertexArrays() {
+  //////////////////////////
+  // Text: one dynamic quad that is updated for every glyph
+  const GLuint text_program = effects[(GLuint)EFFECT_ASSET_ID::TEXT];
+  GLint text_position_loc = glGetAttribLocation(text_program, "in_position");
+
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &VBO);
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+  glEnableVertexAttribArray(text_position_loc);
+  glVertexAttribPointer(text_position_loc, 4, GL_FLOAT, GL_FALSE,
+                        4 * sizeof(float), 0);
+  gl_has_errors();
+
+  //////////////////////////
+  // Particles: the sprite quad plus per instance position and size, the
+  // instance buffers are refilled every frame
+  const GLuint particle_program =
+      effects[(GLuint)EFFECT_ASSET_ID::TEXTURED_PARTICLE];
+  GLint in_position_loc = glGetAttribLocation(particle_program, "in_position");
+  GLint in_texcoord_loc = glGetAttribLocation(particle_program, "in_texcoord");
+  assert(in_texcoord_loc >= 0);
+
+  glGenVertexArrays(1, &particle_vao);
+  glGenBuffers(1, &particle_position_vbo);
+  glGenBuffers(1, &particle_size_vbo);
+  glBindVertexArray(particle_vao);
+
+  glBindBuffer(GL_ARRAY_BUFFER,
+               vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE]);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,
+               index_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE]);
+  glEnableVertexAttribArray(in_position_loc);
+  glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE,
+                        sizeof(TexturedVertex), (void *)0);
+  glEnableVertexAttribArray(in_texcoord_loc);
+  // note the stride to skip the preceeding vertex position
+  glVertexAttribPointer(in_texcoord_loc, 2, GL_FLOAT, GL_FALSE,
+                        sizeof(TexturedVertex), (void *)sizeof(vec3));
+  gl_has_errors();
+
+  glBindBuffer(GL_ARRAY_BUFFER, particle_position_vbo);
+  glEnableVertexAttribArray(2);
+  glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float),
+                        (void *)0);
+  glVertexAttribDivisor(2, 1);
+
+  // one float per particle, matching `in float size` in the shader
+  glBindBuffer(GL_ARRAY_BUFFER, particle_size_vbo);
+  glEnableVertexAttribArray(3);
+  glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void *)0);
+  glVertexAttribDivisor(3, 1);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  gl_has_errors();
+
+  glBindVertexArray(vao);
+  gl_has_errors();
+}
+
 RenderSystem::~RenderSystem() {
+  // nothing was created without a window, as in the headless tools
+  if (window == nullptr) return;
+
   // Don't need to free gl resources since they last for as long as the program,
   // but it's polite to clean after yourself.
   glDeleteBuffers((GLsizei)vertex_buffers.size(), vertex_buffers.data());
@@ -409,6 +552,13 @@ RenderSystem::~RenderSystem() {
                    texture_gl_handles.data());
   glDeleteTextures(1, &off_screen_render_buffer_color);
   glDeleteRenderbuffers(1, &off_screen_render_buffer_depth);
+  glDeleteTextures(1, &static_layer_color);
+  glDeleteBuffers(1, &VBO);
+  glDeleteBuffers(1, &particle_position_vbo);
+  glDeleteBuffers(1, &particle_size_vbo);
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteVertexArrays(1, &particle_vao);
+  glDeleteVertexArrays(1, &vao);
   gl_has_errors();
 
   for (uint i = 0; i < effect_count; i++) {
@@ -416,18 +566,19 @@ RenderSystem::~RenderSystem() {
   }
   // delete allocated resources
   glDeleteFramebuffers(1, &frame_buffer);
+  glDeleteFramebuffers(1, &static_layer_frame_buffer);
   gl_has_errors();
 
   // remove all entities created by the render system
 
-  while (registry->renderRequests.entities.size() > 0)
-    registry->remove_all_components_of(
-        registry->renderRequests.entities.back());
+  while (simulated->renderRequests.entities.size() > 0)
+    simulated->remove_all_components_of(
+        simulated->renderRequests.entities.back());
 }
 
 // Initialize the screen texture from a standard sprite
 bool RenderSystem::initScreenTexture() {
-  registry->screenStates.emplace(screen_state_entity);
+  simulated->screenStates.emplace(screen_state_entity);
 
   int width, height;
   glfwGetFramebufferSize(const_cast<GLFWwindow *>(window), &width, &height);
@@ -454,6 +605,35 @@ bool RenderSystem::initScreenTexture() {
   return true;
 }
 
+// Initialize the render target for the static layer. It has no depth buffer
+// since static entities are drawn in order with depth testing disabled
+bool RenderSystem::initStaticLayerTexture() {
+  int width, height;
+  glfwGetFramebufferSize(const_cast<GLFWwindow *>(window), &width, &height);
+
+  glGenFramebuffers(1, &static_layer_frame_buffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, static_layer_frame_buffer);
+  gl_has_errors();
+
+  glGenTextures(1, &static_layer_color);
+  glBindTexture(GL_TEXTURE_2D, static_layer_color);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA,
+               GL_UNSIGNED_BYTE, 0);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                       static_layer_color, 0);
+  gl_has_errors();
+
+  assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+  // the layer has to be rendered before its first use
+  static_layer_valid = false;
+
+  glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+  return true;
+}
+
 bool gl_compile_shader(GLuint shader) {
   glCompileShader(shader);
   gl_has_errors();
@@ -0,0 +1,196 @@
+#include "rope_solver.hpp"
+
+// stlib
+#include <assert.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <glm/geometric.hpp>  // length
+
+void RopeSolver::clear() {
+  x.clear();
+  y.clear();
+  previous_x.clear();
+  previous_y.clear();
+  inverse_mass.clear();
+  constraint_a.clear();
+  constraint_b.clear();
+  rest_length.clear();
+  compliance.clear();
+  lambda.clear();
+  batch_end.clear();
+  batches_dirty = false;
+  pin_particle.clear();
+  pin_x.clear();
+  pin_y.clear();
+}
+
+unsigned int RopeSolver::add_particle(glm::vec2 position, float mass) {
+  x.push_back(position.x);
+  y.push_back(position.y);
+  previous_x.push_back(position.x);
+  previous_y.push_back(position.y);
+  inverse_mass.push_back(mass > 0.f ? 1.f / mass : 0.f);
+  return (unsigned int)x.size() - 1;
+}
+
+void RopeSolver::add_distance(unsigned int a, unsigned int b,
+                              float rest_length, float compliance) {
+  assert(a < x.size() && b < x.size() && a != b);
+  constraint_a.push_back(a);
+  constraint_b.push_back(b);
+  this->rest_length.push_back(rest_length);
+  this->compliance.push_back(compliance);
+  lambda.push_back(0.f);
+  batches_dirty = true;
+}
+
+unsigned int RopeSolver::add_pin(unsigned int particle, glm::vec2 target) {
+  assert(particle < x.size());
+  // pinned particles are only moved by their pin
+  inverse_mass[particle] = 0.f;
+  pin_particle.push_back(particle);
+  pin_x.push_back(target.x);
+  pin_y.push_back(target.y);
+  return (unsigned int)pin_particle.size() - 1;
+}
+
+void RopeSolver::move_pin(unsigned int pin, glm::vec2 target) {
+  pin_x[pin] = target.x;
+  pin_y[pin] = target.y;
+}
+
+RopeSolver::Rope RopeSolver::add_rope(glm::vec2 start, glm::vec2 end,
+                                      int segments, float particle_mass,
+                                      float compliance, bool pin_start,
+                                      float rest_length) {
+  assert(segments > 0);
+  Rope rope;
+  rope.first_particle = (unsigned int)x.size();
+  rope.particle_count = segments + 1;
+  rope.first_pin = (unsigned int)pin_particle.size();
+
+  if (rest_length < 0) rest_length = glm::length(end - start) / segments;
+  for (int i = 0; i <= segments; i++) {
+    unsigned int particle =
+        add_particle(start + (end - start) * ((float)i / segments),
+                     particle_mass);
+    if (i > 0) add_distance(particle - 1, particle, rest_length, compliance);
+  }
+  if (pin_start) add_pin(rope.first_particle, start);
+  return rope;
+}
+
+void RopeSolver::set_position(unsigned int particle, glm::vec2 position) {
+  x[particle] = previous_x[particle] = position.x;
+  y[particle] = previous_y[particle] = position.y;
+}
+
+// Greedy coloring: each constraint goes to the first batch in which neither of
+// its particles is used yet. Chains need two batches, grids four.
+void RopeSolver::build_batches() {
+  const size_t count = constraint_a.size();
+  std::vector<uint32_t> particle_batches(x.size(), 0);  // bit per batch
+  std::vector<int> batch(count);
+  int batch_count = 0;
+  for (size_t i = 0; i < count; i++) {
+    uint32_t used =
+        particle_batches[constraint_a[i]] | particle_batches[constraint_b[i]];
+    int b = 0;
+    while (used & (1u << b)) b++;
+    assert(b < 32);
+    batch[i] = b;
+    particle_batches[constraint_a[i]] |= 1u << b;
+    particle_batches[constraint_b[i]] |= 1u << b;
+    batch_count = std::max(batch_count, b + 1);
+  }
+
+  // Stable sort of every array by batch
+  std::vector<unsigned int> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](unsigned int l, unsigned int r) {
+                     return batch[l] < batch[r];
+                   });
+  auto reorder = [&order](auto &values) {
+    auto sorted = values;
+    for (size_t i = 0; i < order.size(); i++) sorted[i] = values[order[i]];
+    values.swap(sorted);
+  };
+  reorder(constraint_a);
+  reorder(constraint_b);
+  reorder(rest_length);
+  reorder(compliance);
+  reorder(lambda);
+
+  batch_end.assign(batch_count, 0);
+  for (size_t i = 0; i < count; i++) batch_end[batch[order[i]]] = i + 1;
+  batches_dirty = false;
+}
+
+void RopeSolver::solve_batch(unsigned int begin, unsigned int end,
+                             float seconds) {
+  const float inverse_step_squared = 1.f / (seconds * seconds);
+  for (unsigned int i = begin; i < end; i++) {
+    const unsigned int a = constraint_a[i];
+    const unsigned int b = constraint_b[i];
+    const float dx = x[b] - x[a];
+    const float dy = y[b] - y[a];
+    const float length = std::max(std::sqrt(dx * dx + dy * dy), 1e-6f);
+    const float wa = inverse_mass[a];
+    const float wb = inverse_mass[b];
+
+    // XPBD: the compliance scaled by the step keeps the stiffness independent
+    // of the step and iteration count
+    const float alpha = compliance[i] * inverse_step_squared;
+    const float denominator = wa + wb + alpha;
+    const float c = length - rest_length[i];
+    const float delta_lambda =
+        denominator > 0.f ? (-c - alpha * lambda[i]) / denominator : 0.f;
+    lambda[i] += delta_lambda;
+
+    const float nx = dx / length * delta_lambda;
+    const float ny = dy / length * delta_lambda;
+    x[a] -= wa * nx;
+    y[a] -= wa * ny;
+    x[b] += wb * nx;
+    y[b] += wb * ny;
+  }
+}
+
+void RopeSolver::step(float seconds) {
+  if (seconds <= 0.f) return;
+  last_step_seconds = seconds;
+
+  // Verlet: the velocity is the distance covered in the last step
+  const size_t count = x.size();
+  const float keep = std::pow(damping, seconds);
+  const float gx = gravity.x * seconds * seconds;
+  const float gy = gravity.y * seconds * seconds;
+  for (size_t i = 0; i < count; i++) {
+    const float moves = inverse_mass[i] > 0.f ? 1.f : 0.f;
+    const float vx = (x[i] - previous_x[i]) * keep;
+    const float vy = (y[i] - previous_y[i]) * keep;
+    previous_x[i] = x[i];
+    previous_y[i] = y[i];
+    x[i] += (vx + gx) * moves;
+    y[i] += (vy + gy) * moves;
+  }
+  for (size_t p = 0; p < pin_particle.size(); p++) {
+    x[pin_particle[p]] = pin_x[p];
+    y[pin_particle[p]] = pin_y[p];
+  }
+
+  if (batches_dirty) build_batches();
+  std::fill(lambda.begin(), lambda.end(), 0.f);
+  for (int iteration = 0; iteration < iterations; iteration++) {
+    unsigned int begin = 0;
+    for (unsigned int end : batch_end) {
+      solve_batch(begin, end, seconds);
+      begin = end;
+    }
+  }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+// stlib
+#include <vector>
+
+// The glm library provides vector and matrix operations as in GLSL
+#include <glm/vec2.hpp>  // vec2
+
+// Position based rope and spring solver (XPBD over Verlet integration).
+//
+// Particles and constraints live in flat arrays, one per field, and scenes
+// describe their ropes as data: add the particles, link them with distance
+// constraints and pin the ends that hang from something. Every step moves the
+// particles by their implicit velocity and gravity, then relaxes all
+// constraints `iterations` times.
+//
+// Distance constraints are grouped into batches in which no two constraints
+// share a particle, the two halves of a rope alternate for instance. Inside a
+// batch the constraints do not depend on each other so the inner loop has no
+// carried dependency and can be vectorized.
+//
+// Like the broad phase, nothing in here touches the ECS or OpenGL.
+class RopeSolver {
+ public:
+  // A chain of particles created by add_rope
+  struct Rope {
+    unsigned int first_particle;
+    unsigned int particle_count;
+    unsigned int first_pin;  // pin of the start, if pin_start was set
+  };
+
+  // Relaxation passes over all constraints per step, more is stiffer
+  int iterations = 8;
+  // Acceleration in px/s^2 applied to every particle with a mass
+  glm::vec2 gravity = {0.f, 0.f};
+  // Fraction of the velocity kept per second, 1 keeps everything
+  float damping = 1.f;
+
+  // Removes all particles and constraints
+  void clear();
+
+  // mass <= 0 makes an immovable particle
+  unsigned int add_particle(glm::vec2 position, float mass = 1.f);
+
+  // Keeps a and b rest_length apart. compliance is the inverse stiffness in
+  // px/N, 0 is a rigid link and larger values make a softer spring.
+  void add_distance(unsigned int a, unsigned int b, float rest_length,
+                    float compliance = 0.f);
+
+  // Holds the particle at target until the pin is moved
+  unsigned int add_pin(unsigned int particle, glm::vec2 target);
+  void move_pin(unsigned int pin, glm::vec2 target);
+
+  // segments + 1 evenly spaced particles from start to end linked by distance
+  // constraints. rest_length < 0 uses the initial spacing.
+  Rope add_rope(glm::vec2 start, glm::vec2 end, int segments,
+                float particle_mass, float compliance, bool pin_start,
+                float rest_length = -1.f);
+
+  // Advances the simulation by seconds
+  void step(float seconds);
+
+  glm::vec2 position(unsigned int particle) const {
+    return {x[particle], y[particle]};
+  }
+  // Velocity implied by the last step, in px/s
+  glm::vec2 velocity(unsigned int particle) const {
+    return glm::vec2(x[particle] - previous_x[particle],
+                     y[particle] - previous_y[particle]) /
+           last_step_seconds;
+  }
+  void set_position(unsigned int particle, glm::vec2 position);
+
+  size_t particle_count() const { return x.size(); }
+  size_t constraint_count() const { return constraint_a.size(); }
+
+ private:
+  // particles
+  std::vector<float> x, y;
+  std::vector<float> previous_x, previous_y;
+  std::vector<float> inverse_mass;
+
+  // distance constraints, sorted by batch when the solver runs
+  std::vector<unsigned int> constraint_a, constraint_b;
+  std::vector<float> rest_length;
+  std::vector<float> compliance;
+  std::vector<float> lambda;  // accumulated impulse of the current step
+  std::vector<unsigned int> batch_end;  // one past the last of each batch
+  bool batches_dirty = false;
+
+  // pins
+  std::vector<unsigned int> pin_particle;
+  std::vector<float> pin_x, pin_y;
+
+  float last_step_seconds = 1.f;
+
+  void build_batches();
+  void solve_batch(unsigned int begin, unsigned int end, float seconds);
+};
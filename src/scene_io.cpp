@@ -0,0 +1,72 @@
+#include "scene_io.hpp"
+
+void FixedViewport::get_framebuffer_size(int *width, int *height) const {
+  *width = this->width;
+  *height = this->height;
+}
+
+void FixedViewport::get_window_size(int *width, int *height) const {
+  *width = this->width;
+  *height = this->height;
+}
+
+void MeshLibrary::loadMeshes() {
+  for (uint i = 0; i < mesh_paths.size(); i++) {
+    // Initialize meshes
+    GEOMETRY_BUFFER_ID geom_index = mesh_paths[i].first;
+    std::string name = mesh_paths[i].second;
+    Mesh::loadFromOBJFile(name, meshes[(int)geom_index].vertices,
+                          meshes[(int)geom_index].vertex_indices,
+                          meshes[(int)geom_index].original_size);
+    meshes[(int)geom_index].compute_bounds(true);
+  }
+}
+
+void SceneEvents::play(int channel, const Sound &sound, int loops) {
+  sounds.push_back({channel, sound, loops, false});
+}
+
+void SceneEvents::play_unless_playing(int channel, const Sound &sound,
+                                      int loops) {
+  sounds.push_back({channel, sound, loops, true});
+}
+
+void SceneEvents::set_title(const std::string &title) {
+  if (title == this->title) return;
+  this->title = title;
+  title_changed = true;
+}
+
+void SceneEvents::add_text(std::vector<std::string> text_block,
+                           glm::vec2 pos_percent, float scale,
+                           glm::vec3 color, TextFont font_type,
+                           float line_space) {
+  texts.push_back(
+      {std::move(text_block), pos_percent, scale, color, font_type,
+       line_space});
+}
+
+std::vector<SoundEvent> SceneEvents::take_sounds() {
+  std::vector<SoundEvent> taken;
+  taken.swap(sounds);
+  return taken;
+}
+
+std::vector<TextEvent> SceneEvents::take_texts() {
+  std::vector<TextEvent> taken;
+  taken.swap(texts);
+  return taken;
+}
+
+bool SceneEvents::take_title(std::string &title) {
+  if (!title_changed) return false;
+  title = this->title;
+  title_changed = false;
+  return true;
+}
+
+void SceneEvents::clear() {
+  sounds.clear();
+  texts.clear();
+  title_changed = false;
+}
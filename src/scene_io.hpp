@@ -0,0 +1,115 @@
+#pragma once
+
+// stlib
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+// internal
+#include "common.hpp"
+#include "components.hpp"
+#include "sound.hpp"
+
+// What the simulation needs from the platform and hands back to it. The world
+// systems only talk to these interfaces, so they build into the simulation
+// library without GL, GLFW or SDL and run the same in the game, the benchmarks
+// and the balance tools.
+
+// Size of the screen the scene is shown on
+class Viewport {
+ public:
+  virtual ~Viewport() = default;
+  virtual void get_framebuffer_size(int *width, int *height) const = 0;
+  virtual void get_window_size(int *width, int *height) const = 0;
+};
+
+// A screen of a fixed size, for the headless runs
+class FixedViewport : public Viewport {
+ public:
+  FixedViewport(int width, int height) : width(width), height(height) {}
+  void get_framebuffer_size(int *width, int *height) const override;
+  void get_window_size(int *width, int *height) const override;
+
+ private:
+  int width, height;
+};
+
+// The meshes of data/meshes, read from the OBJ files. The worlds size their
+// entities by them, the RenderSystem also uploads them.
+class MeshLibrary {
+ public:
+  virtual ~MeshLibrary() = default;
+
+  // Reads the meshes without uploading them, also usable without a window
+  void loadMeshes();
+  Mesh &getMesh(GEOMETRY_BUFFER_ID id) { return meshes[(int)id]; };
+
+ protected:
+  // Make sure these paths remain in sync with the associated enumerators.
+  // Associated id with .obj path
+  const std::vector<std::pair<GEOMETRY_BUFFER_ID, std::string>> mesh_paths = {
+      std::pair<GEOMETRY_BUFFER_ID, std::string>(GEOMETRY_BUFFER_ID::BOARD,
+                                                 mesh_path("board.obj")),
+      std::pair<GEOMETRY_BUFFER_ID, std::string>(GEOMETRY_BUFFER_ID::SALMON,
+                                                 mesh_path("salmon.obj")),
+      std::pair<GEOMETRY_BUFFER_ID, std::string>(GEOMETRY_BUFFER_ID::CLOUD,
+                                                 mesh_path("cloud_3d.obj"))
+      // specify meshes of other assets here
+  };
+
+  std::array<Mesh, geometry_count> meshes;
+};
+
+enum class TextFont { REGULAR, BOLD, ITALIC, LIGHT };
+
+struct SoundEvent {
+  int channel;
+  Sound sound;
+  int loops;
+  bool unless_playing;  // skipped while the channel still plays
+};
+
+// See RenderSystem::add_text_to_be_rendered
+struct TextEvent {
+  std::vector<std::string> text_block;
+  glm::vec2 pos_percent;
+  float scale;
+  glm::vec3 color;
+  TextFont font_type;
+  float line_space;
+};
+
+// The side effects of a simulation step on the audio, the UI text and the
+// window title. The worlds queue them while they step, the SceneManager hands
+// them to the AudioBank, the RenderSystem and the WindowManager after the
+// step, and the headless runs clear them.
+class SceneEvents {
+ public:
+  void play(int channel, const Sound &sound, int loops);
+  void play_unless_playing(int channel, const Sound &sound, int loops);
+
+  // Queued only when it differs from the last title set
+  void set_title(const std::string &title);
+
+  void add_text(std::vector<std::string> text_block, glm::vec2 pos_percent,
+                float scale, glm::vec3 color, TextFont font_type,
+                float line_space);
+
+  // Hand the queued events over, emptying the queues
+  std::vector<SoundEvent> take_sounds();
+  std::vector<TextEvent> take_texts();
+  // False when no new title was set since the last take
+  bool take_title(std::string &title);
+
+  // The last title set, to show it again when the scene comes back
+  const std::string &current_title() const { return title; }
+
+  void clear();
+
+ private:
+  std::vector<SoundEvent> sounds;
+  std::vector<TextEvent> texts;
+  std::string title;
+  bool title_changed = false;
+};
@@ -1,12 +1,18 @@
 #include "scene_manager.hpp"
 
+#include <algorithm>
 #include <iostream>
 
+#include "audio_bank.hpp"
+#include "job_system.hpp"
+#include "random_service.hpp"
+
 SceneManager::SceneManager() {
-  rng = std::default_random_engine(std::random_device()());
+  rng = random_service.engine("scene_manager");
 }
 
 SceneManager::~SceneManager() {
+  finish_preparing();
   board_scene = nullptr;
   switch_players_scene = nullptr;
   mac_scene = nullptr;
@@ -22,11 +28,11 @@ void SceneManager::init(std::shared_ptr<WindowManager> window_manager) {
   using namespace std::placeholders;
   // initialize input event handlers
   std::function<void(int, int, int)> scene_manager_on_key_callback_ptr =
-      std::bind(&SceneManager::on_key, this, _1, _2, _3);
+      std::bind(&SceneManager::on_window_key, this, _1, _2, _3);
   window_manager->set_on_key_callback(scene_manager_on_key_callback_ptr);
 
   std::function<void(glm::vec2)> scene_manager_on_mouse_move_callback_ptr =
-      std::bind(&SceneManager::on_mouse_move, this, _1);
+      std::bind(&SceneManager::on_window_mouse_move, this, _1);
   window_manager->set_on_mouse_move_callback(
       scene_manager_on_mouse_move_callback_ptr);
 
@@ -65,17 +71,128 @@ void SceneManager::init(std::shared_ptr<WindowManager> window_manager) {
 };
 
 void SceneManager::step_current_scene(float delta) {
-  current_scene->step(delta);
+  if (replaying) {
+    using namespace std::placeholders;
+    replay.play(step_count, std::bind(&SceneManager::on_key, this, _1, _2, _3),
+                std::bind(&SceneManager::on_mouse_move, this, _1));
+  } else {
+    handle_window_input();
+  }
+  pass_mouse_path();
+  // the step may end the scene and switch to another, the stepped one
+  // publishes
+  std::shared_ptr<Scene> scene = current_scene;
+  scene->step(delta);
+  // no job outlives the step that submitted it
+  job_system.wait_frame();
+  apply_scene_events(*scene);
+  simulation_time_ms += delta;
+  // the switch players screen picked the next mini game in its step
+  if (current_scene == switch_players_scene) prepare_next_mini_game();
+  // replays are not drawn
+  if (!replaying) {
+    scene->publish();
+    drawn_scene = scene.get();
+  }
+  step_count++;
+};
+
+void SceneManager::apply_scene_events(Scene &scene) {
+  SceneEvents &events = scene.scene_events();
+  for (const SoundEvent &sound : events.take_sounds()) {
+    if (sound.unless_playing && audio_bank.playing(sound.channel)) continue;
+    audio_bank.play(sound.channel, sound.sound, sound.loops);
+  }
+
+  std::string title;
+  bool new_title = events.take_title(title);
+  // a scene coming back shows its title again, even if it did not change
+  if (&scene != titled_scene) {
+    title = events.current_title();
+    new_title = !title.empty();
+    titled_scene = &scene;
+  }
+  if (new_title) window_manager->set_title(title);
+}
+
+void SceneManager::draw_current_scene() {
+  if (toggle_gl_error_checking.exchange(false))
+    gl_set_error_checking(!gl_error_state.enabled);
+  Scene *scene = drawn_scene;
+  if (scene) scene->draw();
 };
 
+bool SceneManager::record_input(const std::string &path) {
+  assert(random_service.is_deterministic() && !replaying);
+  return recorder.start(path, random_service.run_seed());
+}
+
+void SceneManager::replay_input(const InputReplay &replay) {
+  assert(random_service.is_deterministic() &&
+         random_service.run_seed() == replay.seed());
+  this->replay = replay;
+  replaying = true;
+}
+
+void SceneManager::finish_run() {
+  if (replaying) {
+    // events that came after the last step, like the key that quit the game
+    using namespace std::placeholders;
+    replay.play(step_count, std::bind(&SceneManager::on_key, this, _1, _2, _3),
+                std::bind(&SceneManager::on_mouse_move, this, _1));
+    pass_mouse_path();
+  }
+  recorder.finish(step_count);
+  printf("%u steps simulated, state hash %016llx\n", step_count,
+         (unsigned long long)current_scene->state_hash());
+}
+
+void SceneManager::on_window_key(int key, int action, int mod) {
+  if (replaying) return;
+  input_queue.push_key(key, action, mod);
+}
+
+void SceneManager::on_window_mouse_move(vec2 pos) {
+  if (replaying) return;
+  input_queue.push_mouse_move(pos);
+}
+
+void SceneManager::handle_window_input() {
+  auto now = std::chrono::steady_clock::now();
+  WindowInputEvent event;
+  // recorded with the step they are passed on before, like a replay does
+  while (input_queue.pop(event)) {
+    input_latency_ms = std::max(
+        input_latency_ms,
+        std::chrono::duration<float, std::milli>(now - event.time).count());
+    if (event.type == InputEventType::KEY) {
+      recorder.key(step_count, event.key, event.action, event.mods);
+      on_key(event.key, event.action, event.mods);
+    } else {
+      recorder.mouse_move(step_count, event.position);
+      on_mouse_move(event.position);
+    }
+  }
+}
+
+float SceneManager::take_input_latency_ms() {
+  float latency = input_latency_ms;
+  input_latency_ms = 0;
+  return latency;
+}
+
 void SceneManager::on_key(int key, int action, int mod) {
+  // the cursor moves that came before the key go first
+  pass_mouse_path();
+
   // Debugging
   if (key == GLFW_KEY_D) {
     if (action == GLFW_RELEASE) {
       debugging.in_debug_mode = !debugging.in_debug_mode;
       if (debugging.in_debug_mode) {
         printf(
-            "In Debug Mode: 1-9 for mini game, 0 to main board, r for reset\n");
+            "In Debug Mode: 1-9 for mini game, 0 to main board, r for reset, "
+            "g to toggle OpenGL error checking\n");
       }
     }
   }
@@ -111,6 +228,9 @@ void SceneManager::on_key(int key, int action, int mod) {
       current_mini_game = board_scene;
       current_scene = current_mini_game;
     }
+    if (key == GLFW_KEY_G && action == GLFW_RELEASE) {
+      toggle_gl_error_checking = true;
+    }
   }
 
   // Resetting game
@@ -127,9 +247,16 @@ void SceneManager::on_key(int key, int action, int mod) {
 };
 
 void SceneManager::on_mouse_move(vec2 pos) {
-  current_scene->on_mouse_move(pos);
+  // GLFW may report the same position again
+  if (mouse_path.empty() || mouse_path.back() != pos) mouse_path.push_back(pos);
 };
 
+void SceneManager::pass_mouse_path() {
+  if (mouse_path.empty()) return;
+  current_scene->on_mouse_path(mouse_path);
+  mouse_path.clear();
+}
+
 bool SceneManager::is_quit_game() { return quit_game; }
 
 void SceneManager::on_board_end(BoardRegistry registry) {
@@ -141,32 +268,48 @@ void SceneManager::on_board_end(BoardRegistry registry) {
   current_mini_game = nullptr;
 };
 
+std::shared_ptr<Scene> SceneManager::mini_game_of(GameMode mode) {
+  switch (mode) {
+    case GameMode::MAC_GAME:
+      return mac_scene;
+    case GameMode::SHOWER_GAME:
+      return shower_scene;
+    case GameMode::PLANIT_GAME:
+      return planit_scene;
+    case GameMode::CONSTRAINED_CHAOS_GAME:
+      return constrained_physics_scene;
+    case GameMode::DAYCARE_GAME:
+      return daycare_scene;
+    default:
+      assert(false);
+      return nullptr;
+  }
+}
+
+void SceneManager::prepare_next_mini_game() {
+  Scene *next = mini_game_of(switch_players_scene->get_next_game_mode()).get();
+  if (next == prepared_scene) return;
+  finish_preparing();
+  prepared_scene = next;
+  preparing = std::thread([next]() { next->prepare(); });
+}
+
+void SceneManager::finish_preparing() {
+  if (preparing.joinable()) preparing.join();
+}
+
 void SceneManager::on_switch_players_end() {
   if (current_mini_game == nullptr) {
     // I don't think this ever runs for some reason.
-    switch (switch_players_scene->get_next_game_mode()) {
-      case GameMode::MAC_GAME:
-        current_mini_game = mac_scene;
-        break;
-      case GameMode::SHOWER_GAME:
-        current_mini_game = shower_scene;
-        break;
-      case GameMode::PLANIT_GAME:
-        current_mini_game = planit_scene;
-        break;
-      case GameMode::CONSTRAINED_CHAOS_GAME:
-        current_mini_game = constrained_physics_scene;
-        break;
-      case GameMode::DAYCARE_GAME:
-        current_mini_game = daycare_scene;
-        break;
-      default:
-        assert(false);
-        break;
-    }
+    current_mini_game =
+        mini_game_of(switch_players_scene->get_next_game_mode());
     switch_players_scene->reset_scene();
   }
 
+  // the mini game was prepared while the switch players screen showed, the
+  // reset swaps its entities in
+  finish_preparing();
+  prepared_scene = nullptr;
   current_mini_game->reset_scene();
   current_scene = current_mini_game;
 }
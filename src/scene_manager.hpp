@@ -10,8 +10,11 @@
  */
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <random>
+#include <thread>
+#include <vector>
 
 #include "./scenes/ConstrainedPhysics/scene.hpp"
 #include "./scenes/board/registry.hpp"
@@ -27,6 +30,8 @@
 #include "./scenes/shower/scene.hpp"
 #include "./scenes/switch/scene.hpp"
 #include "common.hpp"
+#include "input_queue.hpp"
+#include "input_recorder.hpp"
 #include "window_manager.hpp"
 
 class SceneManager {
@@ -37,10 +42,41 @@ class SceneManager {
 
   void init(std::shared_ptr<WindowManager> window_manager);
 
+  // Steps the current scene and publishes what it shows. The simulation
+  // thread calls it, the window input that came in since the last step is
+  // passed to the scene first.
   void step_current_scene(float delta);
 
+  // Draws the newest step published, on the main thread, see Scene::draw
+  void draw_current_scene();
+
   bool is_quit_game();
 
+  // Deterministic runs, see InputRecorder. Both need random_service to be
+  // seeded before the scenes are created. While replaying, the input of the
+  // window is ignored and the recorded events are fed before each step.
+  bool record_input(const std::string &path);
+  void replay_input(const InputReplay &replay);
+  bool is_replaying() const { return replaying; }
+  bool replay_finished() const {
+    return replaying && replay.finished(step_count);
+  }
+
+  // Closes the recording and prints the number of steps and the state hash
+  // of the current scene, a replay of the run should print the same
+  void finish_run();
+
+  uint32_t steps_simulated() const { return step_count; }
+
+  // Longest time an event of the window waited for its step, and events the
+  // input queue dropped, since the last call
+  float take_input_latency_ms();
+  unsigned int take_dropped_input() { return input_queue.take_dropped(); }
+
+  // Bodies awake and asleep in the last step of the current scene, read on
+  // the simulation thread between steps
+  SleepStats sleep_stats() { return current_scene->sleep_stats(); }
+
   int rounds_left = 10;
 
  private:
@@ -60,10 +96,50 @@ class SceneManager {
 
   int num_players = 0;
   int players_played = 0;
-  bool quit_game = false;
+  std::atomic<bool> quit_game{false};
+
+  // scene of the last step published, drawn by the main thread
+  std::atomic<Scene *> drawn_scene{nullptr};
+  // scene whose title the window shows
+  Scene *titled_scene = nullptr;
+  // the G debug key, OpenGL is only touched by the main thread
+  std::atomic<bool> toggle_gl_error_checking{false};
+
+  // input of the window waiting for the next step, the window callbacks run
+  // on the main thread
+  InputQueue input_queue;
+  float input_latency_ms = 0;
+  // cursor positions of this step not passed to the scene yet
+  std::vector<vec2> mouse_path;
+
+  uint32_t step_count = 0;
+  InputRecorder recorder;
+  InputReplay replay;
+  bool replaying = false;
+
+  // input of the window, queued for the next step unless replaying
+  void on_window_key(int key, int action, int mod);
+  void on_window_mouse_move(vec2 pos);
+  // records the queued input and passes it on
+  void handle_window_input();
+
+  // Plays the sounds a step queued and sets its title, see SceneEvents
+  void apply_scene_events(Scene &scene);
+
+  // The mini game the switch players screen leads to is prepared while the
+  // screen shows, see Scene::prepare, and only swapped in when it starts
+  std::thread preparing;
+  Scene *prepared_scene = nullptr;
+  std::shared_ptr<Scene> mini_game_of(GameMode mode);
+  void prepare_next_mini_game();
+  // waits for the preparation running, if any
+  void finish_preparing();
 
+  // The cursor positions are collected and passed to the scene together,
+  // when a key comes or the input of the step is done, see Scene::on_mouse_path
   void on_key(int key, int action, int mod);
   void on_mouse_move(vec2 pos);
+  void pass_mouse_path();
 
   void on_board_end(BoardRegistry registry);
   void on_switch_players_end();
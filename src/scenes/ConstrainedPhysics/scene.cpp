@@ -32,13 +32,18 @@ void ConstrainedPhysicsScene::init(
 
   registry->clear_all_components();
 
-  int window_width, window_height;
-  glfwGetFramebufferSize(window_manager->get_window(), &window_width,
-                         &window_height);
+  window_manager->get_framebuffer_size(&window_width, &window_height);
   assert(renderer->init(registry, window_width, window_height,
                         window_manager->get_window()));
   world->init(registry, renderer, physics, window_manager, [&]() { end(); });
   physics->init(registry);
+  systems.clear();
+  systems.add_exclusive("world", [this](float delta) { world->step(delta); });
+  systems.add_exclusive("physics", [this](float delta) {
+    physics->step(delta, window_width, window_height);
+  });
+  systems.add("sprite animation", {}, {&registry->spriteAnimations},
+              [this](float delta) { world->handle_sprite_animation(delta); });
 
   renderer->add_text_to_be_rendered({"Loading Game ...."}, vec2(0.38, 0.45), 1,
                                     vec3(1, 0.9, 0),
@@ -47,26 +52,32 @@ void ConstrainedPhysicsScene::init(
   ScreenState &screen = registry->screenStates.components[0];
   screen.screen_brightness = 0.8;
   renderer->render_text_only(vec3(0.133, 0.224, 0.722));
+  renderer->clear_text();
   screen.screen_brightness = 1.0;
 }
 
 bool ConstrainedPhysicsScene::step(float delta) {
-  int window_width, window_height;
-  glfwGetFramebufferSize(window_manager->get_window(), &window_width,
-                         &window_height);
+  // keep the poses before this step for interpolation, and only this step's
+  // text
+  registry->snapshot_transforms();
+  renderer->clear_text();
 
-  // step forward systems
-  world->step(delta);
-  physics->step(delta, window_width, window_height);
-  world->handle_sprite_animation(delta);
+  window_manager->get_framebuffer_size(&window_width, &window_height);
 
-  renderer->draw();
+  // step forward systems
+  systems.step(delta);
 
   return true;
 }
 
+void ConstrainedPhysicsScene::publish() { renderer->publish(); }
+
+void ConstrainedPhysicsScene::draw() { renderer->draw(); }
+
 void ConstrainedPhysicsScene::reset_scene() { world->restart_game(); }
 
+void ConstrainedPhysicsScene::prepare() { world->prepare_round(); }
+
 void ConstrainedPhysicsScene::on_key(int key, int action, int mod) {
   world->on_key(key, action, mod);
 }
@@ -75,4 +86,12 @@ void ConstrainedPhysicsScene::on_mouse_move(vec2 pos) {
   world->on_mouse_move(pos);
 }
 
+uint64_t ConstrainedPhysicsScene::state_hash() {
+  return registry->state_hash();
+}
+
+SleepStats ConstrainedPhysicsScene::sleep_stats() {
+  return physics->sleep_stats();
+}
+
 void ConstrainedPhysicsScene::end() { on_scene_end_callback_ptr(*registry); }
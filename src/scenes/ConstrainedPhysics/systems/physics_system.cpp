@@ -1,10 +1,12 @@
 // internal
 #include "physics_system.hpp"
 
+#include "body_sleep.hpp"
 #include "world_init.hpp"
 
 void ConstrainedPhysicsSystem::init(std::shared_ptr<ConstrainedPhysicsRegistry> registry) {
   this->registry = registry;
+  broad_phase.set_job_system(&job_system);
 }
 
 vec2 ConstrainedPhysicsSystem::get_bounding_box(
@@ -13,47 +15,48 @@ vec2 ConstrainedPhysicsSystem::get_bounding_box(
   return {abs(transform.scale.x), abs(transform.scale.y)};
 }
 
-bool ConstrainedPhysicsSystem::collides(Entity e1, Entity e2) {
-
-    if ((registry->players.has(e1) && !registry->ropes.has(e2)) || (registry->players.has(e2) && !registry->ropes.has(e1))) {
-    TransformComponent& transform1 = registry->transforms.get(e1);
-      TransformComponent& transform2 = registry->transforms.get(e2);
-      float dist = sqrt(pow(transform1.position.x - transform2.position.x, 2) + pow(transform1.position.y - transform2.position.y, 2));
-      if (dist < 50) {
-        return true;
-      }
-    }
-    return false;
-}
-
 void ConstrainedPhysicsSystem::step(float elapsed_ms, float window_width_px,
                                  float window_height_px) {
+  last_sleep_stats = update_sleeping_bodies(*registry);
+
   auto& velocity_registry = registry->velocities;
   for (uint i = 0; i < velocity_registry.size(); i++) {
     Velocity& velocity = velocity_registry.components[i];
     Entity entity = velocity_registry.entities[i];
+    if (is_asleep(*registry, entity)) continue;
     TransformComponent& transform = registry->transforms.get(entity);
     float step_seconds = 1.0f * (elapsed_ms / 1000.f);
     transform.position += velocity.velocity * step_seconds;
   }
 
-  // Check for collisions between all moving entities
-  ComponentContainer<TransformComponent>& transform_container =
-      registry->transforms;
-  for (uint i = 0; i < transform_container.components.size(); i++) {
-    TransformComponent& transform_i = transform_container.components[i];
-    Entity entity_i = transform_container.entities[i];
-    for (uint j = 0; j < transform_container.components.size(); j++)  // i+1
-    {
-      if (i == j) continue;
-
-      TransformComponent& transform_j = transform_container.components[j];
-      Entity entity_j = transform_container.entities[j];
-      if (registry->players.has(entity_i) || registry->players.has(entity_j)) {
-        if (collides(entity_i, entity_j)) {
-          registry->collisions.emplace_with_duplicates(entity_i, entity_j);
-        }
-      }
+  // Check for collisions between the entities with a CollisionFilter, players
+  // and balls are circles of radius 25 so they touch when the centers are
+  // closer than 50
+  ComponentContainer<CollisionFilter>& filter_container =
+      registry->collisionFilters;
+  broad_phase.clear();
+  bodies.clear();
+  for (uint i = 0; i < filter_container.components.size(); i++) {
+    const CollisionFilter& filter = filter_container.components[i];
+    const vec2& position =
+        registry->transforms.get(filter_container.entities[i]).position;
+    broad_phase.insert(i, position, {25, 25}, filter.category, filter.mask);
+    bodies.add(position, 25);
+  }
+  candidates.clear();
+  broad_phase.find_pairs(candidates);
+  drop_sleeping_pairs(*registry, filter_container.entities, candidates);
+  contacts.clear();
+  circle_pairs(bodies, candidates, CircleContact::SUM_OF_RADII, contacts);
+  wake_contacts(*registry, filter_container.entities, contacts);
+  for (const BroadPhasePair& contact : contacts) {
+    Entity entity_i = filter_container.entities[contact.a];
+    Entity entity_j = filter_container.entities[contact.b];
+    // the world system reacts to the player's entry
+    if (filter_container.components[contact.b].category & COLLISION_PLAYER) {
+      registry->collisions.emplace_with_duplicates(entity_j, entity_i);
+    } else {
+      registry->collisions.emplace_with_duplicates(entity_i, entity_j);
     }
   }
-}
\ No newline at end of file
+}
@@ -16,8 +16,6 @@ Entity createLine(std::shared_ptr<ConstrainedPhysicsRegistry> registry, vec2 pos
   transform.position = position;
   transform.scale = scale;
 
-  Velocity& vel = registry->velocities.emplace(entity);
-
   registry->debugComponents.emplace(entity);
   return entity;
 }
@@ -49,7 +47,7 @@ Entity createRope(std::shared_ptr<ConstrainedPhysicsRegistry> registry, vec2 a,
 }
 
 Entity createPlayer(std::shared_ptr<ConstrainedPhysicsRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer, vec2 pos) {
+                    std::shared_ptr<MeshLibrary> meshes, vec2 pos) {
   auto entity = Entity();
   //std::default_random_engine rng;
   //std::uniform_real_distribution<float> uniform_dist;
@@ -57,7 +55,7 @@ Entity createPlayer(std::shared_ptr<ConstrainedPhysicsRegistry> registry,
   //float screen_height = 800;
 
   // Store a reference to the potentially re-used mesh object
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Setting initial motion values
@@ -74,6 +72,8 @@ Entity createPlayer(std::shared_ptr<ConstrainedPhysicsRegistry> registry,
   registry->colors.insert(entity, {1.0,1.0,1.0});
 
   registry->players.emplace(entity);
+  registry->collisionFilters.insert(entity,
+                                    {COLLISION_PLAYER, COLLISION_OBSTACLE});
   registry->renderRequests.insert(
       entity,
       {TEXTURE_ASSET_ID::DOGE_CONSTRAINED,
@@ -84,10 +84,10 @@ Entity createPlayer(std::shared_ptr<ConstrainedPhysicsRegistry> registry,
 }
 
 Entity createBackground(std::shared_ptr<ConstrainedPhysicsRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer,
+                    std::shared_ptr<MeshLibrary> meshes,
                     vec2 position) {
   auto entity = Entity();
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Initialize the position, scale, and physics components
@@ -103,5 +103,8 @@ Entity createBackground(std::shared_ptr<ConstrainedPhysicsRegistry> registry,
       entity, {TEXTURE_ASSET_ID::BKGD_CONSTRAINED, EFFECT_ASSET_ID::TEXTURED,
                GEOMETRY_BUFFER_ID::SPRITE});
 
+  // the background never moves, draw it from the cached static layer
+  registry->staticLayers.emplace(entity);
+
   return entity;
 }
\ No newline at end of file
@@ -5,7 +5,7 @@
 
 #include "../registry.hpp"
 #include "common.hpp"
-#include "render_system.hpp"
+#include "scene_io.hpp"
 #include "tiny_ecs.hpp"
 
 // a red line for debugging purposes
@@ -14,11 +14,11 @@ Entity createLine(std::shared_ptr<ConstrainedPhysicsRegistry> registry, vec2 pos
 
 // the player
 Entity createPlayer(std::shared_ptr<ConstrainedPhysicsRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer, vec2 pos);
+                    std::shared_ptr<MeshLibrary> meshes, vec2 pos);
 
 Entity createRope(std::shared_ptr<ConstrainedPhysicsRegistry> registry,
                     vec2 a, vec2 b);
 
 Entity createBackground(std::shared_ptr<ConstrainedPhysicsRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer,
+                    std::shared_ptr<MeshLibrary> meshes,
                     vec2 position);
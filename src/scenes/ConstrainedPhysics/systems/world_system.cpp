@@ -13,15 +13,33 @@
 #include <string>
 
 #include "physics_system.hpp"
-#include "window_manager.hpp"
+#include "random_service.hpp"
 
 #define PI 3.14159265
 
 // Game configuration
 
+// Springs pinned to the center of the screen and reaching to end (fraction of
+// the screen size) through SPRING_SEGMENTS links. They are pulled towards
+// SPRING_REST_LENGTH so they swing back and forth through the center.
+// Stiffness is per unit mass in 1/s^2, the old per spring handlers applied
+// ks * 0.001 per 60 Hz frame, that is ks * 0.06 per second.
+struct SpringDescription {
+  vec2 end;
+  float stiffness;
+};
+const SpringDescription SPRINGS[] = {
+    {{0.5f, 1.f}, 6.f},   // vertical
+    {{1.f, 0.5f}, 6.9f},  // horizontal
+    {{1.f, 1.f}, 7.8f},   // diagonal down
+    {{1.f, 0.f}, 8.7f},   // diagonal up
+};
+const int SPRING_SEGMENTS = 2;
+const float SPRING_REST_LENGTH = 1.f;
+
 ConstrainedPhysicsWorldSystem::ConstrainedPhysicsWorldSystem() {
-  // Seeding rng with random device
-  rng = std::default_random_engine(std::random_device()());
+  // Seeding rng, from the run seed in a deterministic run
+  rng = random_service.engine("constrained_physics");
 }
 
 ConstrainedPhysicsWorldSystem::~ConstrainedPhysicsWorldSystem() {
@@ -29,22 +47,22 @@ ConstrainedPhysicsWorldSystem::~ConstrainedPhysicsWorldSystem() {
   registry->clear_all_components();
 
   // clean up all the shared pointers
-  renderer = nullptr;
+  meshes = nullptr;
   registry = nullptr;
   physics = nullptr;
-  window_manager = nullptr;
+  viewport = nullptr;
 }
 
 void ConstrainedPhysicsWorldSystem::init(
     std::shared_ptr<ConstrainedPhysicsRegistry> registry,
-    std::shared_ptr<RenderSystem> renderer,
+    std::shared_ptr<MeshLibrary> meshes,
     std::shared_ptr<ConstrainedPhysicsSystem> physics,
-    std::shared_ptr<WindowManager> window_manager,
+    std::shared_ptr<Viewport> viewport,
     std::function<void()> on_scene_end) {
   this->registry = registry;
-  this->renderer = renderer;
+  this->meshes = meshes;
   this->physics = physics;
-  this->window_manager = window_manager;
+  this->viewport = viewport;
   this->on_game_end_callback_ptr = on_scene_end;
 
   // Set all states to default
@@ -56,222 +74,24 @@ void ConstrainedPhysicsWorldSystem::recalculateAngle(Entity e, vec2 a, vec2 b) {
   float diffX = b.x - a.x;
   registry->ropes.get(e).angle = atan2(diffY, diffX);
   TransformComponent& transform = registry->transforms.get(e);
+  transform.rotation = registry->ropes.get(e).angle;
   transform.position = {(a.x + b.x) / 2, (a.y + b.y) / 2};
   transform.scale = {sqrt(pow(b.x - a.x, 2) + pow(b.y - a.y, 2)), 10};
 }
 
-void ConstrainedPhysicsWorldSystem::handleVerticalSpring() {
-  float L0 = 1;      // natural rope length
-  float ks = 100.f;  // spring stiffness
-  float mass = 1.f;
-  float grav = 0.1f;
-  (void)grav;
-
-  TransformComponent topBallTransform = registry->transforms.get(topBallVert);
-  TransformComponent middleBallTransform =
-      registry->transforms.get(middleBallVert);
-  TransformComponent bottomBallTransform =
-      registry->transforms.get(bottomBallVert);
-
-  vec2 L = middleBallTransform.position - topBallTransform.position;
-  float magL = sqrt((L.x * L.x) + (L.y * L.y));
-  vec2 lHat = L / magL;  // calculate spring direction
-  float s = magL - L0;   // amount spring has been stretched/compressed
-  vec2 F_spring = -ks * s * lHat;  // calculate spring force
-
-  vec2 L2 = bottomBallTransform.position - middleBallTransform.position;
-  float magL2 = sqrt((L2.x * L2.x) + (L2.y * L2.y));
-  vec2 lHat2 = L2 / magL2;  // calculate spring direction
-  float s2 = magL2 - L0;    // amount spring has been stretched/compressed
-  vec2 F_spring2 = -ks * s2 * lHat2;  // calculate spring force
-
-  vec2 gravVec = {1, 1};          // {0,1}
-  vec2 F_grav = -mass * gravVec;  //* grav * gravVec;
-
-  // energy =
-
-  vec2 force = F_spring + F_grav - F_spring2;  // total force on middleBall
-  vec2 force2 = F_spring2 + F_grav;            // total force on bottomBall
-  float delta = 0.001f;
-  Velocity& middleVel = registry->velocities.get(middleBallVert);
-  middleVel.velocity += force / mass * delta;
-  middleBallTransform.position += middleVel.velocity * delta;
-  Velocity& bottomVel = registry->velocities.get(bottomBallVert);
-  bottomVel.velocity += force2 / mass * delta;
-  bottomBallTransform.position += bottomVel.velocity * delta;
-  TransformComponent& topMiddleLinkTransform =
-      registry->transforms.get(topMiddleLinkVert);
-  (void)topMiddleLinkTransform;
-  ConstrainedPhysicsRegistry::Rope& topMiddleRope =
-      registry->ropes.get(topMiddleLinkVert);
-  topMiddleRope.a = topBallTransform.position;
-  topMiddleRope.b = middleBallTransform.position;
-  recalculateAngle(topMiddleLinkVert, topMiddleRope.a, topMiddleRope.b);
-  ConstrainedPhysicsRegistry::Rope& middleBottomRope =
-      registry->ropes.get(middleBottomLinkVert);
-  middleBottomRope.a = middleBallTransform.position;
-  middleBottomRope.b = bottomBallTransform.position;
-  recalculateAngle(middleBottomLinkVert, middleBottomRope.a,
-                   middleBottomRope.b);
-}
-
-void ConstrainedPhysicsWorldSystem::handleHorizontalSpring() {
-  float L0 = 1;      // natural rope length
-  float ks = 115.f;  // spring stiffness
-  float mass = 1.f;
-  float grav = 0.1f;
-  (void)grav;
-
-  TransformComponent topBallTransform = registry->transforms.get(topBallHorz);
-  TransformComponent middleBallTransform =
-      registry->transforms.get(middleBallHorz);
-  TransformComponent bottomBallTransform =
-      registry->transforms.get(bottomBallHorz);
-
-  vec2 L = middleBallTransform.position - topBallTransform.position;
-  float magL = sqrt((L.x * L.x) + (L.y * L.y));
-  vec2 lHat = L / magL;  // calculate spring direction
-  float s = magL - L0;   // amount spring has been stretched/compressed
-  vec2 F_spring = -ks * s * lHat;  // calculate spring force
-
-  vec2 L2 = bottomBallTransform.position - middleBallTransform.position;
-  float magL2 = sqrt((L2.x * L2.x) + (L2.y * L2.y));
-  vec2 lHat2 = L2 / magL2;  // calculate spring direction
-  float s2 = magL2 - L0;    // amount spring has been stretched/compressed
-  vec2 F_spring2 = -ks * s2 * lHat2;  // calculate spring force
-
-  vec2 gravVec = {1, 1};          // {0,1}
-  vec2 F_grav = -mass * gravVec;  //* grav * gravVec;
-
-  vec2 force = F_spring + F_grav - F_spring2;  // total force on middleBall
-  vec2 force2 = F_spring2 + F_grav;            // total force on bottomBall
-  float delta = 0.001f;
-  Velocity& middleVel = registry->velocities.get(middleBallHorz);
-  middleVel.velocity += force / mass * delta;
-  middleBallTransform.position += middleVel.velocity * delta;
-  Velocity& bottomVel = registry->velocities.get(bottomBallHorz);
-  bottomVel.velocity += force2 / mass * delta;
-  bottomBallTransform.position += bottomVel.velocity * delta;
-  TransformComponent& topMiddleLinkTransform =
-      registry->transforms.get(topMiddleLinkHorz);
-  (void)topMiddleLinkTransform;
-  ConstrainedPhysicsRegistry::Rope& topMiddleRope =
-      registry->ropes.get(topMiddleLinkHorz);
-  topMiddleRope.a = topBallTransform.position;
-  topMiddleRope.b = middleBallTransform.position;
-  recalculateAngle(topMiddleLinkHorz, topMiddleRope.a, topMiddleRope.b);
-  ConstrainedPhysicsRegistry::Rope& middleBottomRope =
-      registry->ropes.get(middleBottomLinkHorz);
-  middleBottomRope.a = middleBallTransform.position;
-  middleBottomRope.b = bottomBallTransform.position;
-  recalculateAngle(middleBottomLinkHorz, middleBottomRope.a,
-                   middleBottomRope.b);
-}
+void ConstrainedPhysicsWorldSystem::step_springs(float delta) {
+  springs.step(delta / 1000.f);
 
-void ConstrainedPhysicsWorldSystem::handleDiagSpring1() {
-  float L0 = 1;      // natural rope length
-  float ks = 130.f;  // spring stiffness
-  float mass = 1.f;
-  float grav = 0.1f;
-  (void)grav;
-
-  TransformComponent topBallTransform = registry->transforms.get(topBallDiag1);
-  TransformComponent middleBallTransform =
-      registry->transforms.get(middleBallDiag1);
-  TransformComponent bottomBallTransform =
-      registry->transforms.get(bottomBallDiag1);
-
-  vec2 L = middleBallTransform.position - topBallTransform.position;
-  float magL = sqrt((L.x * L.x) + (L.y * L.y));
-  vec2 lHat = L / magL;  // calculate spring direction
-  float s = magL - L0;   // amount spring has been stretched/compressed
-  vec2 F_spring = -ks * s * lHat;  // calculate spring force
-
-  vec2 L2 = bottomBallTransform.position - middleBallTransform.position;
-  float magL2 = sqrt((L2.x * L2.x) + (L2.y * L2.y));
-  vec2 lHat2 = L2 / magL2;  // calculate spring direction
-  float s2 = magL2 - L0;    // amount spring has been stretched/compressed
-  vec2 F_spring2 = -ks * s2 * lHat2;  // calculate spring force
-
-  vec2 gravVec = {1, 1};          // {0,1}
-  vec2 F_grav = -mass * gravVec;  //* grav * gravVec;
-
-  vec2 force = F_spring + F_grav - F_spring2;  // total force on middleBall
-  vec2 force2 = F_spring2 + F_grav;            // total force on bottomBall
-  float delta = 0.001f;
-  Velocity& middleVel = registry->velocities.get(middleBallDiag1);
-  middleVel.velocity += force / mass * delta;
-  middleBallTransform.position += middleVel.velocity * delta;
-  Velocity& bottomVel = registry->velocities.get(bottomBallDiag1);
-  bottomVel.velocity += force2 / mass * delta;
-  bottomBallTransform.position += bottomVel.velocity * delta;
-  TransformComponent& topMiddleLinkTransform =
-      registry->transforms.get(topMiddleLinkDiag1);
-  (void)topMiddleLinkTransform;
-  ConstrainedPhysicsRegistry::Rope& topMiddleRope =
-      registry->ropes.get(topMiddleLinkDiag1);
-  topMiddleRope.a = topBallTransform.position;
-  topMiddleRope.b = middleBallTransform.position;
-  recalculateAngle(topMiddleLinkDiag1, topMiddleRope.a, topMiddleRope.b);
-  ConstrainedPhysicsRegistry::Rope& middleBottomRope =
-      registry->ropes.get(middleBottomLinkDiag1);
-  middleBottomRope.a = middleBallTransform.position;
-  middleBottomRope.b = bottomBallTransform.position;
-  recalculateAngle(middleBottomLinkDiag1, middleBottomRope.a,
-                   middleBottomRope.b);
-}
+  for (const SpringBall& ball : spring_balls)
+    registry->transforms.get(ball.entity).position =
+        springs.position(ball.particle);
 
-void ConstrainedPhysicsWorldSystem::handleDiagSpring2() {
-  float L0 = 1;      // natural rope length
-  float ks = 145.f;  // spring stiffness
-  float mass = 1.f;
-  float grav = 0.1f;
-  (void)grav;
-
-  TransformComponent topBallTransform = registry->transforms.get(topBallDiag2);
-  TransformComponent middleBallTransform =
-      registry->transforms.get(middleBallDiag2);
-  TransformComponent bottomBallTransform =
-      registry->transforms.get(bottomBallDiag2);
-
-  vec2 L = middleBallTransform.position - topBallTransform.position;
-  float magL = sqrt((L.x * L.x) + (L.y * L.y));
-  vec2 lHat = L / magL;  // calculate spring direction
-  float s = magL - L0;   // amount spring has been stretched/compressed
-  vec2 F_spring = -ks * s * lHat;  // calculate spring force
-
-  vec2 L2 = bottomBallTransform.position - middleBallTransform.position;
-  float magL2 = sqrt((L2.x * L2.x) + (L2.y * L2.y));
-  vec2 lHat2 = L2 / magL2;  // calculate spring direction
-  float s2 = magL2 - L0;    // amount spring has been stretched/compressed
-  vec2 F_spring2 = -ks * s2 * lHat2;  // calculate spring force
-
-  vec2 gravVec = {1, 1};          // {0,1}
-  vec2 F_grav = -mass * gravVec;  //* grav * gravVec;
-
-  vec2 force = F_spring + F_grav - F_spring2;  // total force on middleBall
-  vec2 force2 = F_spring2 + F_grav;            // total force on bottomBall
-  float delta = 0.001f;
-  Velocity& middleVel = registry->velocities.get(middleBallDiag2);
-  middleVel.velocity += force / mass * delta;
-  middleBallTransform.position += middleVel.velocity * delta;
-  Velocity& bottomVel = registry->velocities.get(bottomBallDiag2);
-  bottomVel.velocity += force2 / mass * delta;
-  bottomBallTransform.position += bottomVel.velocity * delta;
-  TransformComponent& topMiddleLinkTransform =
-      registry->transforms.get(topMiddleLinkDiag2);
-  (void)topMiddleLinkTransform;
-  ConstrainedPhysicsRegistry::Rope& topMiddleRope =
-      registry->ropes.get(topMiddleLinkDiag2);
-  topMiddleRope.a = topBallTransform.position;
-  topMiddleRope.b = middleBallTransform.position;
-  recalculateAngle(topMiddleLinkDiag2, topMiddleRope.a, topMiddleRope.b);
-  ConstrainedPhysicsRegistry::Rope& middleBottomRope =
-      registry->ropes.get(middleBottomLinkDiag2);
-  middleBottomRope.a = middleBallTransform.position;
-  middleBottomRope.b = bottomBallTransform.position;
-  recalculateAngle(middleBottomLinkDiag2, middleBottomRope.a,
-                   middleBottomRope.b);
+  for (const SpringLink& link : spring_links) {
+    ConstrainedPhysicsRegistry::Rope& rope = registry->ropes.get(link.entity);
+    rope.a = springs.position(link.a);
+    rope.b = springs.position(link.b);
+    recalculateAngle(link.entity, rope.a, rope.b);
+  }
 }
 
 // Update our game world
@@ -280,9 +100,8 @@ bool ConstrainedPhysicsWorldSystem::step(float delta) {
   // registry->camera.get(camera).cameraTarget =
   //    registry->transforms.get(current_player).position;
   // Get the screen dimensions
-  auto window = window_manager->get_window();
   int screen_width, screen_height;
-  glfwGetFramebufferSize(window, &screen_width, &screen_height);
+  viewport->get_framebuffer_size(&screen_width, &screen_height);
 
   // check if player has won
   auto playerTransform = registry->transforms.get(current_player);
@@ -296,10 +115,7 @@ bool ConstrainedPhysicsWorldSystem::step(float delta) {
   }
 
   // add step functions here
-  handleVerticalSpring();
-  handleHorizontalSpring();
-  handleDiagSpring1();
-  handleDiagSpring2();
+  step_springs(delta);
 
   float min_counter_ms = 3000.f;
   for (Entity entity : registry->deathTimers.entities) {
@@ -326,100 +142,66 @@ bool ConstrainedPhysicsWorldSystem::step(float delta) {
 
 // Reset the world state to its initial state
 void ConstrainedPhysicsWorldSystem::restart_game() {
-  wonYet = false;
-  deadYet = false;
-  if (!registry->camera.has(camera)) {
-    camera = Entity();
-    registry->camera.emplace(camera);
-  }
-  // Debugging for memory/component leaks
-  registry->list_all_components();
-  printf("Restarting\n");
+  if (!round_prepared) prepare_round();
+  registry->swap_components(*staging);
+  round_prepared = false;
+}
 
-  // Remove all entities that we created
-  // All that have a motion, we could also iterate over all fish, turtles, ...
-  // but that would be more cumbersome
-  while (registry->transforms.entities.size() > 0)
-    registry->remove_all_components_of(registry->transforms.entities.back());
+// Build the initial entities of the next round into the staging registry
+void ConstrainedPhysicsWorldSystem::prepare_round() {
+  staging->clear_all_components();
 
-  // Debugging for memory/component leaks
-  registry->list_all_components();
+  wonYet = false;
+  deadYet = false;
+  camera = Entity();
+  staging->camera.emplace(camera);
 
   // Get the screen dimensions
-  auto window = window_manager->get_window();
   int screen_width, screen_height;
-  glfwGetFramebufferSize(window, &screen_width, &screen_height);
+  viewport->get_framebuffer_size(&screen_width, &screen_height);
 
-  createBackground(registry, renderer, {screen_width/2, screen_height/2});
+  createBackground(staging, meshes, {screen_width/2, screen_height/2});
 
   current_player =
-      createPlayer(registry, renderer, {screen_width / 8, screen_height / 3});
-
-  registry->camera.get(camera).cameraPosition = {screen_width / 2,
-                                                 screen_height / 2};
-
-  registry->camera.get(camera).cameraTarget = {screen_width / 2,
-                                               screen_height / 2};
-
-  registry->camera.get(camera).cameraFOV = {screen_width, screen_height};
-
-  // vertical spring
-  topBallVert =
-      createLine(registry, {screen_width / 2, screen_height / 2}, {30, 30});
-  middleBallVert =
-      createLine(registry, {screen_width / 2, screen_height * 3 / 4}, {30, 30});
-  topMiddleLinkVert =
-      createRope(registry, registry->transforms.get(topBallVert).position,
-                 registry->transforms.get(middleBallVert).position);
-  bottomBallVert =
-      createLine(registry, {screen_width / 2, screen_height}, {30, 30});
-  middleBottomLinkVert =
-      createRope(registry, registry->transforms.get(middleBallVert).position,
-                 registry->transforms.get(bottomBallVert).position);
-
-  // horizontal spring
-  topBallHorz =
-      createLine(registry, {screen_width / 2, screen_height / 2}, {30, 30});
-  middleBallHorz =
-      createLine(registry, {screen_width * 3 / 4, screen_height / 2}, {30, 30});
-  topMiddleLinkHorz =
-      createRope(registry, registry->transforms.get(topBallHorz).position,
-                 registry->transforms.get(middleBallHorz).position);
-  bottomBallHorz =
-      createLine(registry, {screen_width, screen_height / 2}, {30, 30});
-  middleBottomLinkHorz =
-      createRope(registry, registry->transforms.get(middleBallHorz).position,
-                 registry->transforms.get(bottomBallHorz).position);
-
-  // diagonal spring 1
-  topBallDiag1 =
-      createLine(registry, {screen_width / 2, screen_height / 2}, {30, 30});
-  middleBallDiag1 = createLine(
-      registry, {screen_width * 3 / 4, screen_height * 3 / 4}, {30, 30});
-  topMiddleLinkDiag1 =
-      createRope(registry, registry->transforms.get(topBallDiag1).position,
-                 registry->transforms.get(middleBallDiag1).position);
-  bottomBallDiag1 =
-      createLine(registry, {screen_width, screen_height}, {30, 30});
-  middleBottomLinkDiag1 =
-      createRope(registry, registry->transforms.get(middleBallDiag1).position,
-                 registry->transforms.get(bottomBallDiag1).position);
-
-  // diagonal spring 2
-  topBallDiag2 =
-      createLine(registry, {screen_width / 2, screen_height / 2}, {30, 30});
-  middleBallDiag2 =
-      createLine(registry, {screen_width * 3 / 4, screen_height / 4}, {30, 30});
-  topMiddleLinkDiag2 =
-      createRope(registry, registry->transforms.get(topBallDiag2).position,
-                 registry->transforms.get(middleBallDiag2).position);
-  bottomBallDiag2 = createLine(registry, {screen_width, 0}, {30, 30});
-  middleBottomLinkDiag2 =
-      createRope(registry, registry->transforms.get(middleBallDiag2).position,
-                 registry->transforms.get(bottomBallDiag2).position);
-
-  // randomize seed for random calls. Without this, the random is predictable
-  rng = std::default_random_engine(std::random_device()());
+      createPlayer(staging, meshes, {screen_width / 8, screen_height / 3});
+
+  staging->camera.get(camera).cameraPosition = {screen_width / 2,
+                                                screen_height / 2};
+
+  staging->camera.get(camera).cameraTarget = {screen_width / 2,
+                                              screen_height / 2};
+
+  staging->camera.get(camera).cameraFOV = {screen_width, screen_height};
+
+  // the springs hang from the center of the screen, the player dies on
+  // contact with any of the balls, the links and the background are left out
+  // of collision detection
+  springs.clear();
+  spring_balls.clear();
+  spring_links.clear();
+  vec2 center = {screen_width / 2, screen_height / 2};
+  for (const SpringDescription& description : SPRINGS) {
+    vec2 end = description.end * vec2(screen_width, screen_height);
+    RopeSolver::Rope spring = springs.add_rope(
+        center, end, SPRING_SEGMENTS, 1.f, 1.f / description.stiffness, true,
+        SPRING_REST_LENGTH);
+    for (unsigned int i = 0; i < spring.particle_count; i++) {
+      unsigned int particle = spring.first_particle + i;
+      Entity ball = createLine(staging, springs.position(particle), {30, 30});
+      staging->collisionFilters.insert(ball,
+                                       {COLLISION_OBSTACLE, COLLISION_PLAYER});
+      spring_balls.push_back({ball, particle});
+      if (i == 0) continue;
+      Entity link = createRope(staging, springs.position(particle - 1),
+                               springs.position(particle));
+      spring_links.push_back({link, particle - 1, particle});
+    }
+  }
+
+  // new random sequence for this round, see RandomService
+  rng = random_service.engine("constrained_physics");
+
+  round_prepared = true;
 }
 
 void ConstrainedPhysicsWorldSystem::handle_sprite_animation(float delta) {
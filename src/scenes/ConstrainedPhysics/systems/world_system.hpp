@@ -7,14 +7,10 @@
 #include <random>
 #include <vector>
 
-#define SDL_MAIN_HANDLED
-#include <SDL.h>
-#include <SDL_mixer.h>
-
 #include "../registry.hpp"
 #include "physics_system.hpp"
-#include "render_system.hpp"
-#include "window_manager.hpp"
+#include "rope_solver.hpp"
+#include "scene_io.hpp"
 
 // Container for all our entities and game logic. Individual rendering / update
 // is deferred to the relative update() methods
@@ -24,9 +20,9 @@ class ConstrainedPhysicsWorldSystem {
 
   // starts the game
   void init(std::shared_ptr<ConstrainedPhysicsRegistry> registry,
-            std::shared_ptr<RenderSystem> renderer,
+            std::shared_ptr<MeshLibrary> meshes,
             std::shared_ptr<ConstrainedPhysicsSystem> physics,
-            std::shared_ptr<WindowManager> window_manager,
+            std::shared_ptr<Viewport> viewport,
             std::function<void()> on_scene_end);
 
   // Releases all associated resources
@@ -47,20 +43,26 @@ class ConstrainedPhysicsWorldSystem {
   void on_key(int key, int action, int mod);
   void on_mouse_move(vec2 pos);
 
-  void handleVerticalSpring();
-  void handleHorizontalSpring();
-  void handleDiagSpring1();
-  void handleDiagSpring2();
+  // moves the spring balls and their links with the rope solver
+  void step_springs(float delta);
 
   void recalculateAngle(Entity e, vec2 a, vec2 b);
-  // restart level
+  // restart level, with the round prepared before if there is one
   void restart_game();
 
+  // Builds the next round aside, see Scene::prepare. The scene must not step
+  // meanwhile.
+  void prepare_round();
+
  private:
   // holds the scene state
   std::shared_ptr<ConstrainedPhysicsRegistry> registry;
+  // holds the next round until restart_game swaps it in
+  std::shared_ptr<ConstrainedPhysicsRegistry> staging =
+      std::make_shared<ConstrainedPhysicsRegistry>();
+  bool round_prepared = false;
 
-  std::shared_ptr<WindowManager> window_manager;
+  std::shared_ptr<Viewport> viewport;
 
   // C++ random number generator
   std::default_random_engine rng;
@@ -70,45 +72,27 @@ class ConstrainedPhysicsWorldSystem {
   Entity rope;
   Entity testBall;
 
-  // vertical
-  Entity topBallVert;
-  Entity topMiddleLinkVert;
-  Entity middleBallVert;
-  Entity middleBottomLinkVert;
-  Entity bottomBallVert;
-
-  // horizontal
-  Entity topBallHorz;
-  Entity topMiddleLinkHorz;
-  Entity middleBallHorz;
-  Entity middleBottomLinkHorz;
-  Entity bottomBallHorz;
-
-  // diagonal 1
-  Entity topBallDiag1;
-  Entity topMiddleLinkDiag1;
-  Entity middleBallDiag1;
-  Entity middleBottomLinkDiag1;
-  Entity bottomBallDiag1;
-
-  // diagonal 2
-  Entity topBallDiag2;
-  Entity topMiddleLinkDiag2;
-  Entity middleBallDiag2;
-  Entity middleBottomLinkDiag2;
-  Entity bottomBallDiag2;
+  // springs spinning in the middle of the map, see SPRINGS
+  struct SpringBall {
+    Entity entity;
+    unsigned int particle;  // in springs
+  };
+  struct SpringLink {
+    Entity entity;
+    unsigned int a, b;  // particles at the ends
+  };
+  RopeSolver springs;
+  std::vector<SpringBall> spring_balls;
+  std::vector<SpringLink> spring_links;
 
   bool deadYet = false;
   bool wonYet = false;
 
-  std::shared_ptr<RenderSystem> renderer;
+  std::shared_ptr<MeshLibrary> meshes;
   std::shared_ptr<ConstrainedPhysicsSystem> physics;
 
   Entity camera;
 
-  // Audio
-  Mix_Music *background_music;
-
   // callback called when the game ends
   std::function<void()> on_game_end_callback_ptr;
 };
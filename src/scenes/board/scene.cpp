@@ -32,16 +32,22 @@ void BoardScene::init(std::shared_ptr<WindowManager> window_manager,
 
   registry->clear_all_components();
 
-  int window_width, window_height;
-  glfwGetFramebufferSize(window_manager->get_window(), &window_width,
-                         &window_height);
+  window_manager->get_framebuffer_size(&window_width, &window_height);
   assert(renderer->init(registry, window_width, window_height,
                         window_manager->get_window()));
 
   //renderer->initializeGlMeshes();
 
-  world->init(registry, renderer, physics, window_manager, [&]() { end(); });
+  world->init(registry, renderer, physics, window_manager, events,
+              [&]() { end(); });
   physics->init(registry);
+  systems.clear();
+  systems.add_exclusive("world", [this](float delta) { world->step(delta); });
+  systems.add_exclusive("physics", [this](float delta) {
+    physics->step(delta, window_width, window_height);
+  });
+  systems.add("sprite animation", {}, {&registry->spriteAnimations},
+              [this](float delta) { world->handle_sprite_animation(delta); });
 
   renderer->add_text_to_be_rendered({"Loading Game "}, vec2(0.38, 0.45), 1,
                                     vec3(1, 0.541, 0),
@@ -50,10 +56,14 @@ void BoardScene::init(std::shared_ptr<WindowManager> window_manager,
   ScreenState &screen = registry->screenStates.components[0];
   screen.screen_brightness = 0.1;
   renderer->render_text_only(vec3(0.133, 0.224, 0.722));
+  renderer->clear_text();
   screen.screen_brightness = 1.0;
 }
 
 bool BoardScene::step(float delta) {
+  // only this step's text is drawn
+  renderer->clear_text();
+
   // display the story before going into board game
   if (!displayed_story || waiting_for_continue) {
     // printf("Press S to skip the story...\n");
@@ -65,6 +75,9 @@ bool BoardScene::step(float delta) {
     screen.blur_rect_position = glm::vec4(0.17, 0.18, 0.62, 0.60);
     screen.screen_brightness = 0.6;
 
+    renderer->show_text_with_background(TEXTURE_ASSET_ID::BKGD_PLANIT,
+                                        vec2(600, 400), vec2(1200, 800));
+
     // add the block
     renderer->add_text_block_to_be_rendered(
         story.substr(0, count), ROW, vec2(0.20, 0.70), 0.72, vec3(1, 1, 1),
@@ -86,22 +99,24 @@ bool BoardScene::step(float delta) {
                                         vec2(0.48, 0.25), 0.75, vec3(1, 1, 0),
                                         RenderSystem::FONTS::BOLD, 0);
     } else {
-      count++;
+      story_ms += delta;
+      count = int(story_ms / TYPIST_MS_PER_CHARACTER);
     }
-
-    renderer->render_text_with_background(TEXTURE_ASSET_ID::BKGD_PLANIT,
-                                          vec2(600, 400), vec2(1200, 800));
-    // renderer->render_text_only(vec3(0.133, 0.224, 0.722));
-    // std::this_thread::sleep_for(std::chrono::milliseconds(10));
   } else {
-    int window_width, window_height;
-    glfwGetFramebufferSize(window_manager->get_window(), &window_width,
-                           &window_height);
+    renderer->show_world();
+
+    // keep the poses before this step for interpolation
+    registry->snapshot_transforms();
+
+    window_manager->get_framebuffer_size(&window_width, &window_height);
 
     // step forward systems
-    world->step(delta);
-    physics->step(delta, window_width, window_height);
-    world->handle_sprite_animation(delta);
+    systems.step(delta);
+    // the text the world queued this step
+    for (TextEvent &text : events->take_texts())
+      renderer->add_text_to_be_rendered(text.text_block, text.pos_percent,
+                                        text.scale, text.color,
+                                        text.font_type, text.line_space);
 
     // display help panel
     if (help_on) {
@@ -109,12 +124,15 @@ bool BoardScene::step(float delta) {
                                         vec3(1, 1, 1),
                                         RenderSystem::FONTS::ITALIC, 0);
     }
-    renderer->draw();
   }
 
   return true;
 }
 
+void BoardScene::publish() { renderer->publish(); }
+
+void BoardScene::draw() { renderer->draw(); }
+
 void BoardScene::reset_scene() { world->restart_game(); }
 
 void BoardScene::on_key(int key, int action, int mod) {
@@ -150,4 +168,8 @@ void BoardScene::on_key(int key, int action, int mod) {
 
 void BoardScene::on_mouse_move(vec2 pos) { world->on_mouse_move(pos); }
 
+uint64_t BoardScene::state_hash() { return registry->state_hash(); }
+
+SleepStats BoardScene::sleep_stats() { return physics->sleep_stats(); }
+
 void BoardScene::end() { on_scene_end_callback_ptr(*registry); }
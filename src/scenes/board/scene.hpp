@@ -5,6 +5,7 @@
 #include <vector>
 
 // internal
+#include "system_scheduler.hpp"
 #include "window_manager.hpp"
 
 // base class
@@ -32,6 +33,12 @@ class BoardScene : public Scene {
   // steps the scene ahead by delta (in milliseconds)
   bool step(float delta);
 
+  // see Scene::publish
+  void publish();
+
+  // renders the last step, see Scene::draw
+  void draw();
+
   // resets the board
   void reset_scene();
 
@@ -41,11 +48,18 @@ class BoardScene : public Scene {
   // input callback for mouse movement
   void on_mouse_move(vec2 pos);
 
+  // see Scene::state_hash
+  uint64_t state_hash();
+
+  // see Scene::sleep_stats
+  SleepStats sleep_stats();
+
  private:
   // holds the scene state
   bool displayed_story = false;
   bool waiting_for_continue = true;
   int count = 0;
+  float story_ms = 0;  // time spent typing the story, drives count
   bool help_on = true;
   std::string story = {
       "The Doge kingdom is in a war with the Cat kingdom. The cats are too "
@@ -72,6 +86,11 @@ class BoardScene : public Scene {
   std::shared_ptr<BoardPhysicsSystem> physics;
   std::shared_ptr<RenderSystem> renderer;
 
+  // runs the systems in the order init added them
+  SystemScheduler systems;
+  // framebuffer size of the current step
+  int window_width = 0, window_height = 0;
+
   // callback called when the scene ends
   std::function<void(BoardRegistry)> on_scene_end_callback_ptr;
 
@@ -1,6 +1,7 @@
 // internal
 #include "physics_system.hpp"
 
+#include "body_sleep.hpp"
 #include "world_init.hpp"
 
 // Returns the local bounding coordinates scaled by the current size of the
@@ -11,28 +12,15 @@ vec2 get_bounding_box(const TransformComponent &transform) {
   //return {abs(transform.scale.x), abs(transform.scale.y)};
 }
 
-// This is a SUPER APPROXIMATE check that puts a circle around the bounding
-// boxes and sees if the center point of either object is inside the other's
-// bounding-box-circle. You can surely implement a more accurate detection
-bool collides(const TransformComponent &transform1,
-              const TransformComponent &transform2) {
-  vec2 dp = transform1.position - transform2.position;
-  float dist_squared = dot(dp, dp);
-  const vec2 other_bonding_box = get_bounding_box(transform1) / 2.f;
-  const float other_r_squared = dot(other_bonding_box, other_bonding_box);
-  const vec2 my_bonding_box = get_bounding_box(transform2) / 2.f;
-  const float my_r_squared = dot(my_bonding_box, my_bonding_box);
-  const float r_squared = max(other_r_squared, my_r_squared);
-  if (dist_squared < r_squared) return true;
-  return false;
-}
-
 void BoardPhysicsSystem::init(std::shared_ptr<BoardRegistry> registry) {
   this->registry = registry;
+  broad_phase.set_job_system(&job_system);
 }
 
 void BoardPhysicsSystem::step(float delta, float window_width,
                               float window_height) {
+  last_sleep_stats = update_sleeping_bodies(*registry);
+
   // Move entities with Velocity components
   auto velocity_registry = &registry->velocities;
   for (uint i = 0; i < velocity_registry->size(); i++) {
@@ -52,7 +40,10 @@ void BoardPhysicsSystem::step(float delta, float window_width,
         vel.velocity = target_vector * 30.0f;
         vel.velocity[0] = clamp(vel.velocity[0], -100.f, 100.f);
         vel.velocity[1] = clamp(vel.velocity[1], -100.f, 100.f);
+        // a new target space
+        if (vel.velocity != vec2(0.f)) wake_body(*registry, entity);
       }
+      if (is_asleep(*registry, entity)) continue;
 
       transform.position += vel.velocity * step_seconds;
     }
@@ -62,7 +53,7 @@ void BoardPhysicsSystem::step(float delta, float window_width,
   auto acceleration_registry = &registry->acceleration;
   for (uint i = 0; i < acceleration_registry->size(); i++) {
     Entity entity = acceleration_registry->entities[i];
-    if (registry->velocities.has(entity)) {
+    if (registry->velocities.has(entity) && !is_asleep(*registry, entity)) {
       float step_seconds = 1.0f * (delta / 1000.f);
       (void)step_seconds;
       Acceleration &acc = acceleration_registry->components[i];
@@ -72,31 +63,54 @@ void BoardPhysicsSystem::step(float delta, float window_width,
     }
   }
 
-  // Check for collisions between all colliders entities
-  ComponentContainer<Collider> &collider_container = registry->colliders;
-  for (uint i = 0; i < collider_container.components.size(); i++) {
-    Entity entity_i = collider_container.entities[i];
+  // Check for collisions between the players and the spaces, the entities
+  // with a CollisionFilter. They touch when the center of one enters the
+  // circle around the bounding box of the other.
+  ComponentContainer<CollisionFilter> &filter_container =
+      registry->collisionFilters;
+  broad_phase.clear();
+  bodies.clear();
+  bool active_player_collides = false;
+  for (uint i = 0; i < filter_container.components.size(); i++) {
+    Entity entity_i = filter_container.entities[i];
     TransformComponent &transform_i = registry->transforms.get(entity_i);
-    for (uint j = 0; j < collider_container.components.size(); j++)  // i+1
-    {
-      if (i == j) continue;
-
-      Entity entity_j = collider_container.entities[j];
-      TransformComponent &transform_j = registry->transforms.get(entity_j);
-      if (collides(transform_i, transform_j)) {
-        // Create a collisions event
-        // We are abusing the ECS system a bit in that we potentially insert
-        // multiple collisions for the same entity
-        registry->collisions.emplace_with_duplicates(entity_i, entity_j);
-        registry->collisions.emplace_with_duplicates(entity_j, entity_i);
-      } else {
-        if (registry->spaces.has(entity_i) && registry->players.has(entity_j) &&
-            registry->activePlayer.has(entity_j))
-
-        {
-          registry->spaces.get(entity_i).player_stepped_on = 0;
-        }
-      }
+    float radius = length(get_bounding_box(transform_i) / 2.f);
+    const CollisionFilter &filter = filter_container.components[i];
+    broad_phase.insert(i, transform_i.position, {radius, radius},
+                       filter.category, filter.mask);
+    bodies.add(transform_i.position, radius);
+    active_player_collides |= registry->activePlayer.has(entity_i);
+  }
+  candidates.clear();
+  broad_phase.find_pairs(candidates);
+  drop_sleeping_pairs(*registry, filter_container.entities, candidates);
+  contacts.clear();
+  circle_pairs(bodies, candidates, CircleContact::LARGER_RADIUS, contacts);
+  wake_contacts(*registry, filter_container.entities, contacts);
+  // spaces under the active player, the others are no longer stepped on
+  std::vector<bool> stepped_on(filter_container.components.size(), false);
+  for (const BroadPhasePair &contact : contacts) {
+    unsigned int i = contact.a;
+    unsigned int j = contact.b;
+    Entity entity_i = filter_container.entities[i];
+    Entity entity_j = filter_container.entities[j];
+    // Create a collisions event, one per contact. The world system reacts to
+    // the entry of the active player, so players (the active one first) go
+    // first.
+    if (registry->players.has(entity_j) &&
+        (!registry->players.has(entity_i) ||
+         registry->activePlayer.has(entity_j))) {
+      std::swap(entity_i, entity_j);
+      std::swap(i, j);
+    }
+    registry->collisions.emplace_with_duplicates(entity_i, entity_j);
+    if (registry->activePlayer.has(entity_i)) stepped_on[j] = true;
+  }
+  for (uint i = 0; i < filter_container.components.size(); i++) {
+    Entity entity_i = filter_container.entities[i];
+    if (active_player_collides && !stepped_on[i] &&
+        registry->spaces.has(entity_i)) {
+      registry->spaces.get(entity_i).player_stepped_on = 0;
     }
   }
 
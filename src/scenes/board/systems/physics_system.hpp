@@ -4,8 +4,11 @@
 #include <memory>
 
 #include "../registry.hpp"
+#include "body_sleep.hpp"
+#include "broad_phase.hpp"
 #include "common.hpp"
 #include "components.hpp"
+#include "narrow_phase.hpp"
 #include "tiny_ecs.hpp"
 
 class BoardPhysicsSystem {
@@ -17,7 +20,16 @@ class BoardPhysicsSystem {
 
   void step(float delta, float window_width, float window_height);
 
+  // bodies awake and asleep in the last step, see update_sleeping_bodies
+  SleepStats sleep_stats() const { return last_sleep_stats; }
+
  private:
   // holds the scene state
   std::shared_ptr<BoardRegistry> registry;
+  SleepStats last_sleep_stats;
+
+  // rebuilt every step, kept to reuse its allocations
+  SpatialHash broad_phase;
+  NarrowPhaseBodies bodies;  // ids are the indices in collisionFilters
+  std::vector<BroadPhasePair> candidates, contacts;
 };
\ No newline at end of file
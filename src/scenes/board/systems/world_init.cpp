@@ -14,18 +14,19 @@ Entity createParticleSystem(std::shared_ptr<BoardRegistry> registry,
   transform.scale = {1.0, 1.0};
 
   ParticleSystem &particleSystem = registry->particleSystems.emplace(entity);
-  particleSystem.particleSystemLifetime = psl;
-  particleSystem.spawningRate = sr;
-  particleSystem.spawningAngle = sa;
-  particleSystem.coneAngle = ca;
-  particleSystem.initialSpeed = is;
-  particleSystem.speedRandomness = isr;
-  particleSystem.initialLifetime = il;
-  particleSystem.lifetimeRandomness = ilr;
-  particleSystem.particleSize = ps;
-  particleSystem.particleSizeRandomness = psr;
+  ParticleEmitter &emitter = particleSystem.emitter;
+  emitter.lifetime_ms = psl;
+  emitter.spawning_rate_ms = sr;
+  emitter.spawning_angle = sa;
+  emitter.cone_angle = ca;
+  emitter.initial_speed = is;
+  emitter.speed_randomness = isr;
+  emitter.particle_lifetime_ms = il;
+  emitter.lifetime_randomness = ilr;
+  emitter.particle_size = ps;
+  emitter.size_randomness = psr;
+  emitter.acceleration = particleAcceleration;
   particleSystem.texture = tex;
-  particleSystem.particleAcceleration = particleAcceleration;
 
   return entity;
 }
@@ -51,11 +52,11 @@ Entity createLine(std::shared_ptr<BoardRegistry> registry, vec2 position,
 }
 
 Entity createBackground(std::shared_ptr<BoardRegistry> registry,
-                        std::shared_ptr<RenderSystem> renderer) {
+                        std::shared_ptr<MeshLibrary> meshes) {
   auto fixedBackground = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh &fixedMesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh &fixedMesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(fixedBackground, &fixedMesh);
 
   registry->UIelements.emplace(fixedBackground);
@@ -70,11 +71,12 @@ Entity createBackground(std::shared_ptr<BoardRegistry> registry,
   registry->renderRequests.insert(
       fixedBackground, {TEXTURE_ASSET_ID::BKGD_0, EFFECT_ASSET_ID::TEXTURED,
                         GEOMETRY_BUFFER_ID::SPRITE});
+  registry->staticLayers.emplace(fixedBackground);
 
   auto dynamicBackground = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh &dynamicMesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh &dynamicMesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(dynamicBackground, &dynamicBackground);
 
   registry->UIelements.emplace(dynamicBackground);
@@ -89,16 +91,18 @@ Entity createBackground(std::shared_ptr<BoardRegistry> registry,
   registry->renderRequests.insert(
       dynamicBackground, {TEXTURE_ASSET_ID::BKGD_1, EFFECT_ASSET_ID::PARALLAXED,
                           GEOMETRY_BUFFER_ID::SPRITE});
+  // parallax only depends on the camera, so both layers can be cached
+  registry->staticLayers.emplace(dynamicBackground);
 
   return fixedBackground;
 }
 
 Entity createBoard(std::shared_ptr<BoardRegistry> registry,
-                   std::shared_ptr<RenderSystem> renderer, vec2 pos) {
+                   std::shared_ptr<MeshLibrary> meshes, vec2 pos) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh &mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::BOARD);
+  Mesh &mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::BOARD);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Setting initial motion values
@@ -115,17 +119,18 @@ Entity createBoard(std::shared_ptr<BoardRegistry> registry,
        EFFECT_ASSET_ID::BOARD, GEOMETRY_BUFFER_ID::BOARD});
 
   registry->colors.insert(entity, {0.15f, 0.15f, 0.2f});
+  registry->staticLayers.emplace(entity);
 
   return entity;
 }
 
 Entity createSpace(std::shared_ptr<BoardRegistry> registry,
-                   std::shared_ptr<RenderSystem> renderer, vec2 pos,
+                   std::shared_ptr<MeshLibrary> meshes, vec2 pos,
                    float scale, int type) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh &mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh &mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Initialize the position, scale, and physics components
@@ -139,21 +144,24 @@ Entity createSpace(std::shared_ptr<BoardRegistry> registry,
 
   Space &space = registry->spaces.emplace(entity);
   space.type = (SPACE_TYPE)type;
-  registry->colliders.emplace(entity);
+  registry->collisionFilters.insert(entity,
+                                    {COLLISION_SPACE, COLLISION_PLAYER});
 
   registry->renderRequests.insert(
       entity, {(TEXTURE_ASSET_ID)type, EFFECT_ASSET_ID::SPACE,
                GEOMETRY_BUFFER_ID::SPRITE});
+  // spaces only change when stepped on, which invalidates the static layer
+  registry->staticLayers.emplace(entity);
 
   return entity;
 }
 
 Entity createDoge(std::shared_ptr<BoardRegistry> registry,
-                  std::shared_ptr<RenderSystem> renderer, vec2 pos) {
+                  std::shared_ptr<MeshLibrary> meshes, vec2 pos) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh &mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh &mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Setting initial motion values
@@ -163,7 +171,8 @@ Entity createDoge(std::shared_ptr<BoardRegistry> registry,
   transform.scale = mesh.original_size * 50.f;
 
   registry->velocities.emplace(entity);
-  registry->colliders.emplace(entity);
+  registry->collisionFilters.insert(
+      entity, {COLLISION_PLAYER, COLLISION_PLAYER | COLLISION_SPACE});
 
   registry->renderRequests.insert(
       entity,
@@ -195,14 +204,14 @@ Entity createDoge(std::shared_ptr<BoardRegistry> registry,
 }
 
 Entity createUIelement(std::shared_ptr<BoardRegistry> registry,
-                       std::shared_ptr<RenderSystem> renderer, vec2 pos,
+                       std::shared_ptr<MeshLibrary> meshes, vec2 pos,
                        vec2 scale, TEXTURE_ASSET_ID texture, int spriteRows,
                        int spriteCols, int animation, int frame,
                        float animationSpeed) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh &mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh &mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   UIelement &ui = registry->UIelements.emplace(entity);
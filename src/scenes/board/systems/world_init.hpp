@@ -3,9 +3,9 @@
 // stdlib
 #include <memory>
 
-#include "../render_system.hpp"
 #include "./registry.hpp"
 #include "common.hpp"
+#include "scene_io.hpp"
 #include "tiny_ecs.hpp"
 
 /**
@@ -31,7 +31,7 @@ Entity createParticleSystem(std::shared_ptr<BoardRegistry> registry,
                             float ps, float psr, TEXTURE_ASSET_ID tex);
 
 //Entity createParticle(std::shared_ptr<BoardRegistry> registry,
-//                      std::shared_ptr<RenderSystem> renderer, vec2 position,
+//                      std::shared_ptr<MeshLibrary> meshes, vec2 position,
 //                      vec2 velocity, float size, TEXTURE_ASSET_ID texture, float liftime, vec2 acceleration, ParticleSystem &system, uint index);
 
 // a red line for debugging purposes
@@ -43,7 +43,7 @@ Entity createLine(std::shared_ptr<BoardRegistry> registry, vec2 position,
  * @return Entity
  */
 Entity createBackground(std::shared_ptr<BoardRegistry> registry,
-                        std::shared_ptr<RenderSystem> renderer);
+                        std::shared_ptr<MeshLibrary> meshes);
 
 /**
  * @brief Create a Board object
@@ -52,7 +52,7 @@ Entity createBackground(std::shared_ptr<BoardRegistry> registry,
  * @return Entity
  */
 Entity createBoard(std::shared_ptr<BoardRegistry> registry,
-                   std::shared_ptr<RenderSystem> renderer, vec2 pos);
+                   std::shared_ptr<MeshLibrary> meshes, vec2 pos);
 
 /**
  * @brief Create a Space object
@@ -63,7 +63,7 @@ Entity createBoard(std::shared_ptr<BoardRegistry> registry,
  * @return Entity
  */
 Entity createSpace(std::shared_ptr<BoardRegistry> registry,
-                   std::shared_ptr<RenderSystem> renderer, vec2 pos,
+                   std::shared_ptr<MeshLibrary> meshes, vec2 pos,
                    float scale, int type);
 
 /**
@@ -73,7 +73,7 @@ Entity createSpace(std::shared_ptr<BoardRegistry> registry,
  * @return Entity
  */
 Entity createDoge(std::shared_ptr<BoardRegistry> registry,
-                  std::shared_ptr<RenderSystem> renderer, vec2 pos);
+                  std::shared_ptr<MeshLibrary> meshes, vec2 pos);
 
 /**
  * @brief Create a UI element with a given texture sprite sheet, and default
@@ -90,7 +90,7 @@ Entity createDoge(std::shared_ptr<BoardRegistry> registry,
  * @return Entity
  */
 Entity createUIelement(std::shared_ptr<BoardRegistry> registry,
-                       std::shared_ptr<RenderSystem> renderer, vec2 pos,
+                       std::shared_ptr<MeshLibrary> meshes, vec2 pos,
                        vec2 scale, TEXTURE_ASSET_ID texture, int spriteRows,
                        int spriteCols, int animation, int frame,
                        float animationSpeed);
\ No newline at end of file
@@ -12,36 +12,28 @@
 #include <sstream>
 #include <string>
 
+#include "job_system.hpp"
 #include "physics_system.hpp"
-#include "window_manager.hpp"
+#include "random_service.hpp"
 
 // Game configuration
 
 BoardWorldSystem::BoardWorldSystem() {
-  // Seeding rng with random device
-  rng = std::default_random_engine(std::random_device()());
-
-  background_music = Mix_LoadMUS(audio_path("music.wav").c_str());
-  space_land = Mix_LoadWAV(audio_path("UI_41.wav").c_str());
-  plus_coins = Mix_LoadWAV(audio_path("plus_coin.wav").c_str());
-  minus_coins = Mix_LoadWAV(audio_path("minus_coin.wav").c_str());
-  explosion1 = Mix_LoadWAV(audio_path("explosion_1.wav").c_str());
-  powerup1 = Mix_LoadWAV(audio_path("power_up_1.wav").c_str());
-  next_player = Mix_LoadWAV(audio_path("next_player.wav").c_str());
-  dice_roll = Mix_LoadWAV(audio_path("dice_roll2.wav").c_str());
-  dice_hit = Mix_LoadWAV(audio_path("dice_hit.wav").c_str());
-  error = Mix_LoadWAV(audio_path("error_1.wav").c_str());
-  spring = Mix_LoadWAV(audio_path("spring.wav").c_str());
-  bark = Mix_LoadWAV(audio_path("doge_bark.wav").c_str());
-  whimper = Mix_LoadWAV(audio_path("doge_whimper.wav").c_str());
-
-  if (background_music == nullptr || space_land == nullptr ||
-      plus_coins == nullptr || minus_coins == nullptr ||
-      next_player == nullptr || dice_roll == nullptr) {
-    fprintf(stderr,
-            "Failed to load sounds make sure the data directory is present");
-    // return nullptr;
-  }
+  // Seeding rng, from the run seed in a deterministic run
+  rng = random_service.engine("board");
+
+  space_land = sound_library.sound("UI_41.wav");
+  plus_coins = sound_library.sound("plus_coin.wav");
+  minus_coins = sound_library.sound("minus_coin.wav");
+  explosion1 = sound_library.sound("explosion_1.wav");
+  powerup1 = sound_library.sound("power_up_1.wav");
+  next_player = sound_library.sound("next_player.wav");
+  dice_roll = sound_library.sound("dice_roll2.wav");
+  dice_hit = sound_library.sound("dice_hit.wav");
+  error = sound_library.sound("error_1.wav");
+  spring = sound_library.sound("spring.wav");
+  bark = sound_library.sound("doge_bark.wav");
+  whimper = sound_library.sound("doge_whimper.wav");
 
   // restart_game();
 }
@@ -50,20 +42,23 @@ BoardWorldSystem::~BoardWorldSystem() {
   // Destroy all created components
   registry->clear_all_components();
   registry = nullptr;
-  renderer = nullptr;
+  meshes = nullptr;
   physics = nullptr;
-  window_manager = nullptr;
+  viewport = nullptr;
+  events = nullptr;
 }
 
 void BoardWorldSystem::init(std::shared_ptr<BoardRegistry> registry,
-                            std::shared_ptr<RenderSystem> renderer,
+                            std::shared_ptr<MeshLibrary> meshes,
                             std::shared_ptr<BoardPhysicsSystem> physics,
-                            std::shared_ptr<WindowManager> window_manager,
+                            std::shared_ptr<Viewport> viewport,
+                            std::shared_ptr<SceneEvents> events,
                             std::function<void()> on_scene_end) {
   this->registry = registry;
-  this->renderer = renderer;
+  this->meshes = meshes;
   this->physics = physics;
-  this->window_manager = window_manager;
+  this->viewport = viewport;
+  this->events = events;
   this->on_game_end_callback_ptr = on_scene_end;
 
   // Set all states to default
@@ -76,9 +71,8 @@ bool BoardWorldSystem::step(float delta) {
   registry->camera.get(camera).cameraTarget =
       registry->transforms.get(current_player).position;
   // Get the screen dimensions
-  auto window = window_manager->get_window();
   int screen_width, screen_height;
-  glfwGetFramebufferSize(window, &screen_width, &screen_height);
+  viewport->get_framebuffer_size(&screen_width, &screen_height);
 
   // Updating window title with points
   std::stringstream title_ss;
@@ -86,14 +80,13 @@ bool BoardWorldSystem::step(float delta) {
 
   title_ss << "Points: " << registry->players.get(current_player).points
            << " Roll Count Left: " << pbm.roll_count_left;
-  glfwSetWindowTitle(window, title_ss.str().c_str());
+  events->set_title(title_ss.str());
 
   // display number of points
   for (uint i = 0; i < registry->players.entities.size(); i++) {
     Entity entity = registry->players.entities[i];
-    renderer->add_text_to_be_rendered(
-        {std::to_string(registry->players.get(entity).points)}, positions[i], 1,
-        vec3(1.0, 1.0, 1.0), RenderSystem::FONTS::LIGHT, 0);
+    events->add_text({std::to_string(registry->players.get(entity).points)},
+                     positions[i], 1, vec3(1.0, 1.0, 1.0), TextFont::LIGHT, 0);
   }
 
   // update player standings
@@ -159,9 +152,8 @@ bool BoardWorldSystem::step(float delta) {
     std::string current_player_text =
         "Player " +
         std::to_string(registry->players.get(current_player).player_id);
-    renderer->add_text_to_be_rendered({current_player_text}, vec2(0.45, 0.43),
-                                      1, vec3(1, 1, 1),
-                                      RenderSystem::FONTS::BOLD, 0);
+    events->add_text({current_player_text}, vec2(0.45, 0.43), 1, vec3(1, 1, 1),
+                     TextFont::BOLD, 0);
   } else {
     screen.screen_brightness = 1.0;
     screen.blur_fullscreen = false;
@@ -247,9 +239,7 @@ bool BoardWorldSystem::step(float delta) {
     anim.animation = 1;
     int roll = rng() % (roll_max - roll_min + 1) + roll_min;
     anim.frame = roll;
-    if (!Mix_Playing(2)) {
-      Mix_PlayChannel(2, dice_roll, 0);
-    }
+    events->play_unless_playing(2, dice_roll, 0);
   } else if (board_state == BOARD_STATE::MOVING ||
              board_state == BOARD_STATE::DICE_HIT_ANIMATION ||
              board_state == BOARD_STATE::PICKING_DIRECTION) {
@@ -272,7 +262,7 @@ bool BoardWorldSystem::step(float delta) {
       board_state = BOARD_STATE::MOVING;
     } else if (board_state == BOARD_STATE::LANDED_ANIMATION) {
       update_active_player();
-      Mix_PlayChannel(2, next_player, 0);
+      events->play(2, next_player, 0);
       board_state = BOARD_STATE::WAITING_CONFIRMATION;
     } else if (board_state == BOARD_STATE::PICKED_ITEM_ANIMATION) {
       board_state = BOARD_STATE::ROLLING;
@@ -304,85 +294,28 @@ bool BoardWorldSystem::step(float delta) {
   }
 
   // HANDLE PARTICLE SYSTEMS
-  auto particleSystemRegistry = registry->particleSystems;
+  auto &particleSystemRegistry = registry->particleSystems;
+  // handle particle's life goals (ie. death, move), each system is a job,
+  // then spawn new ones in order so the rng stays deterministic
+  job_system.parallel_for(
+      particleSystemRegistry.components.size(), 1,
+      [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+          ParticleSystem &ps = particleSystemRegistry.components[i];
+          ps.particles.step(delta, ps.emitter.acceleration);
+        }
+      });
   for (uint i = 0; i < particleSystemRegistry.entities.size(); i++) {
-    // The entity and its collider
     Entity entity = particleSystemRegistry.entities[i];
-    ParticleSystem &ps = registry->particleSystems.get(entity);
+    ParticleSystem &ps = particleSystemRegistry.components[i];
     TransformComponent &transform = registry->transforms.get(entity);
-
-    // increase life
-    ps.life += delta;
-    ps.particleSpawnTimeout -= delta;
-
-    uint numParticlesToSpawn =
-        (int)(-ps.particleSpawnTimeout / ps.spawningRate);
-
-    // printf("there are %d particles in the system\n",
-    // ps.particles_alive.size());
-
-    // handle particle's life goals (ie. death, move)
-    for (uint i = 0; i < ps.particles_alive.size(); i++) {
-      // only look at alive particles
-      if (ps.particles_alive[i] == 1) {
-        ps.particles_life[i] -= delta;
-
-        // handle death
-        if (ps.particles_life[i] < 0) {
-          ps.particles_alive[i] = 0;
-          ps.num_alive -= 1;
-          ps.particles_size[i] = 0;  // hack to not diaply dead particles
-        }
-      }
-      // moved this outside because there is a moment where particles 'die' but
-      // are still displayed and they are completely still handle position
-      // update based on velocity and velocity with acceleration
-      ps.particles_position[i] += ps.particles_velocity[i] * delta / 1000.0f;
-      ps.particles_velocity[i] += ps.particleAcceleration * delta / 1000.0f;
-    }
-
-    // handle particle spawning
-    if (ps.particleSpawnTimeout <= 0 && ps.life < ps.particleSystemLifetime) {
-      for (uint i = 0; i < numParticlesToSpawn; i++) {  // agnostic to fps
-        // note to future me: we can add randomness to spawning position here
-        vec2 pos = transform.position;
-        float randomAngle = ((rng() % ((ps.coneAngle + 1) * 100)) / 100.0f) +
-                            (ps.spawningAngle - ps.coneAngle / 2.0f);
-        // convert angle to vector direction
-        float y = sin(randomAngle * 3.14159 / 180.0f);
-        float x = cos(randomAngle * 3.14159 / 180.0f);
-
-        // choose random velocity to spawn particle in
-        vec2 vel =
-            vec2(x, y) * (ps.initialSpeed *
-                          (1 - ((rng() % 100) / 100.0f) * ps.speedRandomness));
-        // choose random size to spawn particle with
-        float size = ps.particleSize *
-                     (1 - ((rng() % 100) / 100.0f) * ps.particleSizeRandomness);
-        // choose random lifetime for particle
-        float lifetime = ps.initialLifetime *
-                         (1 - ((rng() % 100) / 100.0f) * ps.lifetimeRandomness);
-
-        ps.particles_alive.push_back(1);
-        ps.particles_position.push_back(pos);
-        ps.particles_velocity.push_back(vel);
-        ps.particles_life.push_back(lifetime);
-        ps.particles_size.push_back(size);
-
-        ps.particleSpawnTimeout = ps.spawningRate;
-        ps.num_alive += 1;
-      }
-    }
+    ps.emitter.emit(delta, transform.position, ps.particles, rng);
 
     // handle death of particle system after it expires
-    if (ps.life > ps.particleSystemLifetime && ps.num_alive <= 0) {
+    if (ps.emitter.expired() && ps.particles.empty()) {
       printf("killed particle system\n");
-      ps.particles_alive.clear();
-      ps.particles_position.clear();
-      ps.particles_velocity.clear();
-      ps.particles_size.clear();
-      ps.particles_life.clear();
       registry->remove_all_components_of(entity);
+      i--;  // the last system took its slot
     }
   }
 
@@ -411,14 +344,14 @@ void BoardWorldSystem::restart_game() {
   registry->list_all_components();
 
   // reset the game. This will reset all the mini games
-  createBackground(registry, renderer);
-  board = createBoard(registry, renderer, {100, 200});
+  createBackground(registry, meshes);
+  board = createBoard(registry, meshes, {100, 200});
   this->_generateSpaces();
 
   board_state = BOARD_STATE::WAITING_CONFIRMATION;
 
   // Generate the first player
-  current_player = createDoge(registry, renderer, PLAYER_START_POS);
+  current_player = createDoge(registry, meshes, PLAYER_START_POS);
   registry->activePlayer.clear();
   registry->activePlayer.emplace(current_player);
 
@@ -429,78 +362,78 @@ void BoardWorldSystem::restart_game() {
 
   // UI Creation (will be abstracted away)
   // helpTooltip =
-  //    createUIelement(registry, renderer, {0.36, 0.33}, {250, 250},
+  //    createUIelement(registry, meshes, {0.36, 0.33}, {250, 250},
   //                    TEXTURE_ASSET_ID::HELP_MAINBOARD, 1, 2, 0, 0, 0.0f);
-  dice_info = createUIelement(registry, renderer, {0, -0.25}, {150, 150},
+  dice_info = createUIelement(registry, meshes, {0, -0.25}, {150, 150},
                               TEXTURE_ASSET_ID::DICE, 2, 21, 0, 0, 0);
 
-  p1_info_box = createUIelement(registry, renderer, {-0.4, -0.4}, {200, 100},
+  p1_info_box = createUIelement(registry, meshes, {-0.4, -0.4}, {200, 100},
                                 TEXTURE_ASSET_ID::PLAYER_INFO, 1, 4, 0, 0, 0);
-  p2_info_box = createUIelement(registry, renderer, {0.4, -0.4}, {200, 100},
+  p2_info_box = createUIelement(registry, meshes, {0.4, -0.4}, {200, 100},
                                 TEXTURE_ASSET_ID::PLAYER_INFO, 1, 4, 0, 1, 0);
-  p3_info_box = createUIelement(registry, renderer, {-0.4, 0.4}, {200, 100},
+  p3_info_box = createUIelement(registry, meshes, {-0.4, 0.4}, {200, 100},
                                 TEXTURE_ASSET_ID::PLAYER_INFO, 1, 4, 0, 2, 0);
-  p4_info_box = createUIelement(registry, renderer, {0.4, 0.4}, {200, 100},
+  p4_info_box = createUIelement(registry, meshes, {0.4, 0.4}, {200, 100},
                                 TEXTURE_ASSET_ID::PLAYER_INFO, 1, 4, 0, 3, 0);
   registry->UIpasses.emplace(p1_info_box);
   registry->UIpasses.emplace(p2_info_box);
   registry->UIpasses.emplace(p3_info_box);
   registry->UIpasses.emplace(p4_info_box);
 
-  p1_standing = createUIelement(registry, renderer, {-0.443, -0.4}, {80, 80},
+  p1_standing = createUIelement(registry, meshes, {-0.443, -0.4}, {80, 80},
                                 TEXTURE_ASSET_ID::RANKINGS, 1, 4, 0, 0, 0);
-  p2_standing = createUIelement(registry, renderer, {0.357, -0.4}, {80, 80},
+  p2_standing = createUIelement(registry, meshes, {0.357, -0.4}, {80, 80},
                                 TEXTURE_ASSET_ID::RANKINGS, 1, 4, 0, 0, 0);
-  p3_standing = createUIelement(registry, renderer, {-0.443, 0.4}, {80, 80},
+  p3_standing = createUIelement(registry, meshes, {-0.443, 0.4}, {80, 80},
                                 TEXTURE_ASSET_ID::RANKINGS, 1, 4, 0, 0, 0);
-  p4_standing = createUIelement(registry, renderer, {0.357, 0.4}, {80, 80},
+  p4_standing = createUIelement(registry, meshes, {0.357, 0.4}, {80, 80},
                                 TEXTURE_ASSET_ID::RANKINGS, 1, 4, 0, 0, 0);
   registry->UIpasses.emplace(p1_standing);
   registry->UIpasses.emplace(p2_standing);
   registry->UIpasses.emplace(p3_standing);
   registry->UIpasses.emplace(p4_standing);
 
-  item_1_card = createUIelement(registry, renderer, {-0.2, 0.0}, {200, 250},
+  item_1_card = createUIelement(registry, meshes, {-0.2, 0.0}, {200, 250},
                                 TEXTURE_ASSET_ID::ITEMCARDS, 1, 3, 0, 0, 0);
-  item_2_card = createUIelement(registry, renderer, {0.0, 0.0}, {200, 250},
+  item_2_card = createUIelement(registry, meshes, {0.0, 0.0}, {200, 250},
                                 TEXTURE_ASSET_ID::ITEMCARDS, 1, 3, 0, 1, 0);
-  item_3_card = createUIelement(registry, renderer, {0.2, 0.0}, {200, 250},
+  item_3_card = createUIelement(registry, meshes, {0.2, 0.0}, {200, 250},
                                 TEXTURE_ASSET_ID::ITEMCARDS, 1, 3, 0, 2, 0);
   registry->UIpasses.emplace(item_1_card);
   registry->UIpasses.emplace(item_2_card);
   registry->UIpasses.emplace(item_3_card);
   item_1_display =
-      createUIelement(registry, renderer, {-0.2, -0.03}, {160, 160},
+      createUIelement(registry, meshes, {-0.2, -0.03}, {160, 160},
                       TEXTURE_ASSET_ID::ITEMS, 1, 5, 0, 0, 0);
-  item_2_display = createUIelement(registry, renderer, {0.0, -0.03}, {160, 160},
+  item_2_display = createUIelement(registry, meshes, {0.0, -0.03}, {160, 160},
                                    TEXTURE_ASSET_ID::ITEMS, 1, 5, 0, 0, 0);
-  item_3_display = createUIelement(registry, renderer, {0.2, -0.03}, {160, 160},
+  item_3_display = createUIelement(registry, meshes, {0.2, -0.03}, {160, 160},
                                    TEXTURE_ASSET_ID::ITEMS, 1, 5, 0, 0, 0);
   registry->UIpasses.emplace(item_1_display);
   registry->UIpasses.emplace(item_2_display);
   registry->UIpasses.emplace(item_3_display);
   // Control Text HELP
-  confirm_text = createUIelement(registry, renderer, {0, 0.15}, {480, 60},
+  confirm_text = createUIelement(registry, meshes, {0, 0.15}, {480, 60},
                                  TEXTURE_ASSET_ID::TEXT, 8, 1, 0, 0, 0);
-  back_text = createUIelement(registry, renderer, {0, 0.25}, {480, 60},
+  back_text = createUIelement(registry, meshes, {0, 0.25}, {480, 60},
                               TEXTURE_ASSET_ID::TEXT, 8, 1, 1, 0, 0);
-  dice_text = createUIelement(registry, renderer, {0, 0.15}, {480, 60},
+  dice_text = createUIelement(registry, meshes, {0, 0.15}, {480, 60},
                               TEXTURE_ASSET_ID::TEXT, 8, 1, 2, 0, 0);
-  item_text = createUIelement(registry, renderer, {0, 0.25}, {480, 60},
+  item_text = createUIelement(registry, meshes, {0, 0.25}, {480, 60},
                               TEXTURE_ASSET_ID::TEXT, 8, 1, 3, 0, 0);
   registry->UIpasses.emplace(confirm_text);
   registry->UIpasses.emplace(back_text);
   registry->UIpasses.emplace(dice_text);
   registry->UIpasses.emplace(item_text);
-  save_text = createUIelement(registry, renderer, {0, 0.35}, {480, 60},
+  save_text = createUIelement(registry, meshes, {0, 0.35}, {480, 60},
                               TEXTURE_ASSET_ID::TEXT, 8, 1, 4, 0, 0);
-  load_text = createUIelement(registry, renderer, {0, 0.45}, {480, 60},
+  load_text = createUIelement(registry, meshes, {0, 0.45}, {480, 60},
                               TEXTURE_ASSET_ID::TEXT, 8, 1, 5, 0, 0);
   registry->UIpasses.emplace(save_text);
   registry->UIpasses.emplace(load_text);
 
-  // randomize seed for random calls
-  rng = std::default_random_engine(std::random_device()());
+  // new random sequence for this round, see RandomService
+  rng = random_service.engine("board");
 }
 
 void BoardWorldSystem::handle_sprite_animation(float delta) {
@@ -519,10 +452,7 @@ void BoardWorldSystem::handle_sprite_animation(float delta) {
 }
 
 // Should the game be over ?
-bool BoardWorldSystem::is_over() const {
-  auto window = window_manager->get_window();
-  return bool(glfwWindowShouldClose(window));
-}
+bool BoardWorldSystem::is_over() const { return false; }
 
 // On key callback
 void BoardWorldSystem::on_key(int key, int action, int mod) {
@@ -597,7 +527,7 @@ void BoardWorldSystem::on_key(int key, int action, int mod) {
               count = -1;
               player_count++;
               if (player_count >= registry->players.entities.size()) {
-                load_player = createDoge(registry, renderer, PLAYER_START_POS);
+                load_player = createDoge(registry, meshes, PLAYER_START_POS);
               } else {
                 load_player = registry->players.entities[player_count];
               }
@@ -623,7 +553,7 @@ void BoardWorldSystem::on_key(int key, int action, int mod) {
       if (registry->players.entities.size() < 4) {
         // Just create a new player, to avoid overwrite the actual current
         // player
-        auto temp = createDoge(registry, renderer, PLAYER_START_POS);
+        auto temp = createDoge(registry, meshes, PLAYER_START_POS);
         (void)temp;
       } else {
         printf("4 Players Max\n");
@@ -648,7 +578,7 @@ void BoardWorldSystem::on_key(int key, int action, int mod) {
       } else {
         printf("No item on that slot!\n");
         // play error sfx
-        Mix_PlayChannel(1, error, 0);
+        events->play(1, error, 0);
       }
     }
     if (key == GLFW_KEY_2 && action == GLFW_RELEASE) {
@@ -661,7 +591,7 @@ void BoardWorldSystem::on_key(int key, int action, int mod) {
       } else {
         printf("No item on that slot!\n");
         // play error sfx
-        Mix_PlayChannel(1, error, 0);
+        events->play(1, error, 0);
       }
     }
     if (key == GLFW_KEY_3 && action == GLFW_RELEASE) {
@@ -674,7 +604,7 @@ void BoardWorldSystem::on_key(int key, int action, int mod) {
       } else {
         printf("No item on that slot!\n");
         // play error sfx
-        Mix_PlayChannel(1, error, 0);
+        events->play(1, error, 0);
       }
     }
 
@@ -689,7 +619,7 @@ void BoardWorldSystem::on_key(int key, int action, int mod) {
           pbm.target_space = dir.space1;
           board_state = BOARD_STATE::MOVING;
         } else {
-          Mix_PlayChannel(1, error, 0);
+          events->play(1, error, 0);
         }
       } else {
         pbm.target_space = dir.space1;
@@ -701,7 +631,7 @@ void BoardWorldSystem::on_key(int key, int action, int mod) {
           pbm.target_space = dir.space2;
           board_state = BOARD_STATE::MOVING;
         } else {
-          Mix_PlayChannel(1, error, 0);
+          events->play(1, error, 0);
         }
       } else {
         pbm.target_space = dir.space2;
@@ -713,7 +643,7 @@ void BoardWorldSystem::on_key(int key, int action, int mod) {
           pbm.target_space = dir.space3;
           board_state = BOARD_STATE::MOVING;
         } else {
-          Mix_PlayChannel(1, error, 0);
+          events->play(1, error, 0);
         }
       } else {
         pbm.target_space = dir.space3;
@@ -734,57 +664,57 @@ void BoardWorldSystem::on_key(int key, int action, int mod) {
       roll_min = 1;
 
       board_state = BOARD_STATE::DICE_HIT_ANIMATION;
-      Mix_PlayChannel(1, dice_hit, 0);
+      events->play(1, dice_hit, 0);
       animation_timeout = 300;
     } else if (key == GLFW_KEY_1 && action == GLFW_RELEASE) {
       registry->playerBoardMovements.get(current_player).roll_count_left += 1;
       board_state = BOARD_STATE::DICE_HIT_ANIMATION;
-      Mix_PlayChannel(1, dice_hit, 0);
+      events->play(1, dice_hit, 0);
       animation_timeout = 300;
     } else if (key == GLFW_KEY_2 && action == GLFW_RELEASE) {
       registry->playerBoardMovements.get(current_player).roll_count_left += 2;
       board_state = BOARD_STATE::DICE_HIT_ANIMATION;
-      Mix_PlayChannel(1, dice_hit, 0);
+      events->play(1, dice_hit, 0);
       animation_timeout = 300;
     } else if (key == GLFW_KEY_3 && action == GLFW_RELEASE) {
       registry->playerBoardMovements.get(current_player).roll_count_left += 3;
       board_state = BOARD_STATE::DICE_HIT_ANIMATION;
-      Mix_PlayChannel(1, dice_hit, 0);
+      events->play(1, dice_hit, 0);
       animation_timeout = 300;
     } else if (key == GLFW_KEY_4 && action == GLFW_RELEASE) {
       registry->playerBoardMovements.get(current_player).roll_count_left += 4;
       board_state = BOARD_STATE::DICE_HIT_ANIMATION;
-      Mix_PlayChannel(1, dice_hit, 0);
+      events->play(1, dice_hit, 0);
       animation_timeout = 300;
     } else if (key == GLFW_KEY_5 && action == GLFW_RELEASE) {
       registry->playerBoardMovements.get(current_player).roll_count_left += 5;
       board_state = BOARD_STATE::DICE_HIT_ANIMATION;
-      Mix_PlayChannel(1, dice_hit, 0);
+      events->play(1, dice_hit, 0);
       animation_timeout = 300;
     } else if (key == GLFW_KEY_6 && action == GLFW_RELEASE) {
       registry->playerBoardMovements.get(current_player).roll_count_left += 6;
       board_state = BOARD_STATE::DICE_HIT_ANIMATION;
-      Mix_PlayChannel(1, dice_hit, 0);
+      events->play(1, dice_hit, 0);
       animation_timeout = 300;
     } else if (key == GLFW_KEY_7 && action == GLFW_RELEASE) {
       registry->playerBoardMovements.get(current_player).roll_count_left += 7;
       board_state = BOARD_STATE::DICE_HIT_ANIMATION;
-      Mix_PlayChannel(1, dice_hit, 0);
+      events->play(1, dice_hit, 0);
       animation_timeout = 300;
     } else if (key == GLFW_KEY_8 && action == GLFW_RELEASE) {
       registry->playerBoardMovements.get(current_player).roll_count_left += 8;
       board_state = BOARD_STATE::DICE_HIT_ANIMATION;
-      Mix_PlayChannel(1, dice_hit, 0);
+      events->play(1, dice_hit, 0);
       animation_timeout = 300;
     } else if (key == GLFW_KEY_9 && action == GLFW_RELEASE) {
       registry->playerBoardMovements.get(current_player).roll_count_left += 9;
       board_state = BOARD_STATE::DICE_HIT_ANIMATION;
-      Mix_PlayChannel(1, dice_hit, 0);
+      events->play(1, dice_hit, 0);
       animation_timeout = 300;
     } else if (key == GLFW_KEY_0 && action == GLFW_RELEASE) {
       registry->playerBoardMovements.get(current_player).roll_count_left += 10;
       board_state = BOARD_STATE::DICE_HIT_ANIMATION;
-      Mix_PlayChannel(1, dice_hit, 0);
+      events->play(1, dice_hit, 0);
       animation_timeout = 300;
     } else {
       std::cout << "WARNING: Unknown command" << std::endl;
@@ -818,7 +748,7 @@ void BoardWorldSystem::give_player_random_item() {
 void BoardWorldSystem::use_player_item(ITEMS item) {
   Player &player = registry->players.get(current_player);
   (void)player;
-  Mix_PlayChannel(
+  events->play(
       1, powerup1,
       0);  // eventually will move inside if statements to play unique sfx
   if (item == ITEMS::MEGA_MUSHROOM) {
@@ -859,7 +789,7 @@ void BoardWorldSystem::handle_collisions() {
           // to previous bug, if a player is underneath you when you become big
           // you steal coins from them
           if (!other_player.squished) {
-            Mix_PlayChannel(2, whimper, 0);
+            events->play(2, whimper, 0);
             uint stolen_coins = min(other_player.points, 6);
             player.points += stolen_coins;
             other_player.points -= stolen_coins;
@@ -874,7 +804,7 @@ void BoardWorldSystem::handle_collisions() {
         if (!space.player_stepped_on &&
             (pbm.current_space != pbm.target_space)) {
           if (pbm.current_space != entity_other) {
-            Mix_PlayChannel(0, space_land, 0);
+            events->play(0, space_land, 0);
             pbm.roll_count_left -= space.takes_movement;
           }
           space.player_stepped_on = 1;
@@ -894,8 +824,8 @@ void BoardWorldSystem::handle_collisions() {
 
             printf("Landed on type: %d \n", int(space.type));
             if (space.type == SPACE_TYPE::SPACE_BLUE) {
-              Mix_PlayChannel(2, bark, 1);
-              Mix_PlayChannel(1, plus_coins, 0);
+              events->play(2, bark, 1);
+              events->play(1, plus_coins, 0);
               registry->players.get(current_player).points += 3;
               Entity coinParticle = createParticleSystem(
                   registry, registry->transforms.get(entity_other).position,
@@ -904,18 +834,18 @@ void BoardWorldSystem::handle_collisions() {
               (void)coinParticle;
               animation_timeout = 1000.0f;
             } else if (space.type == SPACE_TYPE::SPACE_RED) {
-              Mix_PlayChannel(1, minus_coins, 0);
-              Mix_PlayChannel(2, whimper, 0);
+              events->play(1, minus_coins, 0);
+              events->play(2, whimper, 0);
               registry->players.get(current_player).points =
                   max(registry->players.get(current_player).points - 3, 0);
             } else if (space.type == SPACE_TYPE::SPACE_MUSHROOM) {
-              Mix_PlayChannel(1, powerup1, 0);
+              events->play(1, powerup1, 0);
               give_player_random_item();
               // Handle mushroom space code here (ie. change game state to let
               // active player get random mushroom)
             } else if (space.type == SPACE_TYPE::SPACE_BOMB) {
-              Mix_PlayChannel(1, explosion1, 0);
-              Mix_PlayChannel(2, whimper, 0);
+              events->play(1, explosion1, 0);
+              events->play(2, whimper, 0);
               registry->players.get(current_player).points =
                   max(registry->players.get(current_player).points - 10, 0);
               // Handle challenge mini-game where we deduct a random amount of
@@ -927,7 +857,7 @@ void BoardWorldSystem::handle_collisions() {
             } else if (space.type == SPACE_TYPE::SPACE_SPRING) {
               // Handle player being launched to the location of another player
               // on the board
-              Mix_PlayChannel(1, spring, 0);
+              events->play(1, spring, 0);
               if (registry->playerBoardMovements.size() > 1) {
                 Entity random_player =
                     registry->playerBoardMovements
@@ -960,8 +890,8 @@ void BoardWorldSystem::handle_collisions() {
               // the Goomba's map on MP4 for an example of this.
             } else if (space.type == SPACE_TYPE::SPACE_FORTUNE) {
               // We win a fortune!
-              Mix_PlayChannel(2, bark, 3);
-              Mix_PlayChannel(1, plus_coins, 0);
+              events->play(2, bark, 3);
+              events->play(1, plus_coins, 0);
               registry->players.get(current_player).points += 24;
               Entity coinParticle = createParticleSystem(
                   registry, registry->transforms.get(entity_other).position,
@@ -1014,115 +944,115 @@ void BoardWorldSystem::update_active_player() {
 }
 
 void BoardWorldSystem::_generateSpaces() {
-  board_start = createSpace(registry, renderer, {1000, 700}, 50, 5);
+  board_start = createSpace(registry, meshes, {1000, 700}, 50, 5);
 
   // main outer ring
-  Entity s01 = createSpace(registry, renderer, {950, 700}, 50, 0);
-  Entity s02 = createSpace(registry, renderer, {900, 700}, 50, 0);
-  Entity s03 = createSpace(registry, renderer, {850, 700}, 50, 0);
-  Entity s04 = createSpace(registry, renderer, {800, 700}, 50, 2);
-  Entity s05 = createSpace(registry, renderer, {750, 700}, 50, 0);
-  Entity s06 = createSpace(registry, renderer, {700, 700}, 50, 0);
-  Entity s07 = createSpace(registry, renderer, {600, 700}, 50, 1);
-  Entity s08 = createSpace(registry, renderer, {550, 700}, 50, 0);
-  Entity s09 = createSpace(registry, renderer, {500, 700}, 50, 2);
-  Entity s10 = createSpace(registry, renderer, {450, 700}, 50, 0);
-  Entity s11 = createSpace(registry, renderer, {400, 700}, 50, 0);
-  Entity s12 = createSpace(registry, renderer, {350, 700}, 50, 1);
-  Entity s13 = createSpace(registry, renderer, {300, 700}, 50, 4);
-  Entity s14 = createSpace(registry, renderer, {250, 700}, 50, 0);
-  Entity s15 = createSpace(registry, renderer, {200, 700}, 50, 0);
-  Entity s16 = createSpace(registry, renderer, {150, 700}, 50, 2);
-  Entity s17 = createSpace(registry, renderer, {100, 700}, 50, 2);
-  Entity s18 = createSpace(registry, renderer, {50, 700}, 50, 0);
-  Entity s19 = createSpace(registry, renderer, {50, 650}, 50, 1);
-  Entity s20 = createSpace(registry, renderer, {50, 600}, 50, 3);
-  Entity s21 = createSpace(registry, renderer, {50, 550}, 50, 0);
-  Entity s22 = createSpace(registry, renderer, {50, 500}, 50, 0);
-  Entity s23 = createSpace(registry, renderer, {50, 450}, 50, 2);
-  Entity s24 = createSpace(registry, renderer, {50, 400}, 50, 1);
-  Entity s25 = createSpace(registry, renderer, {50, 350}, 50, 0);
-  Entity s26 = createSpace(registry, renderer, {50, 300}, 50, 0);
-  Entity s27 = createSpace(registry, renderer, {50, 250}, 50, 0);
-  Entity s28 = createSpace(registry, renderer, {50, 200}, 50, 1);
-  Entity s29 = createSpace(registry, renderer, {50, 150}, 50, 0);
-  Entity s30 = createSpace(registry, renderer, {50, 100}, 50, 5);
-  Entity s31 = createSpace(registry, renderer, {100, 100}, 50, 5);
-  Entity s32 = createSpace(registry, renderer, {150, 100}, 50, 4);
-  Entity s33 = createSpace(registry, renderer, {200, 100}, 50, 0);
-  Entity s34 = createSpace(registry, renderer, {250, 100}, 50, 0);
-  Entity s35 = createSpace(registry, renderer, {300, 100}, 50, 0);
-  Entity s36 = createSpace(registry, renderer, {350, 100}, 50, 0);
-  Entity s37 = createSpace(registry, renderer, {400, 100}, 50, 3);
-  Entity s38 = createSpace(registry, renderer, {450, 100}, 50, 1);
-  Entity s39 = createSpace(registry, renderer, {500, 100}, 50, 0);
-  Entity s40 = createSpace(registry, renderer, {550, 100}, 50, 0);
-  Entity s41 = createSpace(registry, renderer, {600, 100}, 50, 2);
-  // Entity s42 = createSpace(registry, renderer, {650, 100}, 50, 0);
-  Entity s43 = createSpace(registry, renderer, {700, 100}, 50, 0);
-  Entity s44 = createSpace(registry, renderer, {750, 100}, 50, 0);
-  Entity s45 = createSpace(registry, renderer, {800, 100}, 50, 1);
-  Entity s46 = createSpace(registry, renderer, {850, 100}, 50, 0);
-  Entity s47 = createSpace(registry, renderer, {900, 100}, 50, 5);
-  Entity s48 = createSpace(registry, renderer, {950, 100}, 50, 5);
-  Entity s49 = createSpace(registry, renderer, {950, 150}, 50, 0);
-  Entity s50 = createSpace(registry, renderer, {950, 200}, 50, 0);
-  Entity s51 = createSpace(registry, renderer, {950, 250}, 50, 0);
-  Entity s52 = createSpace(registry, renderer, {950, 300}, 50, 2);
-  Entity s53 = createSpace(registry, renderer, {950, 350}, 50, 1);
-  Entity s54 = createSpace(registry, renderer, {950, 450}, 50, 0);
-  Entity s55 = createSpace(registry, renderer, {950, 500}, 50, 4);
-  Entity s56 = createSpace(registry, renderer, {950, 550}, 50, 1);
-  Entity s57 = createSpace(registry, renderer, {950, 600}, 50, 0);
-  Entity s58 = createSpace(registry, renderer, {950, 650}, 50, 2);
+  Entity s01 = createSpace(registry, meshes, {950, 700}, 50, 0);
+  Entity s02 = createSpace(registry, meshes, {900, 700}, 50, 0);
+  Entity s03 = createSpace(registry, meshes, {850, 700}, 50, 0);
+  Entity s04 = createSpace(registry, meshes, {800, 700}, 50, 2);
+  Entity s05 = createSpace(registry, meshes, {750, 700}, 50, 0);
+  Entity s06 = createSpace(registry, meshes, {700, 700}, 50, 0);
+  Entity s07 = createSpace(registry, meshes, {600, 700}, 50, 1);
+  Entity s08 = createSpace(registry, meshes, {550, 700}, 50, 0);
+  Entity s09 = createSpace(registry, meshes, {500, 700}, 50, 2);
+  Entity s10 = createSpace(registry, meshes, {450, 700}, 50, 0);
+  Entity s11 = createSpace(registry, meshes, {400, 700}, 50, 0);
+  Entity s12 = createSpace(registry, meshes, {350, 700}, 50, 1);
+  Entity s13 = createSpace(registry, meshes, {300, 700}, 50, 4);
+  Entity s14 = createSpace(registry, meshes, {250, 700}, 50, 0);
+  Entity s15 = createSpace(registry, meshes, {200, 700}, 50, 0);
+  Entity s16 = createSpace(registry, meshes, {150, 700}, 50, 2);
+  Entity s17 = createSpace(registry, meshes, {100, 700}, 50, 2);
+  Entity s18 = createSpace(registry, meshes, {50, 700}, 50, 0);
+  Entity s19 = createSpace(registry, meshes, {50, 650}, 50, 1);
+  Entity s20 = createSpace(registry, meshes, {50, 600}, 50, 3);
+  Entity s21 = createSpace(registry, meshes, {50, 550}, 50, 0);
+  Entity s22 = createSpace(registry, meshes, {50, 500}, 50, 0);
+  Entity s23 = createSpace(registry, meshes, {50, 450}, 50, 2);
+  Entity s24 = createSpace(registry, meshes, {50, 400}, 50, 1);
+  Entity s25 = createSpace(registry, meshes, {50, 350}, 50, 0);
+  Entity s26 = createSpace(registry, meshes, {50, 300}, 50, 0);
+  Entity s27 = createSpace(registry, meshes, {50, 250}, 50, 0);
+  Entity s28 = createSpace(registry, meshes, {50, 200}, 50, 1);
+  Entity s29 = createSpace(registry, meshes, {50, 150}, 50, 0);
+  Entity s30 = createSpace(registry, meshes, {50, 100}, 50, 5);
+  Entity s31 = createSpace(registry, meshes, {100, 100}, 50, 5);
+  Entity s32 = createSpace(registry, meshes, {150, 100}, 50, 4);
+  Entity s33 = createSpace(registry, meshes, {200, 100}, 50, 0);
+  Entity s34 = createSpace(registry, meshes, {250, 100}, 50, 0);
+  Entity s35 = createSpace(registry, meshes, {300, 100}, 50, 0);
+  Entity s36 = createSpace(registry, meshes, {350, 100}, 50, 0);
+  Entity s37 = createSpace(registry, meshes, {400, 100}, 50, 3);
+  Entity s38 = createSpace(registry, meshes, {450, 100}, 50, 1);
+  Entity s39 = createSpace(registry, meshes, {500, 100}, 50, 0);
+  Entity s40 = createSpace(registry, meshes, {550, 100}, 50, 0);
+  Entity s41 = createSpace(registry, meshes, {600, 100}, 50, 2);
+  // Entity s42 = createSpace(registry, meshes, {650, 100}, 50, 0);
+  Entity s43 = createSpace(registry, meshes, {700, 100}, 50, 0);
+  Entity s44 = createSpace(registry, meshes, {750, 100}, 50, 0);
+  Entity s45 = createSpace(registry, meshes, {800, 100}, 50, 1);
+  Entity s46 = createSpace(registry, meshes, {850, 100}, 50, 0);
+  Entity s47 = createSpace(registry, meshes, {900, 100}, 50, 5);
+  Entity s48 = createSpace(registry, meshes, {950, 100}, 50, 5);
+  Entity s49 = createSpace(registry, meshes, {950, 150}, 50, 0);
+  Entity s50 = createSpace(registry, meshes, {950, 200}, 50, 0);
+  Entity s51 = createSpace(registry, meshes, {950, 250}, 50, 0);
+  Entity s52 = createSpace(registry, meshes, {950, 300}, 50, 2);
+  Entity s53 = createSpace(registry, meshes, {950, 350}, 50, 1);
+  Entity s54 = createSpace(registry, meshes, {950, 450}, 50, 0);
+  Entity s55 = createSpace(registry, meshes, {950, 500}, 50, 4);
+  Entity s56 = createSpace(registry, meshes, {950, 550}, 50, 1);
+  Entity s57 = createSpace(registry, meshes, {950, 600}, 50, 0);
+  Entity s58 = createSpace(registry, meshes, {950, 650}, 50, 2);
 
   // middle of board
-  Entity s59 = createSpace(registry, renderer, {650, 650}, 50, 1);
-  Entity s60 = createSpace(registry, renderer, {650, 600}, 50, 0);
-  Entity s61 = createSpace(registry, renderer, {650, 550}, 50, 0);
-  Entity s62 = createSpace(registry, renderer, {650, 500}, 50, 2);
-  Entity s63 = createSpace(registry, renderer, {650, 450}, 50, 0);
-  Entity s64 = createSpace(registry, renderer, {650, 400}, 50, 0);
-  Entity s65 = createSpace(registry, renderer, {600, 400}, 50, 0);
-  Entity s66 = createSpace(registry, renderer, {550, 400}, 50, 4);
-  Entity s67 = createSpace(registry, renderer, {500, 400}, 50, 1);
-  Entity s68 = createSpace(registry, renderer, {450, 400}, 50, 2);
-  Entity s69 = createSpace(registry, renderer, {400, 400}, 50, 2);
-  Entity s70 = createSpace(registry, renderer, {300, 400}, 50, 1);
-  Entity s71 = createSpace(registry, renderer, {250, 400}, 50, 0);
-  Entity s72 = createSpace(registry, renderer, {200, 400}, 50, 3);
-  Entity s73 = createSpace(registry, renderer, {150, 400}, 50, 0);
-  Entity s74 = createSpace(registry, renderer, {100, 400}, 50, 0);
-
-  Entity s75 = createSpace(registry, renderer, {350, 450}, 50, 0);
-  Entity s76 = createSpace(registry, renderer, {350, 500}, 50, 0);
-  Entity s77 = createSpace(registry, renderer, {350, 550}, 50, 2);
-  Entity s78 = createSpace(registry, renderer, {350, 600}, 50, 0);
-  Entity s79 = createSpace(registry, renderer, {350, 650}, 50, 0);
-
-  Entity s80 = createSpace(registry, renderer, {350, 300}, 50, 6);
-  Entity s81 = createSpace(registry, renderer, {350, 250}, 50, 6);
-  Entity s82 = createSpace(registry, renderer, {350, 200}, 50, 3);
-  Entity s83 = createSpace(registry, renderer, {350, 150}, 50, 0);
-
-  Entity s84 = createSpace(registry, renderer, {650, 150}, 50, 2);
-  Entity s85 = createSpace(registry, renderer, {650, 200}, 50, 2);
-  Entity s86 = createSpace(registry, renderer, {650, 300}, 50, 0);
-  Entity s87 = createSpace(registry, renderer, {650, 350}, 50, 1);
-
-  Entity s88 = createSpace(registry, renderer, {750, 250}, 50, 6);
-  Entity s89 = createSpace(registry, renderer, {800, 250}, 50, 6);
-  Entity s90 = createSpace(registry, renderer, {850, 250}, 50, 6);
-  Entity s91 = createSpace(registry, renderer, {900, 250}, 50, 3);
-
-  Entity s92 = createSpace(registry, renderer, {900, 400}, 50, 2);
-  Entity s93 = createSpace(registry, renderer, {850, 400}, 50, 0);
-  Entity s94 = createSpace(registry, renderer, {800, 400}, 50, 0);
-  Entity s95 = createSpace(registry, renderer, {750, 400}, 50, 1);
-  Entity s96 = createSpace(registry, renderer, {700, 400}, 50, 0);
+  Entity s59 = createSpace(registry, meshes, {650, 650}, 50, 1);
+  Entity s60 = createSpace(registry, meshes, {650, 600}, 50, 0);
+  Entity s61 = createSpace(registry, meshes, {650, 550}, 50, 0);
+  Entity s62 = createSpace(registry, meshes, {650, 500}, 50, 2);
+  Entity s63 = createSpace(registry, meshes, {650, 450}, 50, 0);
+  Entity s64 = createSpace(registry, meshes, {650, 400}, 50, 0);
+  Entity s65 = createSpace(registry, meshes, {600, 400}, 50, 0);
+  Entity s66 = createSpace(registry, meshes, {550, 400}, 50, 4);
+  Entity s67 = createSpace(registry, meshes, {500, 400}, 50, 1);
+  Entity s68 = createSpace(registry, meshes, {450, 400}, 50, 2);
+  Entity s69 = createSpace(registry, meshes, {400, 400}, 50, 2);
+  Entity s70 = createSpace(registry, meshes, {300, 400}, 50, 1);
+  Entity s71 = createSpace(registry, meshes, {250, 400}, 50, 0);
+  Entity s72 = createSpace(registry, meshes, {200, 400}, 50, 3);
+  Entity s73 = createSpace(registry, meshes, {150, 400}, 50, 0);
+  Entity s74 = createSpace(registry, meshes, {100, 400}, 50, 0);
+
+  Entity s75 = createSpace(registry, meshes, {350, 450}, 50, 0);
+  Entity s76 = createSpace(registry, meshes, {350, 500}, 50, 0);
+  Entity s77 = createSpace(registry, meshes, {350, 550}, 50, 2);
+  Entity s78 = createSpace(registry, meshes, {350, 600}, 50, 0);
+  Entity s79 = createSpace(registry, meshes, {350, 650}, 50, 0);
+
+  Entity s80 = createSpace(registry, meshes, {350, 300}, 50, 6);
+  Entity s81 = createSpace(registry, meshes, {350, 250}, 50, 6);
+  Entity s82 = createSpace(registry, meshes, {350, 200}, 50, 3);
+  Entity s83 = createSpace(registry, meshes, {350, 150}, 50, 0);
+
+  Entity s84 = createSpace(registry, meshes, {650, 150}, 50, 2);
+  Entity s85 = createSpace(registry, meshes, {650, 200}, 50, 2);
+  Entity s86 = createSpace(registry, meshes, {650, 300}, 50, 0);
+  Entity s87 = createSpace(registry, meshes, {650, 350}, 50, 1);
+
+  Entity s88 = createSpace(registry, meshes, {750, 250}, 50, 6);
+  Entity s89 = createSpace(registry, meshes, {800, 250}, 50, 6);
+  Entity s90 = createSpace(registry, meshes, {850, 250}, 50, 6);
+  Entity s91 = createSpace(registry, meshes, {900, 250}, 50, 3);
+
+  Entity s92 = createSpace(registry, meshes, {900, 400}, 50, 2);
+  Entity s93 = createSpace(registry, meshes, {850, 400}, 50, 0);
+  Entity s94 = createSpace(registry, meshes, {800, 400}, 50, 0);
+  Entity s95 = createSpace(registry, meshes, {750, 400}, 50, 1);
+  Entity s96 = createSpace(registry, meshes, {700, 400}, 50, 0);
 
   // direction spaces
-  Entity d1 = createSpace(registry, renderer, {650, 700}, 50, 7);
+  Entity d1 = createSpace(registry, meshes, {650, 700}, 50, 7);
   Space &d1s = registry->spaces.get(d1);
   d1s.takes_movement = 0;
   DirectionSpace &d1c = registry->directionSpaces.emplace(d1);
@@ -1131,7 +1061,7 @@ void BoardWorldSystem::_generateSpaces() {
   d1c.space2 = s59;
   d1c.space2_key = GLFW_KEY_UP;
 
-  Entity d2 = createSpace(registry, renderer, {350, 400}, 50, 7);
+  Entity d2 = createSpace(registry, meshes, {350, 400}, 50, 7);
   Space &d2s = registry->spaces.get(d2);
   d2s.takes_movement = 0;
   DirectionSpace &d2c = registry->directionSpaces.emplace(d2);
@@ -1143,7 +1073,7 @@ void BoardWorldSystem::_generateSpaces() {
   d2c.space3 = s75;
   d2c.space3_key = GLFW_KEY_DOWN;
 
-  Entity d3 = createSpace(registry, renderer, {650, 100}, 50, 7);
+  Entity d3 = createSpace(registry, meshes, {650, 100}, 50, 7);
   Space &d3s = registry->spaces.get(d3);
   d3s.takes_movement = 0;
   DirectionSpace &d3c = registry->directionSpaces.emplace(d3);
@@ -1152,7 +1082,7 @@ void BoardWorldSystem::_generateSpaces() {
   d3c.space2 = s84;
   d3c.space2_key = GLFW_KEY_DOWN;
 
-  Entity d4 = createSpace(registry, renderer, {950, 400}, 50, 7);
+  Entity d4 = createSpace(registry, meshes, {950, 400}, 50, 7);
   Space &d4s = registry->spaces.get(d4);
   d4s.takes_movement = 0;
   DirectionSpace &d4c = registry->directionSpaces.emplace(d4);
@@ -1161,7 +1091,7 @@ void BoardWorldSystem::_generateSpaces() {
   d4c.space2 = s92;
   d4c.space2_key = GLFW_KEY_LEFT;
 
-  Entity d5 = createSpace(registry, renderer, {650, 250}, 50, 7);
+  Entity d5 = createSpace(registry, meshes, {650, 250}, 50, 7);
   Space &d5s = registry->spaces.get(d5);
   d5s.takes_movement = 0;
   DirectionSpace &d5c = registry->directionSpaces.emplace(d5);
@@ -7,14 +7,9 @@
 #include <random>
 #include <vector>
 
-#define SDL_MAIN_HANDLED
-#include <SDL.h>
-#include <SDL_mixer.h>
-
 #include "../registry.hpp"
 #include "physics_system.hpp"
-#include "render_system.hpp"
-#include "window_manager.hpp"
+#include "scene_io.hpp"
 
 // Container for all our entities and game logic. Individual rendering / update
 // is deferred to the relative update() methods
@@ -24,9 +19,10 @@ class BoardWorldSystem {
 
   // starts the game
   void init(std::shared_ptr<BoardRegistry> registry,
-            std::shared_ptr<RenderSystem> renderer,
+            std::shared_ptr<MeshLibrary> meshes,
             std::shared_ptr<BoardPhysicsSystem> physics,
-            std::shared_ptr<WindowManager> window_manager,
+            std::shared_ptr<Viewport> viewport,
+            std::shared_ptr<SceneEvents> events,
             std::function<void()> on_scene_end);
 
   // Releases all associated resources
@@ -53,7 +49,8 @@ class BoardWorldSystem {
   // holds the scene state
   std::shared_ptr<BoardRegistry> registry;
 
-  std::shared_ptr<WindowManager> window_manager;
+  std::shared_ptr<Viewport> viewport;
+  std::shared_ptr<SceneEvents> events;
 
   // C++ random number generator
   std::default_random_engine rng;
@@ -65,7 +62,7 @@ class BoardWorldSystem {
   void update_active_player();
 
   Entity current_player;
-  std::shared_ptr<RenderSystem> renderer;
+  std::shared_ptr<MeshLibrary> meshes;
   std::shared_ptr<BoardPhysicsSystem> physics;
 
   void _generateSpaces();
@@ -110,19 +107,18 @@ class BoardWorldSystem {
   vec2 mega_scale = {100, 100};
   vec2 mini_scale = {30, 30};
   // Audio
-  Mix_Music *background_music;
-  Mix_Chunk *space_land;
-  Mix_Chunk *plus_coins;
-  Mix_Chunk *minus_coins;
-  Mix_Chunk *explosion1;
-  Mix_Chunk *powerup1;
-  Mix_Chunk *next_player;
-  Mix_Chunk *dice_roll;
-  Mix_Chunk *dice_hit;
-  Mix_Chunk *error;
-  Mix_Chunk *spring;
-  Mix_Chunk *bark;
-  Mix_Chunk *whimper;
+  Sound space_land;
+  Sound plus_coins;
+  Sound minus_coins;
+  Sound explosion1;
+  Sound powerup1;
+  Sound next_player;
+  Sound dice_roll;
+  Sound dice_hit;
+  Sound error;
+  Sound spring;
+  Sound bark;
+  Sound whimper;
 
   enum class BOARD_STATE {
     WAITING_CONFIRMATION,
@@ -31,13 +31,31 @@ void DaycareScene::init(std::shared_ptr<WindowManager> window_manager,
 
   registry->clear_all_components();
 
-  int window_width, window_height;
-  glfwGetFramebufferSize(window_manager->get_window(), &window_width,
-                         &window_height);
+  window_manager->get_framebuffer_size(&window_width, &window_height);
   assert(renderer->init(registry, window_width, window_height,
                         window_manager->get_window()));
   world->init(registry, renderer, physics, window_manager, [&]() { end(); });
   physics->init(registry);
+  // The bars and the animations touch different components, they run at the
+  // same time after the physics moved the puppies
+  systems.clear();
+  systems.add_exclusive("world", [this](float delta) { world->step(delta); });
+  systems.add("physics", {},
+              {&registry->transforms, &registry->velocities,
+               &registry->targets, &registry->sleepers, &registry->stillness},
+              [this](float delta) {
+                physics->step(delta, window_width, window_height);
+              });
+  systems.add("progress bars", {&registry->progressBars, &registry->chewToys},
+              {&registry->puppies, &registry->foodBowls,
+               &registry->waterBowls, &registry->transforms},
+              [this](float delta) { world->update_progress_bars(delta); });
+  systems.add("sprite animation", {&registry->velocities},
+              {&registry->spriteAnimations},
+              [this](float delta) { world->handle_sprite_animation(delta); });
+  systems.add("bowls", {&registry->foodBowls, &registry->waterBowls},
+              {&registry->renderRequests},
+              [this](float) { world->update_bowls(); });
 
   renderer->add_text_to_be_rendered({"Loading Game ....."}, vec2(0.38, 0.45), 1,
                                     vec3(1, 1, 0),
@@ -46,30 +64,44 @@ void DaycareScene::init(std::shared_ptr<WindowManager> window_manager,
   ScreenState &screen = registry->screenStates.components[0];
   screen.screen_brightness = 1.0;
   renderer->render_text_only(vec3(0.133, 0.224, 0.722));
+  renderer->clear_text();
   screen.screen_brightness = 1.0;
 }
 
 bool DaycareScene::step(float delta) {
-  int window_width, window_height;
-  glfwGetFramebufferSize(window_manager->get_window(), &window_width,
-                         &window_height);
+  // keep the poses before this step for interpolation, and only this step's
+  // text
+  registry->snapshot_transforms();
+  renderer->clear_text();
 
-  // step forward systems
-  world->step(delta);
-  physics->step(delta, window_width, window_height);
-  world->handle_sprite_animation(delta);
+  window_manager->get_framebuffer_size(&window_width, &window_height);
 
-  renderer->draw();
+  // step forward systems
+  systems.step(delta);
 
   return true;
 }
 
+void DaycareScene::publish() { renderer->publish(); }
+
+void DaycareScene::draw() { renderer->draw(); }
+
 void DaycareScene::reset_scene() { world->restart_game(); }
 
+void DaycareScene::prepare() { world->prepare_round(); }
+
 void DaycareScene::on_key(int key, int action, int mod) {
   world->on_key(key, action, mod);
 }
 
 void DaycareScene::on_mouse_move(vec2 pos) { world->on_mouse_move(pos); }
 
+void DaycareScene::on_mouse_path(const std::vector<vec2> &path) {
+  world->on_mouse_path(path);
+}
+
+uint64_t DaycareScene::state_hash() { return registry->state_hash(); }
+
+SleepStats DaycareScene::sleep_stats() { return physics->sleep_stats(); }
+
 void DaycareScene::end() { on_scene_end_callback_ptr(*registry); }
@@ -5,6 +5,7 @@
 #include <vector>
 
 // internal
+#include "system_scheduler.hpp"
 #include "window_manager.hpp"
 
 // base class
@@ -32,15 +33,33 @@ class DaycareScene : public Scene {
   // steps the scene ahead by delta (in milliseconds)
   bool step(float delta);
 
+  // see Scene::publish
+  void publish();
+
+  // renders the last step, see Scene::draw
+  void draw();
+
   // resets the board
   void reset_scene();
 
+  // see Scene::prepare
+  void prepare();
+
   // input callback for mouse and key presses
   void on_key(int key, int action, int mod);
 
   // input callback for mouse movement
   void on_mouse_move(vec2 pos);
 
+  // see Scene::on_mouse_path
+  void on_mouse_path(const std::vector<vec2> &path);
+
+  // see Scene::state_hash
+  uint64_t state_hash();
+
+  // see Scene::sleep_stats
+  SleepStats sleep_stats();
+
  private:
   // holds the scene state
   std::shared_ptr<DaycareRegistry> registry;
@@ -52,6 +71,11 @@ class DaycareScene : public Scene {
   std::shared_ptr<DaycarePhysicsSystem> physics;
   std::shared_ptr<RenderSystem> renderer;
 
+  // runs the systems in the order init added them
+  SystemScheduler systems;
+  // framebuffer size of the current step
+  int window_width = 0, window_height = 0;
+
   // callback called when the scene ends
   std::function<void(DaycareRegistry)> on_scene_end_callback_ptr;
 
@@ -3,6 +3,7 @@
 
 #include <iostream>
 
+#include "body_sleep.hpp"
 #include "world_init.hpp"
 
 void DaycarePhysicsSystem::init(std::shared_ptr<DaycareRegistry> registry) {
@@ -10,10 +11,12 @@ void DaycarePhysicsSystem::init(std::shared_ptr<DaycareRegistry> registry) {
 }
 
 void DaycarePhysicsSystem::step(float delta, float vw, float vh) {
+  last_sleep_stats = update_sleeping_bodies(*registry);
+
   for (int i = 0; i < registry->velocities.size(); i++) {
     auto puppy = registry->velocities.entities[i];
 
-    if (!registry->targets.has(puppy)) {
+    if (!registry->targets.has(puppy) || is_asleep(*registry, puppy)) {
       continue;
     }
 
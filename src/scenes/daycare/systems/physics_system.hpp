@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "../registry.hpp"
+#include "body_sleep.hpp"
 #include "common.hpp"
 #include "components.hpp"
 #include "tiny_ecs.hpp"
@@ -18,7 +19,11 @@ class DaycarePhysicsSystem {
 
   void step(float delta, float window_width, float window_height);
 
+  // bodies awake and asleep in the last step, see update_sleeping_bodies
+  SleepStats sleep_stats() const { return last_sleep_stats; }
+
  private:
   // holds the scene state
   std::shared_ptr<DaycareRegistry> registry;
+  SleepStats last_sleep_stats;
 };
\ No newline at end of file
@@ -39,9 +39,9 @@ Entity createCircle(std::shared_ptr<DaycareRegistry> registry, vec2 pos,
 }
 
 Entity createBackground(std::shared_ptr<DaycareRegistry> registry,
-                        std::shared_ptr<RenderSystem> renderer, vec2 position) {
+                        std::shared_ptr<MeshLibrary> meshes, vec2 position) {
   auto entity = Entity();
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Initialize the position, scale, and physics components
@@ -56,14 +56,17 @@ Entity createBackground(std::shared_ptr<DaycareRegistry> registry,
       entity, {TEXTURE_ASSET_ID::BKGD_DAYCARE, EFFECT_ASSET_ID::TEXTURED,
                GEOMETRY_BUFFER_ID::SPRITE});
 
+  // the background never moves, draw it from the cached static layer
+  registry->staticLayers.emplace(entity);
+
   return entity;
 }
 
 Entity createGesturePath(std::shared_ptr<DaycareRegistry> registry,
-                         std::shared_ptr<RenderSystem> renderer,
+                         std::shared_ptr<MeshLibrary> meshes,
                          vec2 position) {
   auto entity = Entity();
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Initialize the position, scale, and physics components
@@ -82,11 +85,11 @@ Entity createGesturePath(std::shared_ptr<DaycareRegistry> registry,
 }
 
 Entity createDoge(std::shared_ptr<DaycareRegistry> registry,
-                  std::shared_ptr<RenderSystem> renderer, vec2 pos) {
+                  std::shared_ptr<MeshLibrary> meshes, vec2 pos) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Setting initial motion values
@@ -112,11 +115,11 @@ Entity createDoge(std::shared_ptr<DaycareRegistry> registry,
 }
 
 Entity createChewToys(std::shared_ptr<DaycareRegistry> registry,
-                      std::shared_ptr<RenderSystem> renderer, vec2 pos) {
+                      std::shared_ptr<MeshLibrary> meshes, vec2 pos) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Setting initial motion values
@@ -137,11 +140,11 @@ Entity createChewToys(std::shared_ptr<DaycareRegistry> registry,
 }
 
 Entity createFoodBowl(std::shared_ptr<DaycareRegistry> registry,
-                      std::shared_ptr<RenderSystem> renderer, vec2 pos) {
+                      std::shared_ptr<MeshLibrary> meshes, vec2 pos) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Setting initial motion values
@@ -162,11 +165,11 @@ Entity createFoodBowl(std::shared_ptr<DaycareRegistry> registry,
 }
 
 Entity createWaterBowl(std::shared_ptr<DaycareRegistry> registry,
-                       std::shared_ptr<RenderSystem> renderer, vec2 pos) {
+                       std::shared_ptr<MeshLibrary> meshes, vec2 pos) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Setting initial motion values
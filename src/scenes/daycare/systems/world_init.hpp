@@ -5,7 +5,7 @@
 
 #include "../registry.hpp"
 #include "common.hpp"
-#include "render_system.hpp"
+#include "scene_io.hpp"
 #include "tiny_ecs.hpp"
 
 // a red line for debugging purposes
@@ -17,19 +17,19 @@ Entity createCircle(std::shared_ptr<DaycareRegistry> registry, vec2 pos,
                     vec2 size);
 
 Entity createBackground(std::shared_ptr<DaycareRegistry> registry,
-                        std::shared_ptr<RenderSystem> renderer, vec2 position);
+                        std::shared_ptr<MeshLibrary> meshes, vec2 position);
 
 Entity createGesturePath(std::shared_ptr<DaycareRegistry> registry,
-                         std::shared_ptr<RenderSystem> renderer, vec2 position);
+                         std::shared_ptr<MeshLibrary> meshes, vec2 position);
 
 Entity createDoge(std::shared_ptr<DaycareRegistry> registry,
-                  std::shared_ptr<RenderSystem> renderer, vec2 pos);
+                  std::shared_ptr<MeshLibrary> meshes, vec2 pos);
 
 Entity createChewToys(std::shared_ptr<DaycareRegistry> registry,
-                      std::shared_ptr<RenderSystem> renderer, vec2 pos);
+                      std::shared_ptr<MeshLibrary> meshes, vec2 pos);
 
 Entity createFoodBowl(std::shared_ptr<DaycareRegistry> registry,
-                      std::shared_ptr<RenderSystem> renderer, vec2 pos);
+                      std::shared_ptr<MeshLibrary> meshes, vec2 pos);
 
 Entity createWaterBowl(std::shared_ptr<DaycareRegistry> registry,
-                       std::shared_ptr<RenderSystem> renderer, vec2 pos);
+                       std::shared_ptr<MeshLibrary> meshes, vec2 pos);
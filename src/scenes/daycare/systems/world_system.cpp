@@ -13,7 +13,7 @@
 #include <string>
 
 #include "physics_system.hpp"
-#include "window_manager.hpp"
+#include "random_service.hpp"
 
 // Game configuration
 const int NUM_PUPPIES = 5;
@@ -41,8 +41,8 @@ vec2 cached_bowl_position;
 vec2 last_mouse_pos = vec2(0.f, 0.f);
 
 DaycareWorldSystem::DaycareWorldSystem() {
-  // Seeding rng with random device
-  rng = std::default_random_engine(std::random_device()());
+  // Seeding rng, from the run seed in a deterministic run
+  rng = random_service.engine("daycare");
 }
 
 DaycareWorldSystem::~DaycareWorldSystem() {
@@ -50,21 +50,21 @@ DaycareWorldSystem::~DaycareWorldSystem() {
   registry->clear_all_components();
 
   // clean up all the shared pointers
-  renderer = nullptr;
+  meshes = nullptr;
   registry = nullptr;
   physics = nullptr;
-  window_manager = nullptr;
+  viewport = nullptr;
 }
 
 void DaycareWorldSystem::init(std::shared_ptr<DaycareRegistry> registry,
-                              std::shared_ptr<RenderSystem> renderer,
+                              std::shared_ptr<MeshLibrary> meshes,
                               std::shared_ptr<DaycarePhysicsSystem> physics,
-                              std::shared_ptr<WindowManager> window_manager,
+                              std::shared_ptr<Viewport> viewport,
                               std::function<void()> on_scene_end) {
   this->registry = registry;
-  this->renderer = renderer;
+  this->meshes = meshes;
   this->physics = physics;
-  this->window_manager = window_manager;
+  this->viewport = viewport;
   this->on_game_end_callback_ptr = on_scene_end;
 
   // Set all states to default
@@ -225,17 +225,16 @@ void DaycareWorldSystem::update_debug_lines(float delta) {
 // Update our game world
 bool DaycareWorldSystem::step(float delta) {
   // Get the screen dimensions
-  auto window = window_manager->get_window();
   int screen_width, screen_height;
-  glfwGetFramebufferSize(window, &screen_width, &screen_height);
+  viewport->get_framebuffer_size(&screen_width, &screen_height);
 
   // add step functions here
 
   handle_collisions();
 
+  // the progress bars and bowls are systems of their own, see
+  // DaycareScene::init
   update_debug_lines(delta);
-  update_progress_bars(delta);
-  update_bowls();
 
   game_time += delta;
   if (game_time > GAME_DURATION) {
@@ -248,7 +247,7 @@ bool DaycareWorldSystem::step(float delta) {
 
 vec2 DaycareWorldSystem::get_random_window_position(vec2 offset) {
   int vw, vh;
-  glfwGetFramebufferSize(window_manager->get_window(), &vw, &vh);
+  viewport->get_framebuffer_size(&vw, &vh);
 
   float x = vw * uniform_dist(rng);
   float y = vh * uniform_dist(rng);
@@ -258,7 +257,7 @@ vec2 DaycareWorldSystem::get_random_window_position(vec2 offset) {
 
 void DaycareWorldSystem::initializeEntities() {
   int vw, vh;
-  glfwGetFramebufferSize(window_manager->get_window(), &vw, &vh);
+  viewport->get_framebuffer_size(&vw, &vh);
 
   for (int i = 0; i < 10; i++) {
     float dx = GESTURE_MIDDLE.x - GESTURE_START.x;
@@ -280,10 +279,10 @@ void DaycareWorldSystem::initializeEntities() {
     float radius = 15;
     auto pos = get_random_window_position({radius, radius});
     auto size = vec2(radius * 2, radius * 2);
-    auto puppy = createDoge(registry, renderer, pos);
+    auto puppy = createDoge(staging, meshes, pos);
 
-    registry->puppies.emplace(puppy);
-    registry->velocities.emplace(puppy);
+    staging->puppies.emplace(puppy);
+    staging->velocities.emplace(puppy);
 
     // draw debug lines
     for (int j = 0; j < 8; j++) {
@@ -292,89 +291,84 @@ void DaycareWorldSystem::initializeEntities() {
       vec2 linePos;
       linePos.x = pos.x + radius * cos(rot);
       linePos.y = pos.y - radius * sin(rot);
-      auto line = createCircle(registry, linePos, {radius * 2, 2});
-      registry->debugLines.emplace(line);
+      auto line = createCircle(staging, linePos, {radius * 2, 2});
+      staging->debugLines.emplace(line);
 
       // update rotation
-      auto transform = &registry->transforms.get(line);
+      auto transform = &staging->transforms.get(line);
       transform->rotation = -rot;
 
       // set color
-      auto color = &registry->colors.emplace(line);
+      auto color = &staging->colors.emplace(line);
       *color = vec3(0, 0, 1);
 
       if (!debugging.in_debug_mode) {
-        registry->renderRequests.remove(line);
+        staging->renderRequests.remove(line);
       }
     }
 
     auto lineScale = vec2(radius * 2, radius / 3);
 
     auto eatLinePos = pos - vec2(0.f, radius / 2 + lineScale.y);
-    auto eatLine = createCircle(registry, eatLinePos, lineScale);
-    registry->colors.insert(eatLine, {0, 1, 0});
-    auto& eatProgress = registry->progressBars.emplace(eatLine);
+    auto eatLine = createCircle(staging, eatLinePos, lineScale);
+    staging->colors.insert(eatLine, {0, 1, 0});
+    auto& eatProgress = staging->progressBars.emplace(eatLine);
     eatProgress.type = DC_ACTIVITY::EATING;
 
     auto drinkLinePos = eatLinePos - vec2(0.f, lineScale.y);
-    auto drinkLine = createCircle(registry, drinkLinePos, lineScale);
-    registry->colors.insert(drinkLine, {0, 0, 1});
-    auto& drinkProgress = registry->progressBars.emplace(drinkLine);
+    auto drinkLine = createCircle(staging, drinkLinePos, lineScale);
+    staging->colors.insert(drinkLine, {0, 0, 1});
+    auto& drinkProgress = staging->progressBars.emplace(drinkLine);
     drinkProgress.type = DC_ACTIVITY::DRINKING;
 
     auto playLinePos = drinkLinePos - vec2(0.f, lineScale.y);
-    auto playLine = createCircle(registry, playLinePos, lineScale);
-    registry->colors.insert(playLine, {1, 0, 0});
-    auto& playProgres = registry->progressBars.emplace(playLine);
+    auto playLine = createCircle(staging, playLinePos, lineScale);
+    staging->colors.insert(playLine, {1, 0, 0});
+    auto& playProgres = staging->progressBars.emplace(playLine);
     playProgres.type = DC_ACTIVITY::PLAYING;
   }
 
   for (int i = 0; i < NUM_CHEW_TOYS; i++) {
     float radius = 30;
     auto pos = get_random_window_position({radius, radius});
-    createChewToys(registry, renderer, pos);
+    createChewToys(staging, meshes, pos);
   }
 
   for (int i = 0; i < NUM_CHEW_TOYS; i++) {
     float radius = 30;
     auto pos = get_random_window_position({radius, radius});
-    createFoodBowl(registry, renderer, pos);
+    createFoodBowl(staging, meshes, pos);
   }
 
   for (int i = 0; i < NUM_WATER_BOWLS; i++) {
     float radius = 30;
     auto pos = get_random_window_position({radius, radius});
-    createWaterBowl(registry, renderer, pos);
+    createWaterBowl(staging, meshes, pos);
   }
 }
 
 // Reset the world state to its initial state
 void DaycareWorldSystem::restart_game() {
-  int vw, vh;
-  glfwGetFramebufferSize(window_manager->get_window(), &vw, &vh);
-
-  if (registry->camera.size() == 0) {
-    camera = Entity();
-    Camera* cam = &registry->camera.emplace(camera);
-    cam->cameraPosition = vec2(vw / 2, vh / 2);
-    cam->cameraTarget = vec2(vw / 2, vh / 2);
-    cam->cameraFOV = vec2(vw, vh);
-  }
-  // Debugging for memory/component leaks
-  registry->list_all_components();
-  printf("Restarting\n");
+  if (!round_prepared) prepare_round();
+  registry->swap_components(*staging);
+  round_prepared = false;
+}
 
-  // Remove all entities that we created
-  // All that have a motion, we could also iterate over all fish, turtles, ...
-  // but that would be more cumbersome
-  while (registry->transforms.entities.size() > 0)
-    registry->remove_all_components_of(registry->transforms.entities.back());
+// Build the initial entities of the next round into the staging registry
+void DaycareWorldSystem::prepare_round() {
+  staging->clear_all_components();
+
+  int vw, vh;
+  viewport->get_framebuffer_size(&vw, &vh);
 
-  // Debugging for memory/component leaks
-  registry->list_all_components();
+  camera = Entity();
+  Camera* cam = &staging->camera.emplace(camera);
+  cam->cameraPosition = vec2(vw / 2, vh / 2);
+  cam->cameraTarget = vec2(vw / 2, vh / 2);
+  cam->cameraFOV = vec2(vw, vh);
 
-  // randomize seed for random calls. Without this, the random is predictable
-  rng = std::default_random_engine(std::random_device()());
+  // new random sequence for this round, see RandomService
+  rng = random_service.engine("daycare");
 
   // reset the clock
   game_time = 0;
@@ -384,8 +378,10 @@ void DaycareWorldSystem::restart_game() {
   gesture_points.clear();
 
   // draw all the assets
-  createBackground(registry, renderer, {720, 540});
+  createBackground(staging, meshes, {720, 540});
   initializeEntities();
+
+  round_prepared = true;
 }
 
 void DaycareWorldSystem::handle_sprite_animation(float delta) {
@@ -498,7 +494,7 @@ void DaycareWorldSystem::on_key(int key, int action, int mod) {
             registry->waterBowls.has(closest)) {
           auto transform = registry->transforms.get(closest);
           cached_bowl_position = transform.position;
-          createGesturePath(registry, renderer, {600, 337.5});
+          createGesturePath(registry, meshes, {600, 337.5});
         }
       }
     }
@@ -515,6 +511,11 @@ void DaycareWorldSystem::on_key(int key, int action, int mod) {
 }
 
 void DaycareWorldSystem::on_mouse_move(vec2 mouse_position) {
+  on_mouse_path({mouse_position});
+}
+
+void DaycareWorldSystem::on_mouse_path(const std::vector<vec2> &path) {
+  vec2 mouse_position = path.back();
   last_mouse_pos = mouse_position;
 
   for (int i = 0; i < registry->draggables.size(); i++) {
@@ -526,21 +527,16 @@ void DaycareWorldSystem::on_mouse_move(vec2 mouse_position) {
       continue;
     }
 
-    bool nearPrevPoint = current_gesture_point == 0 ||
-                         length(gesture_points.at(current_gesture_point - 1) -
-                                mouse_position) < 100;
-    bool nearCurrPoint =
-        length(gesture_points.at(current_gesture_point) - mouse_position) < 100;
-
-    if (!nearPrevPoint && !nearCurrPoint) {
-      current_gesture_point = 0;
-    } else if (nearCurrPoint) {
-      current_gesture_point++;
+    // a quick stroke passes several points of the gesture in one step
+    bool traced = false;
+    for (vec2 position : path) {
+      if (trace_gesture(position)) {
+        traced = true;
+        break;
+      }
     }
 
-    if (current_gesture_point == gesture_points.size()) {
-      current_gesture_point = 0;
-
+    if (traced) {
       if (registry->foodBowls.has(entity)) {
         auto bowl = &registry->foodBowls.get(entity);
         bowl->amount = 1;
@@ -561,6 +557,26 @@ void DaycareWorldSystem::on_mouse_move(vec2 mouse_position) {
   }
 }
 
+bool DaycareWorldSystem::trace_gesture(vec2 position) {
+  bool nearPrevPoint =
+      current_gesture_point == 0 ||
+      length(gesture_points.at(current_gesture_point - 1) - position) < 100;
+  bool nearCurrPoint =
+      length(gesture_points.at(current_gesture_point) - position) < 100;
+
+  if (!nearPrevPoint && !nearCurrPoint) {
+    current_gesture_point = 0;
+  } else if (nearCurrPoint) {
+    current_gesture_point++;
+  }
+
+  if (current_gesture_point == gesture_points.size()) {
+    current_gesture_point = 0;
+    return true;
+  }
+  return false;
+}
+
 void DaycareWorldSystem::handle_collisions() {
   // Loop over all collisions detected by the physics system
 }
@@ -7,14 +7,9 @@
 #include <random>
 #include <vector>
 
-#define SDL_MAIN_HANDLED
-#include <SDL.h>
-#include <SDL_mixer.h>
-
 #include "../registry.hpp"
 #include "physics_system.hpp"
-#include "render_system.hpp"
-#include "window_manager.hpp"
+#include "scene_io.hpp"
 
 // Container for all our entities and game logic. Individual rendering / update
 // is deferred to the relative update() methods
@@ -24,9 +19,9 @@ class DaycareWorldSystem {
 
   // starts the game
   void init(std::shared_ptr<DaycareRegistry> registry,
-            std::shared_ptr<RenderSystem> renderer,
+            std::shared_ptr<MeshLibrary> meshes,
             std::shared_ptr<DaycarePhysicsSystem> physics,
-            std::shared_ptr<WindowManager> window_manager,
+            std::shared_ptr<Viewport> viewport,
             std::function<void()> on_scene_end);
 
   // Releases all associated resources
@@ -38,18 +33,30 @@ class DaycareWorldSystem {
   // Animate sprites
   void handle_sprite_animation(float delta);
 
+  // Feeds the puppies near a bowl or toy and moves their progress bars
+  void update_progress_bars(float delta);
+
+  // Empty or full bowl textures
+  void update_bowls();
+
   // Should the game be over ?
   bool is_over() const;
 
   // Input callback functions
   void on_key(int key, int action, int mod);
   void on_mouse_move(vec2 pos);
+  // every cursor position of a step, the gesture is traced along all of them
+  void on_mouse_path(const std::vector<vec2> &path);
 
-  // restart level
+  // restart level, with the round prepared before if there is one
   void restart_game();
 
+  // Builds the next round aside, see Scene::prepare. The scene must not step
+  // meanwhile.
+  void prepare_round();
+
  private:
-  // initialize all the entities in the scene
+  // initialize all the entities of the scene in the staging registry
   void initializeEntities();
 
   // handle collisions
@@ -57,18 +64,22 @@ class DaycareWorldSystem {
 
   vec2 get_random_window_position(vec2 offset = vec2(0.f, 0.f));
 
-  void update_bowls();
-
-  void update_progress_bars(float delta);
-
   void update_debug_lines(float delta);
 
   void remove_gesture_path();
 
+  // moves the gesture on when position is near its next point, true once the
+  // last point was reached
+  bool trace_gesture(vec2 position);
+
   // holds the scene state
   std::shared_ptr<DaycareRegistry> registry;
+  // holds the next round until restart_game swaps it in
+  std::shared_ptr<DaycareRegistry> staging =
+      std::make_shared<DaycareRegistry>();
+  bool round_prepared = false;
 
-  std::shared_ptr<WindowManager> window_manager;
+  std::shared_ptr<Viewport> viewport;
 
   // C++ random number generator
   std::default_random_engine rng;
@@ -76,12 +87,9 @@ class DaycareWorldSystem {
 
   Entity current_player;
   Entity camera;
-  std::shared_ptr<RenderSystem> renderer;
+  std::shared_ptr<MeshLibrary> meshes;
   std::shared_ptr<DaycarePhysicsSystem> physics;
 
-  // Audio
-  Mix_Music *background_music;
-
   // callback called when the game ends
   std::function<void()> on_game_end_callback_ptr;
 };
@@ -4,8 +4,11 @@
 #include <memory>
 
 #include "../registry.hpp"
+#include "body_sleep.hpp"
+#include "broad_phase.hpp"
 #include "common.hpp"
 #include "components.hpp"
+#include "narrow_phase.hpp"
 #include "tiny_ecs.hpp"
 
 // A simple physics system that moves rigid bodies and checks for collision
@@ -18,9 +21,19 @@ class MacPhysicsSystem {
 
   void step(float delta, float window_width, float window_height);
 
+  // bodies awake and asleep in the last step, see update_sleeping_bodies
+  SleepStats sleep_stats() const { return last_sleep_stats; }
+
   void handleMeshWallCollisions(Entity e);
 
  private:
   // holds the scene state
   std::shared_ptr<MacRegistry> registry;
+  SleepStats last_sleep_stats;
+
+  // rocks drift across the screen so their order along x barely changes
+  // between steps, see bench/sweep_and_prune_bench
+  SweepAndPrune broad_phase;
+  NarrowPhaseBodies bodies;  // ids are the indices in collisionFilters
+  std::vector<BroadPhasePair> candidates, rock_pairs, player_pairs, contacts;
 };
\ No newline at end of file
@@ -4,7 +4,7 @@
 #include <random>
 
 Entity createPlayer(std::shared_ptr<MacRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer, vec2 pos) {
+                    std::shared_ptr<MeshLibrary> meshes, vec2 pos) {
   auto entity = Entity();
   //std::default_random_engine rng;
   //std::uniform_real_distribution<float> uniform_dist;
@@ -12,7 +12,7 @@ Entity createPlayer(std::shared_ptr<MacRegistry> registry,
   //float screen_height = 800;
 
   // Store a reference to the potentially re-used mesh object
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SALMON);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SALMON);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Setting initial motion values
@@ -27,6 +27,8 @@ Entity createPlayer(std::shared_ptr<MacRegistry> registry,
   velocity.velocity = {0.f, 0.f};
 
   registry->players.emplace(entity);
+  registry->collisionFilters.insert(entity,
+                                    {COLLISION_PLAYER, COLLISION_OBSTACLE});
   registry->renderRequests.insert(
       entity,
       {TEXTURE_ASSET_ID::DOGE_MAC,
@@ -37,12 +39,12 @@ Entity createPlayer(std::shared_ptr<MacRegistry> registry,
 }
 
 Entity createRock(std::shared_ptr<MacRegistry> registry,
-                  std::shared_ptr<RenderSystem> renderer, vec2 position) {
+                  std::shared_ptr<MeshLibrary> meshes, vec2 position) {
   // Reserve en entity
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SALMON);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SALMON);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Initialize the position, scale, and physics components
@@ -55,6 +57,8 @@ Entity createRock(std::shared_ptr<MacRegistry> registry,
   velocity.velocity = {0.f, 0.f};
 
   registry->rocks.emplace(entity);
+  registry->collisionFilters.insert(
+      entity, {COLLISION_OBSTACLE, COLLISION_OBSTACLE | COLLISION_PLAYER});
   registry->renderRequests.insert(
       entity, {TEXTURE_ASSET_ID::ROCK_MAC,
                EFFECT_ASSET_ID::TEXTURED,
@@ -84,10 +88,10 @@ Entity createLine(std::shared_ptr<MacRegistry> registry, vec2 position,
 }
 
 Entity createBackground(std::shared_ptr<MacRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer,
+                    std::shared_ptr<MeshLibrary> meshes,
                     vec2 position) {
   auto entity = Entity();
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Initialize the position, scale, and physics components
@@ -103,5 +107,8 @@ Entity createBackground(std::shared_ptr<MacRegistry> registry,
       entity, {TEXTURE_ASSET_ID::BKGD_MAC, EFFECT_ASSET_ID::TEXTURED,
                GEOMETRY_BUFFER_ID::SPRITE});
 
+  // the background never moves, draw it from the cached static layer
+  registry->staticLayers.emplace(entity);
+
   return entity;
 }
@@ -5,7 +5,7 @@
 
 #include "../registry.hpp"
 #include "common.hpp"
-#include "render_system.hpp"
+#include "scene_io.hpp"
 #include "tiny_ecs.hpp"
 
 // These are hard coded to the dimensions of the entity texture
@@ -14,14 +14,14 @@ const float ROCK_BB_HEIGHT = 50.0f;
 
 // the player
 Entity createPlayer(std::shared_ptr<MacRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer, vec2 pos);
+                    std::shared_ptr<MeshLibrary> meshes, vec2 pos);
 // the enemy
 Entity createRock(std::shared_ptr<MacRegistry> registry,
-                  std::shared_ptr<RenderSystem> renderer, vec2 position);
+                  std::shared_ptr<MeshLibrary> meshes, vec2 position);
 // a red line for debugging purposes
 Entity createLine(std::shared_ptr<MacRegistry> registry, vec2 position,
                   vec2 size);
 // bkgd
 Entity createBackground(std::shared_ptr<MacRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer,
+                    std::shared_ptr<MeshLibrary> meshes,
                     vec2 position);
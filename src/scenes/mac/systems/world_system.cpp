@@ -13,45 +13,41 @@
 #include <string>
 
 #include "physics_system.hpp"
-#include "window_manager.hpp"
-
-// Game configuration
-const size_t MAX_ROCKS = 25;
-const size_t ROCK_DELAY_MS = 2000 * 3;
+#include "random_service.hpp"
 
 // Create the fish world
 MacWorldSystem::MacWorldSystem() : points(0), next_rock_spawn(0.f) {
-  // Seeding rng with random device
+  // Seeding rng, from the run seed in a deterministic run
   // background_music = Mix_LoadMUS(audio_path("music.wav").c_str());
-  salmon_dead_sound = Mix_LoadWAV(audio_path("salmon_dead.wav").c_str());
-  salmon_eat_sound = Mix_LoadWAV(audio_path("salmon_eat.wav").c_str());
-  rng = std::default_random_engine(std::random_device()());
+  salmon_dead_sound = sound_library.sound("salmon_dead.wav");
+  salmon_eat_sound = sound_library.sound("salmon_eat.wav");
+  rng = random_service.engine("mac");
 }
 
 MacWorldSystem::~MacWorldSystem() {
   // Destroy music components
   // if (background_music != nullptr) Mix_FreeMusic(background_music);
-  if (salmon_dead_sound != nullptr) Mix_FreeChunk(salmon_dead_sound);
-  if (salmon_eat_sound != nullptr) Mix_FreeChunk(salmon_eat_sound);
-  Mix_CloseAudio();
 
   // Destroy all created components
   registry->clear_all_components();
   registry = nullptr;
-  renderer = nullptr;
+  meshes = nullptr;
   physics = nullptr;
-  window_manager = nullptr;
+  viewport = nullptr;
+  events = nullptr;
 }
 
 void MacWorldSystem::init(std::shared_ptr<MacRegistry> registry,
-                          std::shared_ptr<RenderSystem> renderer,
+                          std::shared_ptr<MeshLibrary> meshes,
                           std::shared_ptr<MacPhysicsSystem> physics,
-                          std::shared_ptr<WindowManager> window_manager,
+                          std::shared_ptr<Viewport> viewport,
+                          std::shared_ptr<SceneEvents> events,
                           std::function<void()> on_scene_end) {
   this->registry = registry;
-  this->renderer = renderer;
+  this->meshes = meshes;
   this->physics = physics;
-  this->window_manager = window_manager;
+  this->viewport = viewport;
+  this->events = events;
   this->on_game_end_callback_ptr = on_scene_end;
 
   // Set all states to default
@@ -61,14 +57,13 @@ void MacWorldSystem::init(std::shared_ptr<MacRegistry> registry,
 // Update our game world
 bool MacWorldSystem::step(float elapsed_ms_since_last_update) {
   // Get the screen dimensions
-  auto window = window_manager->get_window();
   int screen_width, screen_height;
-  glfwGetFramebufferSize(window, &screen_width, &screen_height);
+  viewport->get_framebuffer_size(&screen_width, &screen_height);
 
   // Updating window title with points
   std::stringstream title_ss;
   title_ss << "Points: " << points;
-  glfwSetWindowTitle(window, title_ss.str().c_str());
+  events->set_title(title_ss.str());
 
   // Remove debug info from the last step
   while (registry->debugComponents.entities.size() > 0)
@@ -77,12 +72,13 @@ bool MacWorldSystem::step(float elapsed_ms_since_last_update) {
 
   // spawning new rocks
   next_rock_spawn -= elapsed_ms_since_last_update * current_speed * 3;
-  if (registry->rocks.components.size() <= MAX_ROCKS && next_rock_spawn < 0.f) {
+  if (registry->rocks.components.size() <= balance.max_rocks &&
+      next_rock_spawn < 0.f) {
     // reset timer
-    next_rock_spawn =
-        (ROCK_DELAY_MS / 2) + uniform_dist(rng) * (ROCK_DELAY_MS / 2);
+    next_rock_spawn = (balance.rock_delay_ms / 2) +
+                      uniform_dist(rng) * (balance.rock_delay_ms / 2);
     // create rock
-    Entity entity = createRock(registry, renderer, {0, 0});
+    Entity entity = createRock(registry, meshes, {0, 0});
     // setting random initial position and constant velocity
     TransformComponent& transform = registry->transforms.get(entity);
     Velocity& velocity = registry->velocities.get(entity);
@@ -123,35 +119,35 @@ bool MacWorldSystem::step(float elapsed_ms_since_last_update) {
 
 // Reset the world state to its initial state
 void MacWorldSystem::restart_game() {
+  if (!round_prepared) prepare_round();
+  registry->swap_components(*staging);
+  round_prepared = false;
+}
+
+// Build the initial entities of the next round into the staging registry
+void MacWorldSystem::prepare_round() {
+  staging->clear_all_components();
+
   camera = Entity();
-  Camera& cam = registry->camera.emplace(camera);
+  Camera& cam = staging->camera.emplace(camera);
   cam.cameraFOV = {1200, 675};
 
   // Playing background music
   // Mix_PlayMusic(background_music, -1);
-  // Debugging for memory/component leaks
-  registry->list_all_components();
-  printf("Restarting\n");
 
   // Reset the game speed
   current_speed = 1.f;
 
-  // Remove all entities that we created
-  // All that have a motion, we could also iterate over all fish, turtles, ...
-  // but that would be more cumbersome
-  while (registry->transforms.entities.size() > 0)
-    registry->remove_all_components_of(registry->transforms.entities.back());
-
-  // Debugging for memory/component leaks
-  registry->list_all_components();
   // background
-  createBackground(registry, renderer, {600, 400});
+  createBackground(staging, meshes, {600, 400});
   // Create a new player
-  player_salmon = createPlayer(registry, renderer, {100, 200});
-  registry->colors.insert(player_salmon, {1, 0.8f, 0.8f});
+  player_salmon = createPlayer(staging, meshes, {100, 200});
+  staging->colors.insert(player_salmon, {1, 0.8f, 0.8f});
   // registry->colors.get(player_salmon).r = 0;
   // registry->colors.get(player_salmon).g = 255;
   // registry->colors.get(player_salmon).b = 0;
+
+  round_prepared = true;
 }
 
 void MacWorldSystem::handleRockPlayerBounce(Entity entity,
@@ -247,7 +243,7 @@ void MacWorldSystem::handle_collisions() {
           // Scream, reset timer, and make the salmon sink
           handleRockPlayerBounce(entity, entity_other);
           registry->deathTimers.emplace(entity);
-          Mix_PlayChannel(-1, salmon_dead_sound, 0);
+          events->play(-1, salmon_dead_sound, 0);
           // registry->motions.get(entity).angle = 3.1415f;
           // registry->motions.get(entity).velocity = { 0, 80 };
           registry->colors.get(entity).r = 0.8;
@@ -274,7 +270,7 @@ void MacWorldSystem::on_key(int key, int action, int mod) {
   // Resetting game
   if (action == GLFW_RELEASE && key == GLFW_KEY_R) {
     int w, h;
-    glfwGetWindowSize(window_manager->get_window(), &w, &h);
+    viewport->get_window_size(&w, &h);
 
     restart_game();
   }
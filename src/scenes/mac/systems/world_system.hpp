@@ -7,14 +7,15 @@
 #include <random>
 #include <vector>
 
-#define SDL_MAIN_HANDLED
-#include <SDL.h>
-#include <SDL_mixer.h>
-
 #include "../registry.hpp"
-#include "../render_system.hpp"
 #include "physics_system.hpp"
-#include "window_manager.hpp"
+#include "scene_io.hpp"
+
+// Difficulty of the rock shower, tuned with tools/mac_balance
+struct MacBalance {
+  size_t max_rocks = 25;
+  float rock_delay_ms = 2000 * 3;  // between two rocks, on average 3/4 of it
+};
 
 // Container for all our entities and game logic. Individual rendering / update
 // is deferred to the relative update() methods
@@ -24,9 +25,10 @@ class MacWorldSystem {
 
   // starts the game
   void init(std::shared_ptr<MacRegistry> registry,
-            std::shared_ptr<RenderSystem> renderer,
+            std::shared_ptr<MeshLibrary> meshes,
             std::shared_ptr<MacPhysicsSystem> physics,
-            std::shared_ptr<WindowManager> window_manager,
+            std::shared_ptr<Viewport> viewport,
+            std::shared_ptr<SceneEvents> events,
             std::function<void()> on_scene_end);
 
   // Releases all associated resources
@@ -42,30 +44,42 @@ class MacWorldSystem {
   void on_key(int key, int action, int mod);
   void on_mouse_move(vec2 pos);
 
-  // restart level
+  // restart level, with the round prepared before if there is one
   void restart_game();
 
+  // Builds the next round aside, see Scene::prepare. The scene must not step
+  // meanwhile.
+  void prepare_round();
+
+  // For the balance runs: the difficulty and the rng of the next rounds
+  void set_balance(const MacBalance& balance) { this->balance = balance; }
+  void set_rng(std::default_random_engine rng) { this->rng = rng; }
+
  private:
   // holds the scene state
   std::shared_ptr<MacRegistry> registry;
+  // holds the next round until restart_game swaps it in
+  std::shared_ptr<MacRegistry> staging = std::make_shared<MacRegistry>();
+  bool round_prepared = false;
 
-  std::shared_ptr<WindowManager> window_manager;
+  std::shared_ptr<Viewport> viewport;
+  std::shared_ptr<SceneEvents> events;
 
   // Number of fish eaten by the salmon, displayed in the window title
   unsigned int points;
 
   // Game state
-  std::shared_ptr<RenderSystem> renderer;
+  std::shared_ptr<MeshLibrary> meshes;
   std::shared_ptr<MacPhysicsSystem> physics;
   float current_speed;
+  MacBalance balance;
   float next_rock_spawn;
   Entity player_salmon;
   Entity camera;
 
   // music references
-  Mix_Music* background_music;
-  Mix_Chunk* salmon_dead_sound;
-  Mix_Chunk* salmon_eat_sound;
+  Sound salmon_dead_sound;
+  Sound salmon_eat_sound;
 
   // C++ random number generator
   std::default_random_engine rng;
@@ -30,14 +30,20 @@ void PlanitScene::init(std::shared_ptr<WindowManager> window_manager,
 
   registry->clear_all_components();
 
-  int window_width, window_height;
-  glfwGetFramebufferSize(window_manager->get_window(), &window_width,
-                         &window_height);
+  window_manager->get_framebuffer_size(&window_width, &window_height);
 
   assert(renderer->init(registry, window_width, window_height,
                         window_manager->get_window()));
-  world->init(registry, renderer, physics, window_manager, [&]() { end(); });
+  world->init(registry, renderer, physics, window_manager, events,
+              [&]() { end(); });
   physics->init(registry);
+  systems.clear();
+  systems.add_exclusive("world", [this](float delta) { world->step(delta); });
+  systems.add_exclusive("physics", [this](float delta) {
+    physics->step(delta, window_width, window_height);
+  });
+  systems.add_exclusive("collisions",
+                        [this](float) { world->handle_collisions(); });
 
   renderer->add_text_to_be_rendered({"Loading Game ..."}, vec2(0.38, 0.45), 1,
                                     vec3(1, 0.922, 0),
@@ -46,29 +52,40 @@ void PlanitScene::init(std::shared_ptr<WindowManager> window_manager,
   ScreenState &screen = registry->screenStates.components[0];
   screen.screen_brightness = 0.6;
   renderer->render_text_only(vec3(0.133, 0.224, 0.722));
+  renderer->clear_text();
   screen.screen_brightness = 1.0;
 }
 
 bool PlanitScene::step(float delta) {
-  int window_width, window_height;
-  glfwGetFramebufferSize(window_manager->get_window(), &window_width,
-                         &window_height);
+  // keep the poses before this step for interpolation, and only this step's
+  // text
+  registry->snapshot_transforms();
+  renderer->clear_text();
+
+  window_manager->get_framebuffer_size(&window_width, &window_height);
 
   // step forward systems
-  world->step(delta);
-  physics->step(delta, window_width, window_height);
-  world->handle_collisions();
-  renderer->draw();
+  systems.step(delta);
 
   return true;
 }
 
+void PlanitScene::publish() { renderer->publish(); }
+
+void PlanitScene::draw() { renderer->draw(); }
+
 void PlanitScene::reset_scene() { world->restart_game(); }
 
+void PlanitScene::prepare() { world->prepare_round(); }
+
 void PlanitScene::on_key(int key, int action, int mod) {
   world->on_key(key, action, mod);
 }
 
 void PlanitScene::on_mouse_move(vec2 pos) { world->on_mouse_move(pos); }
 
+uint64_t PlanitScene::state_hash() { return registry->state_hash(); }
+
+SleepStats PlanitScene::sleep_stats() { return physics->sleep_stats(); }
+
 void PlanitScene::end() { on_scene_end_callback_ptr(*registry); }
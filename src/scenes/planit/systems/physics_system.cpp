@@ -1,6 +1,7 @@
 // internal
 #include "physics_system.hpp"
 
+#include "body_sleep.hpp"
 #include "world_init.hpp"
 
 extern bool launch;
@@ -12,61 +13,144 @@ vec2 get_bounding_box2(const TransformComponent& transform) {
   return {abs(transform.scale.x), abs(transform.scale.y)};
 }
 
-// This is a SUPER APPROXIMATE check that puts a circle around the bounding
-// boxes and sees if the center point of either object is inside the other's
-// bounding-box-circle. You can surely implement a more accurate detection
-bool collides2(const TransformComponent& transform1,
-              const TransformComponent& transform2) {
-  vec2 dp = transform1.position - transform2.position;
-  float dist_squared = dot(dp, dp);
-  const vec2 other_bonding_box = get_bounding_box2(transform1) / 2.f;
-  const float other_r_squared = dot(other_bonding_box, other_bonding_box);
-  const vec2 my_bonding_box = get_bounding_box2(transform2) / 2.f;
-  const float my_r_squared = dot(my_bonding_box, my_bonding_box);
-  const float r_squared = max(other_r_squared, my_r_squared);
-  if (dist_squared < r_squared) return true;
-  return false;
+// Pull of the planet in the middle of the screen
+vec2 planet_gravity(vec2 position) {
+  const float G = 1;
+  const float massPlanet = 50000;
+  const vec2 center = {600, 400};
+  vec2 toCenter = center - position;
+  float r = sqrt(toCenter.x * toCenter.x + toCenter.y * toCenter.y);
+  return toCenter * ((G * massPlanet) / (r * r));
 }
 
 void PlanitPhysicsSystem::init(std::shared_ptr<PlanitRegistry> registry) {
   this->registry = registry;
+  broad_phase.set_job_system(&job_system);
 };
 
+bool PlanitPhysicsSystem::sweep(Entity entity, vec2 start, vec2 motion) {
+  // a handful of targets and planets, no need for the broad phase
+  ComponentContainer<CollisionFilter>& filter_container =
+      registry->collisionFilters;
+  const CollisionFilter& filter = filter_container.get(entity);
+  float radius = length(get_bounding_box2(registry->transforms.get(entity)) /
+                        2.f);
+  float first_toi = 2.f;
+  uint first_hit = 0;  // index in filter_container
+  for (uint i = 0; i < filter_container.components.size(); i++) {
+    Entity other = filter_container.entities[i];
+    if (other == entity || !filter.accepts(filter_container.components[i]))
+      continue;
+    const TransformComponent& other_transform = registry->transforms.get(other);
+    float other_radius = length(get_bounding_box2(other_transform) / 2.f);
+    // same contact as the narrow phase: the center enters the larger circle
+    float toi;
+    if (sweep_circles(start, motion, 0.f, other_transform.position,
+                      max(radius, other_radius), toi) &&
+        toi < first_toi) {
+      first_toi = toi;
+      first_hit = i;
+    }
+  }
+  if (first_toi > 1.f) return false;
+
+  registry->transforms.get(entity).position = start + motion * first_toi;
+  // the world system reacts to the player's entry
+  Entity other = filter_container.entities[first_hit];
+  if (filter.category & COLLISION_PLAYER) {
+    registry->collisions.emplace_with_duplicates(entity, other);
+  } else {
+    registry->collisions.emplace_with_duplicates(other, entity);
+  }
+  return true;
+}
+
+void PlanitPhysicsSystem::step_fast_body(Entity entity, float step_seconds) {
+  TransformComponent& transform = registry->transforms.get(entity);
+  Velocity& velocity = registry->velocities.get(entity);
+
+  // The launched player orbits the planet. It has always covered twice its
+  // velocity per step in flight (once with the other bodies and once in the
+  // orbit update) and the level is tuned for that.
+  bool orbiting = launch && registry->players.has(entity);
+  float speed = orbiting ? 2.f : 1.f;
+
+  // the orbit is curved, split it so each chord is short enough to sweep
+  int substeps = 1;
+  if (orbiting) {
+    float radius = length(get_bounding_box2(transform) / 2.f);
+    substeps = substep_count(velocity.velocity * speed * step_seconds, radius,
+                             registry->fastBodies.get(entity).max_substeps);
+  }
+  float h = step_seconds / substeps;
+  for (int i = 0; i < substeps; i++) {
+    vec2 start = transform.position;
+    vec2 motion = velocity.velocity * speed * h;
+    if (orbiting) velocity.velocity += planet_gravity(start) * h;
+    if (sweep(entity, start, motion)) break;
+    transform.position = start + motion;
+  }
+
+  if (orbiting)
+    transform.rotation = atan2(velocity.velocity.y, velocity.velocity.x);
+}
+
 void PlanitPhysicsSystem::step(float elapsed_ms, float window_width_px,
                                float window_height_px) {
+  last_sleep_stats = update_sleeping_bodies(*registry);
+
   // update position based on velocity
   auto& velocity_registry = registry->velocities;
   for (uint i = 0; i < velocity_registry.size(); i++) {
     Velocity& velocity = velocity_registry.components[i];
     Entity entity = velocity_registry.entities[i];
+    if (registry->fastBodies.has(entity)) continue;  // swept below
+    if (is_asleep(*registry, entity)) continue;
     TransformComponent& transform = registry->transforms.get(entity);
     float step_seconds = 1.0f * (elapsed_ms / 1000.f);
     transform.position += velocity.velocity * step_seconds;
   }
 
 
-  // Check for collisions between all moving entities
-  ComponentContainer<TransformComponent>& transform_container = registry->transforms;
-  for (uint i = 0; i < transform_container.components.size(); i++) {
-    TransformComponent& transform_i = transform_container.components[i];
-    Entity entity_i = transform_container.entities[i];
-    for (uint j = 0; j < transform_container.components.size(); j++)  // i+1
-    {
-      if (i == j) continue;
-
-      TransformComponent& transform_j = transform_container.components[j];
-      if (collides2(transform_i, transform_j)) {
-        Entity entity_j = transform_container.entities[j];
-        // Create a collisions event
-        // We are abusing the ECS system a bit in that we potentially insert
-        // muliple collisions for the same entity
-        registry->collisions.emplace_with_duplicates(entity_i, entity_j);
-        registry->collisions.emplace_with_duplicates(entity_j, entity_i);
-      }
+  // Check for collisions between the entities with a CollisionFilter. Each
+  // body gets the circle around its bounding box, two touch when the center
+  // of one enters the larger circle. Fast bodies find their collisions when
+  // they are swept.
+  ComponentContainer<CollisionFilter>& filter_container =
+      registry->collisionFilters;
+  broad_phase.clear();
+  bodies.clear();
+  for (uint i = 0; i < filter_container.components.size(); i++) {
+    const CollisionFilter& filter = filter_container.components[i];
+    const TransformComponent& transform_i =
+        registry->transforms.get(filter_container.entities[i]);
+    float radius = length(get_bounding_box2(transform_i) / 2.f);
+    // added anyway so the ids stay the indices in filter_container
+    bodies.add(transform_i.position, radius);
+    if (registry->fastBodies.has(filter_container.entities[i])) continue;
+    broad_phase.insert(i, transform_i.position, {radius, radius},
+                       filter.category, filter.mask);
+  }
+  candidates.clear();
+  broad_phase.find_pairs(candidates);
+  drop_sleeping_pairs(*registry, filter_container.entities, candidates);
+  contacts.clear();
+  circle_pairs(bodies, candidates, CircleContact::LARGER_RADIUS, contacts);
+  wake_contacts(*registry, filter_container.entities, contacts);
+  for (const BroadPhasePair& contact : contacts) {
+    Entity entity_i = filter_container.entities[contact.a];
+    Entity entity_j = filter_container.entities[contact.b];
+    // One entry per contact, the world system reacts to the player's
+    if (filter_container.components[contact.b].category & COLLISION_PLAYER) {
+      registry->collisions.emplace_with_duplicates(entity_j, entity_i);
+    } else {
+      registry->collisions.emplace_with_duplicates(entity_i, entity_j);
     }
   }
 
   // debugging of bounding boxes
+  ComponentContainer<TransformComponent>& transform_container =
+      registry->transforms;
   if (debugging.in_debug_mode) {
     uint size_before_adding_new = (uint)transform_container.components.size();
     for (uint i = 0; i < size_before_adding_new; i++) {
@@ -84,37 +168,7 @@ void PlanitPhysicsSystem::step(float elapsed_ms, float window_width_px,
     }
   }
 
-  // use semi-implicit euler for position/velocity calculations
-  // source: https://www.youtube.com/watch?v=kxWBXd7ujx0&t=674s
-  if (launch) {
-    float G = 1;
-    float h = elapsed_ms / 1000;
-    float massPlanet = 50000;
-    TransformComponent& playerTransform = registry->transforms.get(registry->players.entities[0]);
-    Velocity& playerVelocity = registry->velocities.get(registry->players.entities[0]);
-
-    vec2 center = {600, 400};
-    // vec2 playerPos = playerTransform.position;
-
-    auto gravity = [center, G, massPlanet](vec2 position) {
-      vec2 toCenter = center - position;
-      float r = sqrt(toCenter.x * toCenter.x + toCenter.y * toCenter.y);
-      return toCenter * ((G * massPlanet) / (r * r));
-    };
-
-    vec2 xn = playerTransform.position;
-    vec2 vn = playerVelocity.velocity;
-
-    auto v = [vn, gravity](vec2 x, float h) { return vn + gravity(x) * h; };
-
-    auto a = [xn, gravity](vec2 v, float h) {
-      return gravity(xn) + gravity(xn + v * h) * h;
-    };
-
-    playerTransform.position = xn + h * v(xn, 0);
-    playerVelocity.velocity = vn + h * a(vn, 0);
-
-    playerTransform.rotation =
-        atan2(playerVelocity.velocity.y, playerVelocity.velocity.x);
-  }
-}
\ No newline at end of file
+  // move the fast bodies along their path, stopping at the first contact
+  for (uint i = 0; i < registry->fastBodies.size(); i++)
+    step_fast_body(registry->fastBodies.entities[i], elapsed_ms / 1000.f);
+}
@@ -4,8 +4,12 @@
 #include <memory>
 
 #include "../registry.hpp"
+#include "body_sleep.hpp"
+#include "broad_phase.hpp"
 #include "common.hpp"
 #include "components.hpp"
+#include "narrow_phase.hpp"
+#include "swept_collision.hpp"
 #include "tiny_ecs.hpp"
 
 // A simple physics system that moves rigid bodies and checks for collision
@@ -18,7 +22,24 @@ class PlanitPhysicsSystem {
 
   void step(float delta, float window_width, float window_height);
 
+  // bodies awake and asleep in the last step, see update_sleeping_bodies
+  SleepStats sleep_stats() const { return last_sleep_stats; }
+
  private:
+  // Moves a FastBody by step_seconds, in sub steps along the orbit when the
+  // player is launched
+  void step_fast_body(Entity entity, float step_seconds);
+
+  // Moves entity from start along motion unless it hits something on the way,
+  // then stops it at the contact and records the collision
+  bool sweep(Entity entity, vec2 start, vec2 motion);
+
   // holds the scene state
   std::shared_ptr<PlanitRegistry> registry;
+  SleepStats last_sleep_stats;
+
+  // rebuilt every step, kept to reuse its allocations
+  SpatialHash broad_phase;
+  NarrowPhaseBodies bodies;  // ids are the indices in collisionFilters
+  std::vector<BroadPhasePair> candidates, contacts;
 };
\ No newline at end of file
@@ -1,11 +1,11 @@
 #include "world_init.hpp"
 
 Entity createPlayer(std::shared_ptr<PlanitRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer, vec2 pos) {
+                    std::shared_ptr<MeshLibrary> meshes, vec2 pos) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Setting initial motion values
@@ -25,6 +25,9 @@ Entity createPlayer(std::shared_ptr<PlanitRegistry> registry,
 
   // Create and (empty) Salmon component to be able to refer to all turtles
   registry->players.emplace(entity);
+  registry->collisionFilters.insert(
+      entity, {COLLISION_PLAYER, COLLISION_OBSTACLE | COLLISION_PICKUP});
+  registry->fastBodies.emplace(entity);
   registry->renderRequests.insert(
       entity,
       {TEXTURE_ASSET_ID::DOGE_ROCKET,
@@ -35,12 +38,12 @@ Entity createPlayer(std::shared_ptr<PlanitRegistry> registry,
 }
 
 Entity createTarget(std::shared_ptr<PlanitRegistry> registry,
-                  std::shared_ptr<RenderSystem> renderer, vec2 position) {
+                  std::shared_ptr<MeshLibrary> meshes, vec2 position) {
   // Reserve en entity
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Initialize the position, scale, and physics components
@@ -52,6 +55,8 @@ Entity createTarget(std::shared_ptr<PlanitRegistry> registry,
 
   // Create an (empty) Fish component to be able to refer to all fish
   registry->targets.emplace(entity);
+  registry->collisionFilters.insert(entity,
+                                    {COLLISION_PICKUP, COLLISION_PLAYER});
   registry->renderRequests.insert(
       entity, {TEXTURE_ASSET_ID::ENERGY_PLANIT, EFFECT_ASSET_ID::TEXTURED,
                GEOMETRY_BUFFER_ID::SPRITE});
@@ -60,13 +65,13 @@ Entity createTarget(std::shared_ptr<PlanitRegistry> registry,
 }
 
 Entity createPlanet(std::shared_ptr<PlanitRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer,
+                    std::shared_ptr<MeshLibrary> meshes,
                     vec2 position) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object (the value is
   // stored in the resource cache)
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Initialize the motion
@@ -78,6 +83,8 @@ Entity createPlanet(std::shared_ptr<PlanitRegistry> registry,
 
   // Create and (empty) Turtle component to be able to refer to all turtles
   registry->planets.emplace(entity);
+  registry->collisionFilters.insert(entity,
+                                    {COLLISION_OBSTACLE, COLLISION_PLAYER});
   registry->renderRequests.insert(
       entity, {TEXTURE_ASSET_ID::PLANET_PLANIT, EFFECT_ASSET_ID::TEXTURED,
                GEOMETRY_BUFFER_ID::SPRITE});
@@ -106,10 +113,10 @@ Entity createLine(std::shared_ptr<PlanitRegistry> registry, vec2 position,
 }
 
 Entity createBackground(std::shared_ptr<PlanitRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer,
+                    std::shared_ptr<MeshLibrary> meshes,
                     vec2 position) {
   auto entity = Entity();
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Initialize the position, scale, and physics components
@@ -125,5 +132,8 @@ Entity createBackground(std::shared_ptr<PlanitRegistry> registry,
       entity, {TEXTURE_ASSET_ID::BKGD_PLANIT, EFFECT_ASSET_ID::TEXTURED,
                GEOMETRY_BUFFER_ID::SPRITE});
 
+  // the background never moves, draw it from the cached static layer
+  registry->staticLayers.emplace(entity);
+
   return entity;
 }
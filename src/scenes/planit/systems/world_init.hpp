@@ -4,8 +4,8 @@
 #include <memory>
 
 #include "../registry.hpp"
-#include "../render_system.hpp"
 #include "common.hpp"
+#include "scene_io.hpp"
 #include "tiny_ecs.hpp"
 
 // These are ahrd coded to the dimensions of the entity texture
@@ -16,17 +16,17 @@ const float PLANET_BB_HEIGHT = 0.4f * 400.f;
 
 // the player
 Entity createPlayer(std::shared_ptr<PlanitRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer, vec2 pos);
+                    std::shared_ptr<MeshLibrary> meshes, vec2 pos);
 // the target
 Entity createTarget(std::shared_ptr<PlanitRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer, vec2 position);
+                    std::shared_ptr<MeshLibrary> meshes, vec2 position);
 // the planet
 Entity createPlanet(std::shared_ptr<PlanitRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer, vec2 position);
+                    std::shared_ptr<MeshLibrary> meshes, vec2 position);
 // a red line for debugging purposes
 Entity createLine(std::shared_ptr<PlanitRegistry> registry, vec2 position,
                   vec2 size);
 // bkgd
 Entity createBackground(std::shared_ptr<PlanitRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer,
+                    std::shared_ptr<MeshLibrary> meshes,
                     vec2 position);
\ No newline at end of file
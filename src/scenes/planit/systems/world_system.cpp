@@ -8,6 +8,7 @@
 #include <sstream>
 
 #include "physics_system.hpp"
+#include "random_service.hpp"
 
 vec2 launchDirection = {0, 0};
 float velocityLineDist = 0;
@@ -19,42 +20,39 @@ bool shouldDraw = true;
 // Create the fish world
 PlanitWorldSystem::PlanitWorldSystem()
     : points(0), next_turtle_spawn(0.f), next_fish_spawn(0.f) {
-  // Seeding rng with random device
+  // Seeding rng, from the run seed in a deterministic run
   (void)next_turtle_spawn;
   (void)next_fish_spawn;
-  background_music = Mix_LoadMUS(audio_path("music.wav").c_str());
-  (void)background_music;
-
-  salmon_dead_sound = Mix_LoadWAV(audio_path("salmon_dead.wav").c_str());
-  salmon_eat_sound = Mix_LoadWAV(audio_path("salmon_eat.wav").c_str());
-  rng = std::default_random_engine(std::random_device()());
+  salmon_dead_sound = sound_library.sound("salmon_dead.wav");
+  salmon_eat_sound = sound_library.sound("salmon_eat.wav");
+  rng = random_service.engine("planit");
   // background_music = Mix_LoadMUS(audio_path("music.wav").c_str());
 }
 
 PlanitWorldSystem::~PlanitWorldSystem() {
   // Destroy music components
   // if (background_music != nullptr) Mix_FreeMusic(background_music);
-  if (salmon_dead_sound != nullptr) Mix_FreeChunk(salmon_dead_sound);
-  if (salmon_eat_sound != nullptr) Mix_FreeChunk(salmon_eat_sound);
-  Mix_CloseAudio();
 
   // Destroy all created components
   registry->clear_all_components();
   registry = nullptr;
-  renderer = nullptr;
+  meshes = nullptr;
   physics = nullptr;
-  window_manager = nullptr;
+  viewport = nullptr;
+  events = nullptr;
 }
 
 void PlanitWorldSystem::init(std::shared_ptr<PlanitRegistry> registry,
-                             std::shared_ptr<RenderSystem> renderer,
+                             std::shared_ptr<MeshLibrary> meshes,
                              std::shared_ptr<PlanitPhysicsSystem> physics,
-                             std::shared_ptr<WindowManager> window_manager,
+                             std::shared_ptr<Viewport> viewport,
+                             std::shared_ptr<SceneEvents> events,
                              std::function<void()> on_scene_end) {
   this->registry = registry;
-  this->renderer = renderer;
+  this->meshes = meshes;
   this->physics = physics;
-  this->window_manager = window_manager;
+  this->viewport = viewport;
+  this->events = events;
   this->on_game_end_callback_ptr = on_scene_end;
 
   // Set all states to default
@@ -66,13 +64,12 @@ bool PlanitWorldSystem::step(float elapsed_ms_since_last_update) {
   handle_sprite_animation(elapsed_ms_since_last_update);
   // Get the screen dimensions
   int screen_width, screen_height;
-  glfwGetFramebufferSize(window_manager->get_window(), &screen_width,
-                         &screen_height);
+  viewport->get_framebuffer_size(&screen_width, &screen_height);
 
   // Updating window title with points
   std::stringstream title_ss;
   title_ss << "Points: " << points;
-  glfwSetWindowTitle(window_manager->get_window(), title_ss.str().c_str());
+  events->set_title(title_ss.str());
 
   // Remove debug info from the last step
   while (registry->debugComponents.entities.size() > 0)
@@ -144,7 +141,7 @@ bool PlanitWorldSystem::step(float elapsed_ms_since_last_update) {
     registry->colors.get(registry->players.entities[0]).r = 255;
     registry->colors.get(registry->players.entities[0]).g = 0;
     registry->colors.get(registry->players.entities[0]).b = 0;
-    Mix_PlayChannel(-1, salmon_dead_sound, 0);
+    events->play(-1, salmon_dead_sound, 0);
   }
 
   return true;
@@ -152,42 +149,41 @@ bool PlanitWorldSystem::step(float elapsed_ms_since_last_update) {
 
 // Reset the world state to its initial state
 void PlanitWorldSystem::restart_game() {
+  if (!round_prepared) prepare_round();
+  registry->swap_components(*staging);
+  round_prepared = false;
+}
+
+// Build the initial entities of the next round into the staging registry
+void PlanitWorldSystem::prepare_round() {
+  staging->clear_all_components();
+
   camera = Entity();
-  Camera& cam = registry->camera.emplace(camera);
+  Camera& cam = staging->camera.emplace(camera);
   cam.cameraFOV = {2000, 1125};
 
   // Playing background music indefinitely
   // Mix_PlayMusic(background_music, -1);
-  // Debugging for memory/component leaks
-  registry->list_all_components();
-  printf("Restarting\n");
 
   // Reset the game speed
   current_speed = 1.f;
 
-  // Remove all entities that we created
-  // All that have a motion, we could also iterate over all fish, turtles, ...
-  // but that would be more cumbersome
-  while (registry->transforms.entities.size() > 0)
-    registry->remove_all_components_of(registry->transforms.entities.back());
-
-  // Debugging for memory/component leaks
-  registry->list_all_components();
   // background
-  createBackground(registry, renderer, {600, 400});
+  createBackground(staging, meshes, {600, 400});
 
   // Create a new salmon
-  player_salmon = createPlayer(registry, renderer, {100, 600});
+  player_salmon = createPlayer(staging, meshes, {100, 600});
   // registry->motions.get(player_salmon).velocity.y = -100;
-  registry->colors.insert(player_salmon, {1, 0.8f, 0.8f});
+  staging->colors.insert(player_salmon, {1, 0.8f, 0.8f});
 
   // create planet
-  createPlanet(registry, renderer, {600, 400});
+  createPlanet(staging, meshes, {600, 400});
 
   // create target
-  createTarget(registry, renderer, {600, 600});
+  createTarget(staging, meshes, {600, 600});
 
   shouldDraw = true;
+  round_prepared = true;
 }
 
 // Compute collisions between entities
@@ -212,7 +208,7 @@ void PlanitWorldSystem::handle_collisions() {
           launch = false;
           shouldDraw = false;
           registry->deathTimers.emplace(entity);
-          Mix_PlayChannel(-1, salmon_dead_sound, 0);
+          events->play(-1, salmon_dead_sound, 0);
           // registry->motions.get(entity).angle = 3.1415f;
           registry->velocities.get(entity).velocity = {0, 0};
           registry->colors.get(entity).r = 255;
@@ -234,13 +230,13 @@ void PlanitWorldSystem::handle_collisions() {
             registry->colors.get(entity).g = 255;
             //registry->colors.get(entity).b = 0;
             // registry->remove_all_components_of(entity_other);
-            Mix_PlayChannel(-1, salmon_eat_sound, 0);
+            events->play(-1, salmon_eat_sound, 0);
             ++points;
           } else {
             launch = false;
             shouldDraw = false;
             registry->deathTimers.emplace(entity);
-            Mix_PlayChannel(-1, salmon_dead_sound, 0);
+            events->play(-1, salmon_dead_sound, 0);
             // registry->motions.get(entity).angle = 3.1415f;
             registry->velocities.get(entity).velocity = {0.1, 0};
             registry->colors.get(entity).r = 255;
@@ -282,7 +278,7 @@ void PlanitWorldSystem::on_key(int key, int action, int mod) {
   // Resetting game
   if (action == GLFW_RELEASE && key == GLFW_KEY_R) {
     int w, h;
-    glfwGetWindowSize(window_manager->get_window(), &w, &h);
+    viewport->get_window_size(&w, &h);
 
     restart_game();
   }
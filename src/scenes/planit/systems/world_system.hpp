@@ -7,14 +7,9 @@
 #include <random>
 #include <vector>
 
-#define SDL_MAIN_HANDLED
-#include <SDL.h>
-#include <SDL_mixer.h>
-
 #include "../registry.hpp"
 #include "physics_system.hpp"
-#include "render_system.hpp"
-#include "window_manager.hpp"
+#include "scene_io.hpp"
 
 // Container for all our entities and game logic. Individual rendering / update
 // is deferred to the relative update() methods
@@ -24,9 +19,10 @@ class PlanitWorldSystem {
 
   // starts the game
   void init(std::shared_ptr<PlanitRegistry> registry,
-            std::shared_ptr<RenderSystem> renderer,
+            std::shared_ptr<MeshLibrary> meshes,
             std::shared_ptr<PlanitPhysicsSystem> physics,
-            std::shared_ptr<WindowManager> window_manager,
+            std::shared_ptr<Viewport> viewport,
+            std::shared_ptr<SceneEvents> events,
             std::function<void()> on_scene_end);
 
   // Releases all associated resources
@@ -42,20 +38,28 @@ class PlanitWorldSystem {
   void on_key(int key, int action, int mod);
   void on_mouse_move(vec2 pos);
 
-  // restart level
+  // restart level, with the round prepared before if there is one
   void restart_game();
 
+  // Builds the next round aside, see Scene::prepare. The scene must not step
+  // meanwhile.
+  void prepare_round();
+
  private:
   // holds the scene state
   std::shared_ptr<PlanitRegistry> registry;
+  // holds the next round until restart_game swaps it in
+  std::shared_ptr<PlanitRegistry> staging = std::make_shared<PlanitRegistry>();
+  bool round_prepared = false;
 
-  std::shared_ptr<WindowManager> window_manager;
+  std::shared_ptr<Viewport> viewport;
+  std::shared_ptr<SceneEvents> events;
 
   // Number of fish eaten by the salmon, displayed in the window title
   unsigned int points;
 
   // Game state
-  std::shared_ptr<RenderSystem> renderer;
+  std::shared_ptr<MeshLibrary> meshes;
   std::shared_ptr<PlanitPhysicsSystem> physics;
   float current_speed;
   float next_turtle_spawn;
@@ -63,9 +67,8 @@ class PlanitWorldSystem {
   Entity player_salmon;
   Entity camera;
   // music references
-  Mix_Music* background_music;
-  Mix_Chunk* salmon_dead_sound;
-  Mix_Chunk* salmon_eat_sound;
+  Sound salmon_dead_sound;
+  Sound salmon_eat_sound;
 
   // C++ random number generator
   std::default_random_engine rng;
@@ -10,6 +10,16 @@
  */
 #pragma once
 
+// stlib
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+// internal
+#include "body_sleep.hpp"
+#include "scene_io.hpp"
+
 class Scene {
  public:
   Scene() = default;
@@ -20,18 +30,53 @@ class Scene {
   // starts the scene
   // virtual void init() = 0;
 
-  // steps the scene ahead by delta (in milliseconds)
+  // steps the scene ahead by delta (in milliseconds), simulation only
   virtual bool step(float delta) = 0;
 
+  // hands what the last step shows to draw(), called on the simulation
+  // thread after each step
+  virtual void publish() = 0;
+
+  // renders the newest published step, called on the thread owning the GL
+  // context while the simulation thread steps on
+  virtual void draw() = 0;
+
   virtual void reset_scene() = 0;
 
+  // builds the entities of the next reset_scene aside, so the reset only
+  // swaps them in. The scene manager calls it on its own thread while another
+  // scene steps, the scene itself must not step until its reset.
+  virtual void prepare() {}
+
   // input callback for mouse and key presses
   virtual void on_key(int key, int action, int mod) = 0;
 
   // input callback for mouse movement
   virtual void on_mouse_move(vec2 pos) = 0;
 
+  // input callback for the cursor positions reported since the last step or
+  // key, oldest first and never empty. The scene manager calls it once per
+  // step instead of on_mouse_move per event; scenes that follow the cursor
+  // path, like the daycare gestures, override it.
+  virtual void on_mouse_path(const std::vector<vec2> &path) {
+    on_mouse_move(path.back());
+  }
+
+  // hash of the simulated state, used to check that a replay ended where the
+  // recorded run did
+  virtual uint64_t state_hash() = 0;
+
+  // bodies awake and asleep in the last physics step, none without physics
+  virtual SleepStats sleep_stats() { return SleepStats(); }
+
+  // the sounds and title the steps queued, the scene manager hands them to
+  // the audio bank and the window after each step
+  SceneEvents &scene_events() { return *events; }
+
  protected:
+  // shared with the world, which queues its side effects on it
+  std::shared_ptr<SceneEvents> events = std::make_shared<SceneEvents>();
+
   // ends the scene and calls the callback
   virtual void end() = 0;
 };
@@ -1,6 +1,7 @@
 // internal
 #include "physics_system.hpp"
 
+#include "body_sleep.hpp"
 #include "world_init.hpp"
 
 // Returns the local bounding coordinates scaled by the current size of the
@@ -10,22 +11,6 @@ vec2 get_bounding_box1(const TransformComponent& transform) {
   return {abs(transform.scale.x), abs(transform.scale.y)};
 }
 
-// This is a SUPER APPROXIMATE check that puts a circle around the bounding
-// boxes and sees if the center point of either object is inside the other's
-// bounding-box-circle. You can surely implement a more accurate detection
-bool collides1(const TransformComponent& transform1,
-               const TransformComponent& transform2) {
-  vec2 dp = transform1.position - transform2.position;
-  float dist_squared = dot(dp, dp);
-  const vec2 other_bonding_box = get_bounding_box1(transform1) / 2.f;
-  const float other_r_squared = dot(other_bonding_box, other_bonding_box);
-  const vec2 my_bonding_box = get_bounding_box1(transform2) / 2.f;
-  const float my_r_squared = dot(my_bonding_box, my_bonding_box);
-  const float r_squared = max(other_r_squared, my_r_squared);
-  if (dist_squared < r_squared) return true;
-  return false;
-}
-
 // helper function createBox for debugging
 void ShowerPhysicsSystem::createBox(vec2 position, vec2 size) {
   float scaleY = size.y * 0.05f;
@@ -55,17 +40,52 @@ void ShowerPhysicsSystem::createBox(vec2 position, vec2 size) {
 
 void ShowerPhysicsSystem::init(std::shared_ptr<ShowerRegistry> registry) {
   this->registry = registry;
+  broad_phase.set_job_system(&job_system);
+}
+
+void ShowerPhysicsSystem::move_fast_body(Entity entity, vec2 motion) {
+  TransformComponent& transform = registry->transforms.get(entity);
+  vec2 start = transform.position;
+  float first_toi = 2.f;
+  vec2 first_normal = {0.f, 0.f};
+  for (Entity block : registry->block.entities) {
+    const TransformComponent& block_transform = registry->transforms.get(block);
+    float toi;
+    vec2 normal;
+    // already touching is left to the block response in step
+    if (sweep_boxes(start, motion, get_bounding_box1(transform) / 2.f,
+                    block_transform.position,
+                    get_bounding_box1(block_transform) / 2.f, toi, normal) &&
+        toi > 0.f && toi < first_toi) {
+      first_toi = toi;
+      first_normal = normal;
+    }
+  }
+  if (first_toi > 1.f) {
+    transform.position = start + motion;
+  } else {
+    // stop just inside the face that was hit, the block response lands the
+    // player on top or pushes it out of the side
+    transform.position = start + motion * first_toi - first_normal * 0.1f;
+  }
 }
 
 void ShowerPhysicsSystem::step(float elapsed_ms, float window_width_px,
                                float window_height_px) {
+  last_sleep_stats = update_sleeping_bodies(*registry);
+
   // update position based on velocity
   auto& velocity_registry = registry->velocities;
   for (uint i = 0; i < velocity_registry.size(); i++) {
     Velocity& velocity = velocity_registry.components[i];
     Entity entity = velocity_registry.entities[i];
+    if (is_asleep(*registry, entity)) continue;
     TransformComponent& transform = registry->transforms.get(entity);
     float step_seconds = 1.0f * (elapsed_ms / 1000.f);
+    if (registry->fastBodies.has(entity)) {
+      move_fast_body(entity, velocity.velocity * step_seconds);
+      continue;
+    }
     transform.position += velocity.velocity * step_seconds;
   }
   // update velocity based on acceleration
@@ -76,33 +96,51 @@ void ShowerPhysicsSystem::step(float elapsed_ms, float window_width_px,
   for (uint i = 0; i < acceleration_registry.size(); i++) {
     Acceleration& acceleration = acceleration_registry.components[i];
     Entity entity = acceleration_registry.entities[i];
+    // resting on something, gravity would wake it every step
+    if (is_asleep(*registry, entity)) continue;
     Velocity& velocity = registry->velocities.get(entity);
     float step_seconds = 1.0f * (elapsed_ms / 1000.f);
     velocity.velocity += acceleration.acceleration * step_seconds;
   }
 
-  // Check for collisions between all moving entities
-  ComponentContainer<TransformComponent>& transform_container =
-      registry->transforms;
-  for (uint i = 0; i < transform_container.components.size(); i++) {
-    TransformComponent& transform_i = transform_container.components[i];
-    Entity entity_i = transform_container.entities[i];
-    for (uint j = 0; j < transform_container.components.size(); j++)  // i+1
-    {
-      if (i == j) continue;
-
-      TransformComponent& transform_j = transform_container.components[j];
-      if (collides1(transform_i, transform_j)) {
-        Entity entity_j = transform_container.entities[j];
-        registry->collisions.emplace_with_duplicates(entity_i, entity_j);
-        registry->collisions.emplace_with_duplicates(entity_j, entity_i);
-      }
+  // Check for collisions between the entities with a CollisionFilter. Each
+  // body gets the circle around its bounding box, two touch when the center
+  // of one enters the larger circle.
+  ComponentContainer<CollisionFilter>& filter_container =
+      registry->collisionFilters;
+  broad_phase.clear();
+  bodies.clear();
+  for (uint i = 0; i < filter_container.components.size(); i++) {
+    const CollisionFilter& filter = filter_container.components[i];
+    const TransformComponent& transform_i =
+        registry->transforms.get(filter_container.entities[i]);
+    float radius = length(get_bounding_box1(transform_i) / 2.f);
+    broad_phase.insert(i, transform_i.position, {radius, radius},
+                       filter.category, filter.mask);
+    bodies.add(transform_i.position, radius);
+  }
+  candidates.clear();
+  broad_phase.find_pairs(candidates);
+  drop_sleeping_pairs(*registry, filter_container.entities, candidates);
+  contacts.clear();
+  circle_pairs(bodies, candidates, CircleContact::LARGER_RADIUS, contacts);
+  wake_contacts(*registry, filter_container.entities, contacts);
+  for (const BroadPhasePair& contact : contacts) {
+    Entity entity_i = filter_container.entities[contact.a];
+    Entity entity_j = filter_container.entities[contact.b];
+    // One entry per contact, the world system reacts to the player's
+    if (filter_container.components[contact.b].category & COLLISION_PLAYER) {
+      registry->collisions.emplace_with_duplicates(entity_j, entity_i);
+    } else {
+      registry->collisions.emplace_with_duplicates(entity_i, entity_j);
     }
   }
 
   // you may need the following quantities to compute wall positions
   (void)window_width_px;
   (void)window_height_px;
+  ComponentContainer<TransformComponent>& transform_container =
+      registry->transforms;
   for (uint i = 0; i < transform_container.entities.size(); i++) {
     Entity entity = transform_container.entities[i];
     if (registry->players.has(entity)) {
@@ -4,8 +4,12 @@
 #include <memory>
 
 #include "../registry.hpp"
+#include "body_sleep.hpp"
+#include "broad_phase.hpp"
 #include "common.hpp"
 #include "components.hpp"
+#include "narrow_phase.hpp"
+#include "swept_collision.hpp"
 #include "tiny_ecs.hpp"
 
 // A simple physics system that moves rigid bodies and checks for collision
@@ -18,9 +22,21 @@ class ShowerPhysicsSystem {
 
   void step(float delta, float window_width, float window_height);
 
+  // bodies awake and asleep in the last step, see update_sleeping_bodies
+  SleepStats sleep_stats() const { return last_sleep_stats; }
+
  private:
   // holds the scene state
   std::shared_ptr<ShowerRegistry> registry;
+  SleepStats last_sleep_stats;
+
+  // rebuilt every step, kept to reuse its allocations
+  SpatialHash broad_phase;
+  NarrowPhaseBodies bodies;  // ids are the indices in collisionFilters
+  std::vector<BroadPhasePair> candidates, contacts;
 
   void createBox(vec2 position, vec2 size);
+
+  // Moves a FastBody by motion without letting it pass through the block
+  void move_fast_body(Entity entity, vec2 motion);
 };
\ No newline at end of file
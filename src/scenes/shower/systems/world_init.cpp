@@ -1,11 +1,11 @@
 #include "world_init.hpp"
 
 Entity createDoge(std::shared_ptr<ShowerRegistry> registry,
-                  std::shared_ptr<RenderSystem> renderer, vec2 pos) {
+                  std::shared_ptr<MeshLibrary> meshes, vec2 pos) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Setting initial motion values
@@ -21,6 +21,9 @@ Entity createDoge(std::shared_ptr<ShowerRegistry> registry,
 
   // Create and (empty) Salmon component to be able to refer to all turtles
   registry->players.emplace(entity);
+  registry->collisionFilters.insert(
+      entity, {COLLISION_PLAYER, COLLISION_OBSTACLE | COLLISION_PICKUP});
+  registry->fastBodies.emplace(entity);
   registry->renderRequests.insert(
       entity,
       {TEXTURE_ASSET_ID::PLAYER_DOGE,  // TEXTURE_COUNT indicates that no
@@ -31,12 +34,12 @@ Entity createDoge(std::shared_ptr<ShowerRegistry> registry,
 }
 
 Entity createCloud(std::shared_ptr<ShowerRegistry> registry,
-                   std::shared_ptr<RenderSystem> renderer, vec2 pos,
+                   std::shared_ptr<MeshLibrary> meshes, vec2 pos,
                    vec2 size) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::CLOUD);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::CLOUD);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Setting initial motion values
@@ -57,12 +60,12 @@ Entity createCloud(std::shared_ptr<ShowerRegistry> registry,
 }
 
 Entity createSushi(std::shared_ptr<ShowerRegistry> registry,
-                   std::shared_ptr<RenderSystem> renderer, vec2 position) {
+                   std::shared_ptr<MeshLibrary> meshes, vec2 position) {
   // Reserve en entity
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Initialize the position, scale, and physics components
@@ -77,6 +80,8 @@ Entity createSushi(std::shared_ptr<ShowerRegistry> registry,
 
   // Create an (empty) Fish component to be able to refer to all fish
   registry->softShells.emplace(entity);
+  registry->collisionFilters.insert(entity,
+                                    {COLLISION_PICKUP, COLLISION_PLAYER});
   registry->renderRequests.insert(
       entity, {TEXTURE_ASSET_ID::FOOD, EFFECT_ASSET_ID::TEXTURED,
                GEOMETRY_BUFFER_ID::SPRITE});
@@ -86,12 +91,12 @@ Entity createSushi(std::shared_ptr<ShowerRegistry> registry,
 
 // project enemy
 Entity creatEnemy(std::shared_ptr<ShowerRegistry> registry,
-                  std::shared_ptr<RenderSystem> renderer, vec2 position) {
+                  std::shared_ptr<MeshLibrary> meshes, vec2 position) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object (the value is
   // stored in the resource cache)
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Initialize the position, scale, and physics components
@@ -105,6 +110,8 @@ Entity creatEnemy(std::shared_ptr<ShowerRegistry> registry,
 
   // Create and (empty) Turtle component to be able to refer to all turtles
   registry->hardShells.emplace(entity);
+  registry->collisionFilters.insert(entity,
+                                    {COLLISION_OBSTACLE, COLLISION_PLAYER});
   registry->enemyAi.emplace(entity);
   registry->renderRequests.insert(
       entity, {TEXTURE_ASSET_ID::ENEMY, EFFECT_ASSET_ID::TEXTURED,
@@ -115,12 +122,12 @@ Entity creatEnemy(std::shared_ptr<ShowerRegistry> registry,
 
 // project block
 Entity createBlock(std::shared_ptr<ShowerRegistry> registry,
-                   std::shared_ptr<RenderSystem> renderer, vec2 position) {
+                   std::shared_ptr<MeshLibrary> meshes, vec2 position) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object (the value is
   // stored in the resource cache)
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Initialize the motion
@@ -141,12 +148,12 @@ Entity createBlock(std::shared_ptr<ShowerRegistry> registry,
 }
 
 Entity createCat(std::shared_ptr<ShowerRegistry> registry,
-                 std::shared_ptr<RenderSystem> renderer, vec2 position) {
+                 std::shared_ptr<MeshLibrary> meshes, vec2 position) {
   auto entity = Entity();
 
   // Store a reference to the potentially re-used mesh object (the value is
   // stored in the resource cache)
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Initialize the position, scale, and physics components
@@ -161,6 +168,8 @@ Entity createCat(std::shared_ptr<ShowerRegistry> registry,
 
   // Create and (empty) Turtle component to be able to refer to all turtles
   registry->hardShells.emplace(entity);
+  registry->collisionFilters.insert(entity,
+                                    {COLLISION_OBSTACLE, COLLISION_PLAYER});
   registry->renderRequests.insert(
       entity, {TEXTURE_ASSET_ID::CAT, EFFECT_ASSET_ID::TEXTURED,
                GEOMETRY_BUFFER_ID::SPRITE});
@@ -189,9 +198,9 @@ Entity createLine(std::shared_ptr<ShowerRegistry> registry, vec2 position,
 }
 
 Entity createBackground(std::shared_ptr<ShowerRegistry> registry,
-                        std::shared_ptr<RenderSystem> renderer, vec2 position) {
+                        std::shared_ptr<MeshLibrary> meshes, vec2 position) {
   auto entity = Entity();
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Initialize the position, scale, and physics components
@@ -206,6 +215,9 @@ Entity createBackground(std::shared_ptr<ShowerRegistry> registry,
       entity, {TEXTURE_ASSET_ID::BKGD_SHOWER, EFFECT_ASSET_ID::TEXTURED,
                GEOMETRY_BUFFER_ID::SPRITE});
 
+  // the background never moves, draw it from the cached static layer
+  registry->staticLayers.emplace(entity);
+
   return entity;
 }
 
@@ -4,7 +4,7 @@
 
 #include "../registry.hpp"
 #include "common.hpp"
-#include "render_system.hpp"
+#include "scene_io.hpp"
 #include "tiny_ecs.hpp"
 
 // These are ahrd coded to the dimensions of the entity texture
@@ -21,27 +21,27 @@ const float PLAYER_BB_HEIGHT = 0.4f * 340.f;
 
 // the player
 Entity createDoge(std::shared_ptr<ShowerRegistry> registry,
-                  std::shared_ptr<RenderSystem> renderer, vec2 pos);
+                  std::shared_ptr<MeshLibrary> meshes, vec2 pos);
 // the prey
 Entity createSushi(std::shared_ptr<ShowerRegistry> registry,
-                   std::shared_ptr<RenderSystem> renderer, vec2 position);
+                   std::shared_ptr<MeshLibrary> meshes, vec2 position);
 // the cat
 Entity createCat(std::shared_ptr<ShowerRegistry> registry,
-                 std::shared_ptr<RenderSystem> renderer, vec2 position);
+                 std::shared_ptr<MeshLibrary> meshes, vec2 position);
 // a red line for debugging purposes
 Entity createLine(std::shared_ptr<ShowerRegistry> registry, vec2 position,
                   vec2 size);
 // Enemy
 Entity creatEnemy(std::shared_ptr<ShowerRegistry> registry,
-                  std::shared_ptr<RenderSystem> renderer, vec2 pos);
+                  std::shared_ptr<MeshLibrary> meshes, vec2 pos);
 // block
 Entity createBlock(std::shared_ptr<ShowerRegistry> registry,
-                   std::shared_ptr<RenderSystem> renderer, vec2 pos);
+                   std::shared_ptr<MeshLibrary> meshes, vec2 pos);
 
 Entity createBackground(std::shared_ptr<ShowerRegistry> registry,
-                        std::shared_ptr<RenderSystem> renderer, vec2 position);
+                        std::shared_ptr<MeshLibrary> meshes, vec2 position);
 Entity createCloud(std::shared_ptr<ShowerRegistry> registry,
-                   std::shared_ptr<RenderSystem> renderer, vec2 pos, vec2 size);
+                   std::shared_ptr<MeshLibrary> meshes, vec2 pos, vec2 size);
 
 Entity createBird(std::shared_ptr<ShowerRegistry> registry, vec2 pos,
                   vec2 size);
@@ -8,6 +8,7 @@
 #include <sstream>
 
 #include "physics_system.hpp"
+#include "random_service.hpp"
 
 // Game configuration
 const size_t MAX_CATS = 10000;
@@ -17,165 +18,74 @@ const size_t CAT_DELAY_MS = 2000 * 2;
 const size_t CLOUD_DELAY_MS = 3000 * 2;
 const size_t SUSHI_DELAY_MS = 5000 * 1;
 
-float TURN_FACTOR = 20;
-float VISUAL_RANGE = 30;
-float PROTECTED_RANGE = 10;
-float CENTERING_FACTOR = 0.0;
-float AVOID_FACTOR = 0.1;
-float MATCHING_FACTOR = 0.01;
-float MIN_SPEED = 20;
-float MAX_SPEED = 40;
+// Birds of the swarm of fireflies
+const int SWARM_SIZE = 50;
+const float MIN_SPEED = 20;
 
 // Create the shower game world
 ShowerWorldSystem::ShowerWorldSystem()
     : points(0), next_cat_spawn(0.f), next_sushi_spawn(0.f) {
-  // Seeding rng with random device
-  rng = std::default_random_engine(std::random_device()());
+  // Seeding rng, from the run seed in a deterministic run
+  rng = random_service.engine("shower");
   // background_music = Mix_LoadMUS(audio_path("fluffing-a-duck.wav").c_str());
-  doge_dead_sound = Mix_LoadWAV(audio_path("doge_die.wav").c_str());
-  doge_eat_sound = Mix_LoadWAV(audio_path("doge_bark.wav").c_str());
+  doge_dead_sound = sound_library.sound("doge_die.wav");
+  doge_eat_sound = sound_library.sound("doge_bark.wav");
 }
 
 ShowerWorldSystem::~ShowerWorldSystem() {
   // Destroy music components
   // if (background_music != nullptr) Mix_FreeMusic(background_music);
-  if (doge_dead_sound != nullptr) Mix_FreeChunk(doge_dead_sound);
-  if (doge_eat_sound != nullptr) Mix_FreeChunk(doge_eat_sound);
-  Mix_CloseAudio();
 
   // Destroy all created components
   registry->clear_all_components();
   registry = nullptr;
-  renderer = nullptr;
+  meshes = nullptr;
   physics = nullptr;
-  window_manager = nullptr;
+  viewport = nullptr;
+  events = nullptr;
 }
 
 void ShowerWorldSystem::init_swarm() {
   int vw = 1200, vh = 675;
 
-  for (int i = 0; i < 50; i++) {
+  for (int i = 0; i < SWARM_SIZE; i++) {
     float x = vw * uniform_dist(rng);
     float y = vh * uniform_dist(rng);
-    auto bird = createBird(registry, {x, y}, {10, 10});
+    auto bird = createBird(staging, {x, y}, {10, 10});
 
-    auto velocity = &registry->velocities.get(bird).velocity;
+    auto velocity = &staging->velocities.get(bird).velocity;
     velocity->x = MIN_SPEED * uniform_dist(rng);
     velocity->y = MIN_SPEED * uniform_dist(rng);
   }
 }
 
 void ShowerWorldSystem::step_swarm(float delta) {
-  int vw = 1200, vh = 675;
-
-  for (int i = 0; i < registry->birds.size(); i++) {
-    auto bird_i = registry->birds.entities[i];
-    vec2* pos_i = &registry->transforms.get(bird_i).position;
-    vec2* vel_i = &registry->velocities.get(bird_i).velocity;
-
-    float x_pos_avg = 0;
-    float y_pos_avg = 0;
-    float x_vel_avg = 0;
-    float y_vel_avg = 0;
-    float neighboring_birds = 0;
-    float close_dx = 0;
-    float close_dy = 0;
-
-    for (int j = 0; j < registry->birds.size(); j++) {
-      // if birds are the same, continue
-      if (i == j) {
-        continue;
-      }
-
-      auto bird_j = registry->birds.entities[j];
-      vec2 pos_j = registry->transforms.get(bird_j).position;
-      vec2 vel_j = registry->velocities.get(bird_j).velocity;
-
-      float dx = pos_i->x - pos_j.x;
-      float dy = pos_i->y - pos_j.y;
-
-      if (abs(dx) < VISUAL_RANGE && abs(dy) < VISUAL_RANGE) {
-        float squared_distance = pow(dx, 2) + pow(dy, 2);
-
-        if (squared_distance < pow(PROTECTED_RANGE, 2)) {
-          close_dx += pos_i->x - pos_j.x;
-          close_dy += pos_i->y - pos_j.y;
-        } else if (squared_distance < pow(VISUAL_RANGE, 2)) {
-          x_pos_avg += pos_j.x;
-          y_pos_avg += pos_j.y;
-          x_vel_avg += vel_j.x;
-          y_vel_avg += vel_j.y;
-          neighboring_birds++;
-        }
-      }
-
-      if (neighboring_birds > 0) {
-        x_pos_avg = x_pos_avg / neighboring_birds;
-        y_pos_avg = y_pos_avg / neighboring_birds;
-        x_vel_avg = x_vel_avg / neighboring_birds;
-        y_vel_avg = y_vel_avg / neighboring_birds;
-
-        vel_i->x += (x_pos_avg - pos_i->x) * CENTERING_FACTOR +
-                    (x_vel_avg - vel_i->x) * MATCHING_FACTOR;
-
-        vel_i->y += (y_pos_avg - pos_i->y) * CENTERING_FACTOR +
-                    (y_vel_avg - vel_i->y) * MATCHING_FACTOR;
-      }
-
-      vel_i->x += (close_dx * AVOID_FACTOR);
-      vel_i->y += (close_dy * AVOID_FACTOR);
-
-      // above top of the screen
-      if (pos_i->y < 0) {
-        pos_i->y = 0;
-        vel_i->y += TURN_FACTOR;
-      }
-
-      // below bottom of the screen
-      if (pos_i->y > vh) {
-        pos_i->y = vh;
-        vel_i->y -= TURN_FACTOR;
-      }
-
-      // left of the screen
-      if (pos_i->x < 0) {
-        pos_i->x = 0;
-        vel_i->x += TURN_FACTOR;
-      }
-
-      // right of the screen
-      if (pos_i->x > vw) {
-        pos_i->x = vw;
-        vel_i->x -= TURN_FACTOR;
-      }
-
-      float speed = sqrt(pow(vel_i->x, 2) + pow(vel_i->y, 2));
-
-      if (speed < MIN_SPEED) {
-        vel_i->x = (vel_i->x / speed) * MIN_SPEED;
-        vel_i->y = (vel_i->y / speed) * MIN_SPEED;
-      }
-
-      if (speed > MAX_SPEED) {
-        vel_i->x = (vel_i->x / speed) * MAX_SPEED;
-        vel_i->y = (vel_i->y / speed) * MAX_SPEED;
-      }
-    }
-
-    pos_i->x += vel_i->x / delta;
-    pos_i->y += vel_i->y / delta;
+  (void)delta;
+  // the physics system moves the birds along their velocity (in px/s), copy
+  // where it left them
+  swarm.clear();
+  for (Entity bird : registry->birds.entities)
+    swarm.add(registry->transforms.get(bird).position,
+              registry->velocities.get(bird).velocity);
+  swarm.step(&job_system);
+  for (uint i = 0; i < registry->birds.size(); i++) {
+    Entity bird = registry->birds.entities[i];
+    registry->transforms.get(bird).position = swarm.position(i);
+    registry->velocities.get(bird).velocity = swarm.velocity(i);
   }
 }
 
 void ShowerWorldSystem::init(std::shared_ptr<ShowerRegistry> registry,
-                             std::shared_ptr<RenderSystem> renderer,
+                             std::shared_ptr<MeshLibrary> meshes,
                              std::shared_ptr<ShowerPhysicsSystem> physics,
-                             std::shared_ptr<WindowManager> window_manager,
+                             std::shared_ptr<Viewport> viewport,
+                             std::shared_ptr<SceneEvents> events,
                              std::function<void()> on_scene_end) {
   this->registry = registry;
-  this->renderer = renderer;
+  this->meshes = meshes;
   this->physics = physics;
-  this->window_manager = window_manager;
+  this->viewport = viewport;
+  this->events = events;
   this->on_game_end_callback_ptr = on_scene_end;
 
   // Set all states to default
@@ -186,13 +96,12 @@ void ShowerWorldSystem::init(std::shared_ptr<ShowerRegistry> registry,
 bool ShowerWorldSystem::step(float elapsed_ms_since_last_update) {
   // Get the screen dimensions
   int screen_width, screen_height;
-  glfwGetFramebufferSize(window_manager->get_window(), &screen_width,
-                         &screen_height);
+  viewport->get_framebuffer_size(&screen_width, &screen_height);
 
   // Updating window title with points
   std::stringstream title_ss;
   title_ss << "Points: " << points;
-  glfwSetWindowTitle(window_manager->get_window(), title_ss.str().c_str());
+  events->set_title(title_ss.str());
 
   // Remove debug info from the last step
   while (registry->debugComponents.entities.size() > 0)
@@ -222,7 +131,7 @@ bool ShowerWorldSystem::step(float elapsed_ms_since_last_update) {
         (CLOUD_DELAY_MS / 3) + uniform_dist(rng) * (CLOUD_DELAY_MS / 2);
     // Create cloud
     Entity cloud =
-        createCloud(registry, renderer, {1300.0f, rng() % 100 + 100.0f},
+        createCloud(registry, meshes, {1300.0f, rng() % 100 + 100.0f},
                     {rng() % 100 + 250.0f, rng() % 75 + 170.0f});
   }
 
@@ -235,7 +144,7 @@ bool ShowerWorldSystem::step(float elapsed_ms_since_last_update) {
         (CAT_DELAY_MS / 3) + uniform_dist(rng) * (CAT_DELAY_MS / 2);
     // Create cat
     Entity entity =
-        createCat(registry, renderer,
+        createCat(registry, meshes,
                   {enemy_transform.position.x,
                    enemy_transform.position.y + enemy_transform.scale.y / 2});
     Velocity& vel = registry->velocities.get(entity);
@@ -251,7 +160,7 @@ bool ShowerWorldSystem::step(float elapsed_ms_since_last_update) {
         (SUSHI_DELAY_MS / 2) + uniform_dist(rng) * (SUSHI_DELAY_MS / 2);
     // Create sushi
     Entity entity = createSushi(
-        registry, renderer,
+        registry, meshes,
         vec2(50.f + uniform_dist(rng) * (screen_width - 100.f), 50.f));
     // Setting random initial position and constant velocity
     Velocity& vel = registry->velocities.get(entity);
@@ -300,35 +209,35 @@ bool ShowerWorldSystem::step(float elapsed_ms_since_last_update) {
 
 // Reset the world state to its initial state
 void ShowerWorldSystem::restart_game() {
+  if (!round_prepared) prepare_round();
+  registry->swap_components(*staging);
+  round_prepared = false;
+}
+
+// Build the initial entities of the next round into the staging registry
+void ShowerWorldSystem::prepare_round() {
+  staging->clear_all_components();
+
   camera = Entity();
-  Camera& cam = registry->camera.emplace(camera);
+  Camera& cam = staging->camera.emplace(camera);
   cam.cameraFOV = {1200, 675};
   // Playing background music for the scene (uncomment when we actually have
   // music)
   // Mix_PlayMusic(background_music, -1);
 
-  // Debugging for memory/component leaks
-  registry->list_all_components();
-  printf("Restarting\n");
-
   // Reset the game speed
   current_speed = 1.f;
 
-  // Remove all entities that we created
-  while (registry->transforms.entities.size() > 0)
-    registry->remove_all_components_of(registry->transforms.entities.back());
-
-  // Debugging for memory/component leaks
-  registry->list_all_components();
-
   // Create a new doge
-  createBackground(registry, renderer, {600, 400});
-  player_doge = createDoge(registry, renderer, {200, 700});
-  registry->colors.insert(player_doge, {1, 0.8f, 0.8f});
-  enemy = creatEnemy(registry, renderer, {600, 100});
-  block = createBlock(registry, renderer, {600, 620});
+  createBackground(staging, meshes, {600, 400});
+  player_doge = createDoge(staging, meshes, {200, 700});
+  staging->colors.insert(player_doge, {1, 0.8f, 0.8f});
+  enemy = creatEnemy(staging, meshes, {600, 100});
+  block = createBlock(staging, meshes, {600, 620});
 
   init_swarm();
+
+  round_prepared = true;
 }
 
 // Compute collisions between entities
@@ -352,7 +261,7 @@ void ShowerWorldSystem::handle_collisions() {
         if (!registry->deathTimers.has(entity)) {
           // Scream, reset timer, and make the salmon sink
           registry->deathTimers.emplace(entity);
-          Mix_PlayChannel(-1, doge_dead_sound, 0);
+          events->play(-1, doge_dead_sound, 0);
           registry->transforms.get(entity).rotation = 3.1415f;
           registry->velocities.get(entity).velocity = {0, 80};
           registry->colors.remove(entity);
@@ -364,7 +273,7 @@ void ShowerWorldSystem::handle_collisions() {
         if (!registry->deathTimers.has(entity)) {
           // chew, count points, and set the LightUp timer
           registry->remove_all_components_of(entity_other);
-          Mix_PlayChannel(-1, doge_eat_sound, 0);
+          events->play(-1, doge_eat_sound, 0);
           ++points;
           player_p.player_points = points;
           registry->lightUps.emplace(entity);
@@ -422,7 +331,7 @@ void ShowerWorldSystem::on_key(int key, int action, int mod) {
   // Resetting game
   if (action == GLFW_RELEASE && key == GLFW_KEY_R) {
     int w, h;
-    glfwGetWindowSize(window_manager->get_window(), &w, &h);
+    viewport->get_window_size(&w, &h);
 
     restart_game();
   }
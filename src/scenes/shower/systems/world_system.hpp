@@ -7,14 +7,10 @@
 #include <random>
 #include <vector>
 
-#define SDL_MAIN_HANDLED
-#include <SDL.h>
-#include <SDL_mixer.h>
-
 #include "../registry.hpp"
+#include "boids.hpp"
 #include "physics_system.hpp"
-#include "render_system.hpp"
-#include "window_manager.hpp"
+#include "scene_io.hpp"
 
 // Container for all our entities and game logic. Individual rendering / update
 // is deferred to the relative update() methods
@@ -27,9 +23,10 @@ class ShowerWorldSystem {
 
   // starts the game
   void init(std::shared_ptr<ShowerRegistry> registry,
-            std::shared_ptr<RenderSystem> renderer,
+            std::shared_ptr<MeshLibrary> meshes,
             std::shared_ptr<ShowerPhysicsSystem> physics,
-            std::shared_ptr<WindowManager> window_manager,
+            std::shared_ptr<Viewport> viewport,
+            std::shared_ptr<SceneEvents> events,
             std::function<void()> on_scene_end);
 
   // Releases all associated resources
@@ -45,23 +42,34 @@ class ShowerWorldSystem {
   void on_key(int key, int action, int mod);
   void on_mouse_move(vec2 pos);
 
-  // restart level
+  // restart level, with the round prepared before if there is one
   void restart_game();
 
+  // Builds the next round aside, see Scene::prepare. The scene must not step
+  // meanwhile.
+  void prepare_round();
+
  private:
   // holds the scene state
   std::shared_ptr<ShowerRegistry> registry;
+  // holds the next round until restart_game swaps it in
+  std::shared_ptr<ShowerRegistry> staging = std::make_shared<ShowerRegistry>();
+  bool round_prepared = false;
 
-  std::shared_ptr<WindowManager> window_manager;
+  std::shared_ptr<Viewport> viewport;
+  std::shared_ptr<SceneEvents> events;
 
+  // adds the birds to the staging registry
   void init_swarm();
   void step_swarm(float delta);
+  // steers the birds, the defaults are tuned for the shower screen
+  Boids swarm;
 
   // Number of fish eaten by the salmon, displayed in the window title
   unsigned int points;
 
   // Game state
-  std::shared_ptr<RenderSystem> renderer;
+  std::shared_ptr<MeshLibrary> meshes;
   std::shared_ptr<ShowerPhysicsSystem> physics;
   float current_speed;
   float next_cat_spawn;
@@ -73,9 +81,8 @@ class ShowerWorldSystem {
   Entity camera;
 
   // music references
-  Mix_Music* background_music;
-  Mix_Chunk* doge_dead_sound;
-  Mix_Chunk* doge_eat_sound;
+  Sound doge_dead_sound;
+  Sound doge_eat_sound;
 
   // C++ random number generator
   std::default_random_engine rng;
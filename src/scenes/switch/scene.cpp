@@ -1,7 +1,9 @@
 #include "scene.hpp"
 
+#include "random_service.hpp"
+
 SwitchPlayersScene::SwitchPlayersScene() {
-  rng = std::default_random_engine(std::random_device()());
+  rng = random_service.engine("switch");
 
   std::shared_ptr<SwitchRegistry> registry = std::make_shared<SwitchRegistry>();
   this->registry = registry;
@@ -20,14 +22,12 @@ void SwitchPlayersScene::init(std::shared_ptr<WindowManager> window_manager,
   registry->clear_all_components();
 
   int window_width, window_height;
-  glfwGetFramebufferSize(window_manager->get_window(), &window_width,
-                         &window_height);
+  window_manager->get_framebuffer_size(&window_width, &window_height);
   assert(renderer->init(registry, window_width, window_height,
                         window_manager->get_window()));
 
   previous_mini_game = next_game_to_switch_to;
   next_game_to_switch_to = GameMode::MAC_GAME;
-  srand(time(NULL));
 }
 
 void SwitchPlayersScene::request_new_minigame() {
@@ -36,11 +36,17 @@ void SwitchPlayersScene::request_new_minigame() {
 }
 
 bool SwitchPlayersScene::step(float delta) {
-  (void)delta;
+  // only this step's text is drawn
+  renderer->clear_text();
+
+  // characters of the tutorial story typed during this step
+  typist_ms += delta;
+  characters_to_type = int(typist_ms / TYPIST_MS_PER_CHARACTER);
+  typist_ms -= characters_to_type * TYPIST_MS_PER_CHARACTER;
 
   if (!game_selected && !overwrite) {
     while (next_game_to_switch_to == previous_mini_game) {
-      next_game_to_switch_to = GameMode(rand() % int(GameMode::GAME_COUNT));
+      next_game_to_switch_to = GameMode(rng() % int(GameMode::GAME_COUNT));
       printf("Current mini game is %d\n", int(next_game_to_switch_to));
       game_selected = true;
     }
@@ -68,9 +74,15 @@ bool SwitchPlayersScene::step(float delta) {
       assert(false);
       break;
   }
+  renderer->show_text_only(background_color);
 
   return true;
 }
+
+void SwitchPlayersScene::publish() { renderer->publish(); }
+
+void SwitchPlayersScene::draw() { renderer->draw(); }
+
 void SwitchPlayersScene::_mac_game_render() {
   renderer->add_text_to_be_rendered({"Survive in space!"}, vec2(0.02, 0.9), 1.1,
                                     vec3(1.0, 1.0, 1.0),
@@ -79,7 +91,7 @@ void SwitchPlayersScene::_mac_game_render() {
     renderer->add_text_block_to_be_rendered(
         mac_story.substr(0, mac_story_string_count), 60, vec2(0.05, 0.8), 0.86,
         vec3(1, 1, 1), RenderSystem::FONTS::REGULAR, 0.25);
-    mac_story_string_count++;
+    mac_story_string_count += characters_to_type;
   }
   renderer->add_text_to_be_rendered(mac_help, vec2(0.70, 0.5), 0.5,
                                     vec3(1.0, 1.0, 1.0),
@@ -92,10 +104,7 @@ void SwitchPlayersScene::_mac_game_render() {
   screen.screen_brightness = 0.5;
   screen.blur_partial = true;
   screen.blur_rect_position = glm::vec4(0.66, 0.42, 0.4, 0.14);
-
-  renderer->render_text_only(vec3(0.298, 0, 0.945));
-  screen.blur_partial = false;
-  screen.screen_brightness = 1.0;
+  background_color = vec3(0.298, 0, 0.945);
 }
 void SwitchPlayersScene::_planit_game_render() {
   renderer->add_text_to_be_rendered({"Time to Refill!"}, vec2(0.02, 0.9), 1.1,
@@ -105,7 +114,7 @@ void SwitchPlayersScene::_planit_game_render() {
     renderer->add_text_block_to_be_rendered(
         planit_story.substr(0, planit_story_string_count), 60, vec2(0.05, 0.8),
         0.86, vec3(1, 1, 1), RenderSystem::FONTS::REGULAR, 0.25);
-    planit_story_string_count++;
+    planit_story_string_count += characters_to_type;
   }
 
   renderer->add_text_to_be_rendered(planit_help, vec2(0.77, 0.5), 0.5,
@@ -119,10 +128,7 @@ void SwitchPlayersScene::_planit_game_render() {
   screen.screen_brightness = 0.5;
   screen.blur_partial = true;
   screen.blur_rect_position = glm::vec4(0.75, 0.43, 0.25, 0.12);
-
-  renderer->render_text_only(vec3(0.09, 0.259, 0.714));
-  screen.blur_partial = false;
-  screen.screen_brightness = 1.0;
+  background_color = vec3(0.09, 0.259, 0.714);
 }
 
 void SwitchPlayersScene::_shower_game_render() {
@@ -133,7 +139,7 @@ void SwitchPlayersScene::_shower_game_render() {
     renderer->add_text_block_to_be_rendered(
         shower_story.substr(0, shower_story_string_count), 60, vec2(0.05, 0.8),
         0.86, vec3(1, 1, 1), RenderSystem::FONTS::REGULAR, 0.25);
-    shower_story_string_count++;
+    shower_story_string_count += characters_to_type;
   }
 
   renderer->add_text_to_be_rendered(shower_help, vec2(0.77, 0.6), 0.5,
@@ -147,10 +153,7 @@ void SwitchPlayersScene::_shower_game_render() {
   screen.screen_brightness = 0.75;
   screen.blur_partial = true;
   screen.blur_rect_position = glm::vec4(0.75, 0.4, 0.25, 0.25);
-
-  renderer->render_text_only(vec3(0.973, 0.561, 0.549));
-  screen.blur_partial = false;
-  screen.screen_brightness = 1.0;
+  background_color = vec3(0.973, 0.561, 0.549);
 }
 
 void SwitchPlayersScene::_constrained_chaos_game_render() {
@@ -162,7 +165,7 @@ void SwitchPlayersScene::_constrained_chaos_game_render() {
         constrained_chaos_story.substr(0, constrained_chaos_string_count), 60,
         vec2(0.05, 0.8), 0.86, vec3(1, 1, 1), RenderSystem::FONTS::REGULAR,
         0.25);
-    constrained_chaos_string_count++;
+    constrained_chaos_string_count += characters_to_type;
   }
 
   renderer->add_text_to_be_rendered(constrained_chaos_help, vec2(0.77, 0.6),
@@ -176,10 +179,7 @@ void SwitchPlayersScene::_constrained_chaos_game_render() {
   screen.screen_brightness = 0.75;
   screen.blur_partial = true;
   screen.blur_rect_position = glm::vec4(0.75, 0.4, 0.25, 0.25);
-
-  renderer->render_text_only(vec3(0.898, 0.263, 0.016));
-  screen.blur_partial = false;
-  screen.screen_brightness = 1.0;
+  background_color = vec3(0.898, 0.263, 0.016);
 }
 
 void SwitchPlayersScene::_daycare_game_render() {
@@ -190,7 +190,7 @@ void SwitchPlayersScene::_daycare_game_render() {
     renderer->add_text_block_to_be_rendered(
         daycare_story.substr(0, daycare_story_count), 60, vec2(0.05, 0.8), 0.86,
         vec3(1, 1, 1), RenderSystem::FONTS::REGULAR, 0.25);
-    daycare_story_count++;
+    daycare_story_count += characters_to_type;
   }
 
   renderer->add_text_to_be_rendered(daycare_help, vec2(0.735, 0.7), 0.5,
@@ -204,10 +204,7 @@ void SwitchPlayersScene::_daycare_game_render() {
   screen.screen_brightness = 0.75;
   screen.blur_partial = true;
   screen.blur_rect_position = glm::vec4(0.72, 0.6, 0.28, 0.15);
-
-  renderer->render_text_only(vec3(0.914, 0.553, 0.961));
-  screen.blur_partial = false;
-  screen.screen_brightness = 1.0;
+  background_color = vec3(0.914, 0.553, 0.961);
 }
 void SwitchPlayersScene::reset_scene() {
   game_selected = false;
@@ -223,6 +220,8 @@ void SwitchPlayersScene::on_key(int key, int action, int mod) {
 
 void SwitchPlayersScene::on_mouse_move(vec2 pos) { (void)pos; }
 
+uint64_t SwitchPlayersScene::state_hash() { return registry->state_hash(); }
+
 GameMode SwitchPlayersScene::get_next_game_mode() {
   return next_game_to_switch_to;
 }
@@ -26,6 +26,12 @@ class SwitchPlayersScene : public Scene {
   // steps the scene ahead by delta (in milliseconds)
   bool step(float delta);
 
+  // see Scene::publish
+  void publish();
+
+  // renders the tutorial of the next game
+  void draw();
+
   // rests the scene
   void reset_scene();
 
@@ -35,6 +41,9 @@ class SwitchPlayersScene : public Scene {
   // input callback for mouse movement
   void on_mouse_move(vec2 pos);
 
+  // see Scene::state_hash
+  uint64_t state_hash();
+
   GameMode get_next_game_mode();
 
   void change_next_game_mode(GameMode new_game_mode);
@@ -126,6 +135,9 @@ class SwitchPlayersScene : public Scene {
   bool game_selected = false;
   bool overwrite = false;
   bool render_tutorial = true;
+  float typist_ms = 0;         // time not yet spent on typing a character
+  int characters_to_type = 0;  // story characters typed this step
+  vec3 background_color = {0, 0, 0};  // of the tutorial, set by the step
   GameMode next_game_to_switch_to;
   GameMode previous_mini_game;
 
@@ -21,7 +21,7 @@ Entity createLine(std::shared_ptr<BoardRegistry> registry, vec2 position,
 }
 
 Entity createPlayer(std::shared_ptr<MacRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer, vec2 pos) {
+                    std::shared_ptr<MeshLibrary> meshes, vec2 pos) {
   auto entity = Entity();
   //std::default_random_engine rng;
   //std::uniform_real_distribution<float> uniform_dist;
@@ -29,7 +29,7 @@ Entity createPlayer(std::shared_ptr<MacRegistry> registry,
   //float screen_height = 800;
 
   // Store a reference to the potentially re-used mesh object
-  Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SALMON);
+  Mesh& mesh = meshes->getMesh(GEOMETRY_BUFFER_ID::SALMON);
   registry->meshPtrs.emplace(entity, &mesh);
 
   // Setting initial motion values
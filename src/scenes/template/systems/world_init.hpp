@@ -5,7 +5,7 @@
 
 #include "../registry.hpp"
 #include "common.hpp"
-#include "render_system.hpp"
+#include "scene_io.hpp"
 #include "tiny_ecs.hpp"
 
 // a red line for debugging purposes
@@ -14,4 +14,4 @@ Entity createLine(std::shared_ptr<BoardRegistry> registry, vec2 position,
 
 // the player
 Entity createPlayer(std::shared_ptr<MacRegistry> registry,
-                    std::shared_ptr<RenderSystem> renderer, vec2 pos);
+                    std::shared_ptr<MeshLibrary> meshes, vec2 pos);
@@ -13,7 +13,6 @@
 #include <string>
 
 #include "physics_system.hpp"
-#include "window_manager.hpp"
 
 // Game configuration
 
@@ -27,21 +26,21 @@ TemplateWorldSystem::~TemplateWorldSystem() {
   registry->clear_all_components();
 
   // clean up all the shared pointers
-  renderer = nullptr;
+  meshes = nullptr;
   registry = nullptr;
   physics = nullptr;
-  window_manager = nullptr;
+  viewport = nullptr;
 }
 
 void TemplateWorldSystem::init(std::shared_ptr<TemplateRegistry> registry,
-                               std::shared_ptr<RenderSystem> renderer,
+                               std::shared_ptr<MeshLibrary> meshes,
                                std::shared_ptr<TemplatePhysicsSystem> physics,
-                               std::shared_ptr<WindowManager> window_manager,
+                               std::shared_ptr<Viewport> viewport,
                                std::function<void()> on_scene_end) {
   this->registry = registry;
-  this->renderer = renderer;
+  this->meshes = meshes;
   this->physics = physics;
-  this->window_manager = window_manager;
+  this->viewport = viewport;
   this->on_game_end_callback_ptr = on_scene_end;
 
   // Set all states to default
@@ -54,9 +53,8 @@ bool TemplateWorldSystem::step(float delta) {
   registry->camera.get(camera).cameraTarget =
       registry->transforms.get(current_player).position;
   // Get the screen dimensions
-  auto window = window_manager->get_window();
   int screen_width, screen_height;
-  glfwGetFramebufferSize(window, &screen_width, &screen_height);
+  viewport->get_framebuffer_size(&screen_width, &screen_height);
 
   // add step functions here
 
@@ -7,14 +7,9 @@
 #include <random>
 #include <vector>
 
-#define SDL_MAIN_HANDLED
-#include <SDL.h>
-#include <SDL_mixer.h>
-
 #include "../registry.hpp"
 #include "physics_system.hpp"
-#include "render_system.hpp"
-#include "window_manager.hpp"
+#include "scene_io.hpp"
 
 // Container for all our entities and game logic. Individual rendering / update
 // is deferred to the relative update() methods
@@ -24,9 +19,9 @@ class TemplateWorldSystem {
 
   // starts the game
   void init(std::shared_ptr<TemplateRegistry> registry,
-            std::shared_ptr<RenderSystem> renderer,
+            std::shared_ptr<MeshLibrary> meshes,
             std::shared_ptr<TemplatePhysicsSystem> physics,
-            std::shared_ptr<WindowManager> window_manager,
+            std::shared_ptr<Viewport> viewport,
             std::function<void()> on_scene_end);
 
   // Releases all associated resources
@@ -52,19 +47,16 @@ class TemplateWorldSystem {
   // holds the scene state
   std::shared_ptr<TemplateRegistry> registry;
 
-  std::shared_ptr<WindowManager> window_manager;
+  std::shared_ptr<Viewport> viewport;
 
   // C++ random number generator
   std::default_random_engine rng;
   std::uniform_real_distribution<float> uniform_dist;  // number between 0..1
 
   Entity current_player;
-  std::shared_ptr<RenderSystem> renderer;
+  std::shared_ptr<MeshLibrary> meshes;
   std::shared_ptr<TemplatePhysicsSystem> physics;
 
-  // Audio
-  Mix_Music *background_music;
-
   // callback called when the game ends
   std::function<void()> on_game_end_callback_ptr;
 };
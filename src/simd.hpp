@@ -0,0 +1,67 @@
+#pragma once
+
+// x86 SIMD support for the batched kernels (narrow phase, boids, particles).
+//
+// SSE2 is part of x86-64 so those paths are always compiled in there. AVX2
+// code is compiled per function with SIMD_TARGET_AVX2 and only called when
+// simd_has_avx2() says the CPU runs it, so the game still starts on older
+// machines. Other architectures use the scalar code.
+//
+// With fma enabled the compiler may fuse a multiply and an add, which rounds
+// once instead of twice. Kernels that must match the scalar code bit for bit
+// use SIMD_TARGET_AVX2_EXACT instead.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_AVX2_EXACT
+#else
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SIMD_TARGET_AVX2_EXACT __attribute__((target("avx2")))
+#endif
+#else
+#define SIMD_X86 0
+#endif
+
+// Widest instruction set a kernel may use
+enum class SimdLevel { SCALAR = 0, SSE = 1, AVX2 = 2 };
+
+inline bool simd_has_avx2() {
+#if SIMD_X86 && defined(_MSC_VER) && !defined(__clang__)
+  static const bool has_avx2 = []() {
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+  }();
+  return has_avx2;
+#elif SIMD_X86
+  static const bool has_avx2 = __builtin_cpu_supports("avx2") &&
+                               __builtin_cpu_supports("fma");
+  return has_avx2;
+#else
+  return false;
+#endif
+}
+
+// Best level this CPU supports
+inline SimdLevel simd_best_level() {
+#if SIMD_X86
+  return simd_has_avx2() ? SimdLevel::AVX2 : SimdLevel::SSE;
+#else
+  return SimdLevel::SCALAR;
+#endif
+}
+
+inline const char *simd_level_name(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::AVX2:
+      return "avx2";
+    case SimdLevel::SSE:
+      return "sse";
+    default:
+      return "scalar";
+  }
+}
@@ -0,0 +1,27 @@
+#include "sound.hpp"
+
+SoundLibrary sound_library;
+
+Sound SoundLibrary::sound(const std::string &file) {
+  std::lock_guard<std::mutex> lock(mutex);
+  request_count++;
+  Sound &sample = samples[file];
+  if (sample == nullptr) {
+    sample = std::make_shared<AudioSample>();
+    sample->file = file;
+    if (on_new) on_new(sample);
+  }
+  return sample;
+}
+
+void SoundLibrary::set_on_new(std::function<void(const Sound &)> on_new) {
+  std::lock_guard<std::mutex> lock(mutex);
+  this->on_new = on_new;
+  if (!on_new) return;
+  for (auto &sample : samples) on_new(sample.second);
+}
+
+size_t SoundLibrary::requests() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return request_count;
+}
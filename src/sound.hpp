@@ -0,0 +1,42 @@
+#pragma once
+
+// stlib
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// SDL_mixer, only the AudioBank looks inside
+struct Mix_Chunk;
+
+// A sound effect of data/audio, decoded to the format of the audio device
+struct AudioSample {
+  std::string file;
+  std::atomic<Mix_Chunk *> chunk{nullptr};  // null until decoded
+};
+using Sound = std::shared_ptr<AudioSample>;
+
+// Hands out one shared sample per file of data/audio. The worlds ask for
+// their sounds when they are created and play them through SceneEvents, the
+// AudioBank decodes them when the game has an audio device.
+class SoundLibrary {
+ public:
+  Sound sound(const std::string &file);
+
+  // Calls on_new with every sample handed out so far and then with each new
+  // one, from the thread asking for it. Null stops the calls.
+  void set_on_new(std::function<void(const Sound &)> on_new);
+
+  // Calls to sound() so far, a file asked for twice counts twice
+  size_t requests();
+
+ private:
+  std::mutex mutex;
+  std::map<std::string, Sound> samples;
+  size_t request_count = 0;
+  std::function<void(const Sound &)> on_new;
+};
+extern SoundLibrary sound_library;
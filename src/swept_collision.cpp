@@ -0,0 +1,71 @@
+#include "swept_collision.hpp"
+
+// stlib
+#include <algorithm>
+#include <cmath>
+
+#include <glm/common.hpp>     // abs
+#include <glm/geometric.hpp>  // dot, length
+
+bool sweep_circles(glm::vec2 start, glm::vec2 motion, float radius,
+                   glm::vec2 other, float other_radius, float &out_toi) {
+  // Solve |start + motion * t - other| = radius + other_radius for t
+  glm::vec2 d = start - other;
+  float r = radius + other_radius;
+  float c = glm::dot(d, d) - r * r;
+  if (c <= 0.f) {
+    out_toi = 0.f;
+    return true;
+  }
+  float a = glm::dot(motion, motion);
+  float b = glm::dot(d, motion);  // half of the linear term
+  if (a == 0.f || b >= 0.f) return false;  // not moving closer
+  float discriminant = b * b - a * c;
+  if (discriminant < 0.f) return false;
+  float t = (-b - std::sqrt(discriminant)) / a;
+  if (t > 1.f) return false;
+  out_toi = t;
+  return true;
+}
+
+bool sweep_boxes(glm::vec2 start, glm::vec2 motion, glm::vec2 half_extents,
+                 glm::vec2 other, glm::vec2 other_half_extents, float &out_toi,
+                 glm::vec2 &out_normal) {
+  // Ray from start against the other box grown by this one (Minkowski sum)
+  glm::vec2 extents = glm::abs(half_extents) + glm::abs(other_half_extents);
+  glm::vec2 lo = other - extents;
+  glm::vec2 hi = other + extents;
+  float enter = -INFINITY, exit = INFINITY;
+  int enter_axis = -1;
+  for (int axis = 0; axis < 2; axis++) {
+    if (motion[axis] == 0.f) {
+      // parallel to the slab, must already be inside it
+      if (start[axis] <= lo[axis] || start[axis] >= hi[axis]) return false;
+      continue;
+    }
+    float t0 = (lo[axis] - start[axis]) / motion[axis];
+    float t1 = (hi[axis] - start[axis]) / motion[axis];
+    if (t0 > t1) std::swap(t0, t1);
+    if (t0 > enter) {
+      enter = t0;
+      enter_axis = axis;
+    }
+    exit = std::min(exit, t1);
+  }
+  if (enter >= exit || exit <= 0.f || enter > 1.f) return false;
+
+  out_normal = {0.f, 0.f};
+  if (enter <= 0.f) {
+    out_toi = 0.f;  // already overlapping
+    return true;
+  }
+  out_toi = enter;
+  out_normal[enter_axis] = motion[enter_axis] > 0.f ? -1.f : 1.f;
+  return true;
+}
+
+int substep_count(glm::vec2 motion, float radius, int max_substeps) {
+  if (radius <= 0.f) return max_substeps;
+  int count = (int)std::ceil(glm::length(motion) / radius);
+  return std::max(1, std::min(count, max_substeps));
+}
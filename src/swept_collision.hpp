@@ -0,0 +1,27 @@
+#pragma once
+
+// The glm library provides vector and matrix operations as in GLSL
+#include <glm/vec2.hpp>  // vec2
+
+// Continuous collision tests for bodies moving fast enough to pass through
+// something between two steps (see FastBody).
+//
+// Each test moves the first shape along motion during the step, the other
+// shape stays still, and returns the time of impact as a fraction of the step
+// in out_toi: 0 when they already overlap at the start, 1 at the end of the
+// motion. Nothing in here touches the ECS or OpenGL.
+
+// Circle of radius centered at start against a circle centered at other
+bool sweep_circles(glm::vec2 start, glm::vec2 motion, float radius,
+                   glm::vec2 other, float other_radius, float &out_toi);
+
+// Box against box, both given by their center and half extents. out_normal
+// is the face of the other box that was hit, pointing out of it, and zero
+// when they already overlap.
+bool sweep_boxes(glm::vec2 start, glm::vec2 motion, glm::vec2 half_extents,
+                 glm::vec2 other, glm::vec2 other_half_extents, float &out_toi,
+                 glm::vec2 &out_normal);
+
+// Number of sub steps so that a body of this radius never moves more than its
+// radius at once, between 1 and max_substeps
+int substep_count(glm::vec2 motion, float radius, int max_substeps);
@@ -0,0 +1,74 @@
+#include "system_scheduler.hpp"
+
+// stlib
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+using Access = SystemScheduler::Access;
+
+bool shares(const Access &a, const Access &b) {
+  for (const ContainerInterface *container : a)
+    if (std::find(b.begin(), b.end(), container) != b.end()) return true;
+  return false;
+}
+
+}  // namespace
+
+bool SystemScheduler::conflict(const System &a, const System &b) {
+  return shares(a.writes, b.writes) || shares(a.writes, b.reads) ||
+         shares(a.reads, b.writes);
+}
+
+void SystemScheduler::add(const std::string &name, Access reads, Access writes,
+                          std::function<void(float)> step) {
+  add({name, std::move(reads), std::move(writes), false, std::move(step), {}});
+}
+
+void SystemScheduler::add_exclusive(const std::string &name,
+                                    std::function<void(float)> step) {
+  add({name, {}, {}, true, std::move(step), {}});
+}
+
+void SystemScheduler::add(System system) {
+  // the systems since the last exclusive one, that one is already done when
+  // this one starts
+  if (!system.exclusive) {
+    for (size_t i = systems.size(); i-- > 0 && !systems[i].exclusive;)
+      if (conflict(systems[i], system)) system.after.push_back(i);
+  }
+  systems.push_back(std::move(system));
+}
+
+void SystemScheduler::clear() { systems.clear(); }
+
+void SystemScheduler::step(float delta) {
+  jobs.assign(systems.size(), nullptr);
+  size_t first = 0;  // of the systems since the last exclusive one
+  for (size_t i = 0; i < systems.size(); i++) {
+    System &system = systems[i];
+    if (system.exclusive) {
+      for (size_t j = first; j < i; j++) job_system.wait(jobs[j]);
+      system.step(delta);
+      first = i + 1;
+      continue;
+    }
+    std::vector<JobSystem::JobHandle> dependencies;
+    for (size_t j : system.after) dependencies.push_back(jobs[j]);
+    jobs[i] = job_system.submit([&system, delta] { system.step(delta); },
+                                dependencies);
+  }
+  for (size_t j = first; j < systems.size(); j++) job_system.wait(jobs[j]);
+}
+
+void SystemScheduler::print() const {
+  for (const System &system : systems) {
+    printf("%s", system.name.c_str());
+    if (system.exclusive) printf(" (exclusive)");
+    for (size_t j = 0; j < system.after.size(); j++)
+      printf("%s%s", j == 0 ? " after " : ", ",
+             systems[system.after[j]].name.c_str());
+    printf("\n");
+  }
+}
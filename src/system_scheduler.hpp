@@ -0,0 +1,60 @@
+#pragma once
+
+// stlib
+#include <functional>
+#include <string>
+#include <vector>
+
+// internal
+#include "job_system.hpp"
+#include "tiny_ecs.hpp"
+
+// Runs the systems of a scene every step, in parallel on the job system where
+// they do not share components.
+//
+// Each system declares the component containers it reads and the ones it
+// writes. A system waits for every system added before it that writes a
+// container it touches, or reads a container it writes. Two systems therefore
+// only run at the same time when neither can see the other's writes, and a
+// step gives the same state as running the systems one by one in the order
+// they were added.
+//
+// Exclusive systems may touch anything: the whole registry, the rng, the
+// renderer's text or GLFW. They run alone on the calling thread, after every
+// system added before them and before every system added after them. A
+// system creating or removing entities has to be exclusive.
+class SystemScheduler {
+ public:
+  using Access = std::vector<const ContainerInterface *>;
+
+  // Adds a system that only touches the containers of reads and writes
+  void add(const std::string &name, Access reads, Access writes,
+           std::function<void(float)> step);
+
+  // Adds a system that may touch anything
+  void add_exclusive(const std::string &name, std::function<void(float)> step);
+
+  // Removes all systems
+  void clear();
+
+  // Runs every system once and returns when all of them are done
+  void step(float delta);
+
+  // Prints each system and the systems it waits for
+  void print() const;
+
+ private:
+  struct System {
+    std::string name;
+    Access reads;
+    Access writes;
+    bool exclusive;
+    std::function<void(float)> step;
+    std::vector<size_t> after;  // systems it waits for, added before it
+  };
+  std::vector<System> systems;
+  std::vector<JobSystem::JobHandle> jobs;  // of the systems in this step
+
+  void add(System system);
+  static bool conflict(const System &a, const System &b);
+};
@@ -0,0 +1,325 @@
+#include "texture_codec.hpp"
+
+// stlib
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// .dds layout, see "DDS_HEADER structure" in the DirectX documentation
+const uint32_t DDS_MAGIC = 0x20534444;  // "DDS "
+const uint32_t DDS_FOURCC_DXT5 = 0x35545844;  // "DXT5"
+const uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4,
+               DDSD_PIXELFORMAT = 0x1000, DDSD_MIPMAPCOUNT = 0x20000,
+               DDSD_LINEARSIZE = 0x80000;
+const uint32_t DDPF_FOURCC = 0x4;
+const uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000,
+               DDSCAPS_MIPMAP = 0x400000;
+
+struct DDSHeader {
+  uint32_t size;
+  uint32_t flags;
+  uint32_t height;
+  uint32_t width;
+  uint32_t pitch_or_linear_size;
+  uint32_t depth;
+  uint32_t mip_map_count;
+  uint32_t reserved1[11];
+  // DDS_PIXELFORMAT
+  uint32_t pf_size;
+  uint32_t pf_flags;
+  uint32_t pf_four_cc;
+  uint32_t pf_rgb_bit_count;
+  uint32_t pf_bit_masks[4];
+  uint32_t caps;
+  uint32_t caps2;
+  uint32_t caps3;
+  uint32_t caps4;
+  uint32_t reserved2;
+};
+static_assert(sizeof(DDSHeader) == 124, "DDS header must be 124 bytes");
+
+uint16_t pack_565(const uint8_t *rgb) {
+  return (uint16_t)(((rgb[0] * 31 + 127) / 255) << 11 |
+                    ((rgb[1] * 63 + 127) / 255) << 5 |
+                    ((rgb[2] * 31 + 127) / 255));
+}
+
+void unpack_565(uint16_t c, uint8_t *rgb) {
+  uint8_t r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+  rgb[0] = (uint8_t)(r << 3 | r >> 2);
+  rgb[1] = (uint8_t)(g << 2 | g >> 4);
+  rgb[2] = (uint8_t)(b << 3 | b >> 2);
+}
+
+// BC3 always interpolates 4 colors, whatever the order of the endpoints
+void color_palette(uint16_t c0, uint16_t c1, uint8_t palette[4][3]) {
+  unpack_565(c0, palette[0]);
+  unpack_565(c1, palette[1]);
+  for (int k = 0; k < 3; k++) {
+    palette[2][k] = (uint8_t)((2 * palette[0][k] + palette[1][k]) / 3);
+    palette[3][k] = (uint8_t)((palette[0][k] + 2 * palette[1][k]) / 3);
+  }
+}
+
+void alpha_palette(uint8_t a0, uint8_t a1, uint8_t palette[8]) {
+  palette[0] = a0;
+  palette[1] = a1;
+  if (a0 > a1) {
+    for (int k = 1; k < 7; k++)
+      palette[k + 1] = (uint8_t)(((7 - k) * a0 + k * a1) / 7);
+  } else {
+    for (int k = 1; k < 5; k++)
+      palette[k + 1] = (uint8_t)(((5 - k) * a0 + k * a1) / 5);
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+}
+
+// Encode the 4x4 RGBA texels in block into 16 bytes of BC3
+void encode_block(const uint8_t block[16][4], uint8_t *out) {
+  // Alpha: 8 interpolated values between the extremes
+  uint8_t a_min = 255, a_max = 0;
+  for (int i = 0; i < 16; i++) {
+    a_min = std::min(a_min, block[i][3]);
+    a_max = std::max(a_max, block[i][3]);
+  }
+  uint8_t alphas[8];
+  alpha_palette(a_max, a_min, alphas);
+  uint64_t alpha_bits = 0;
+  for (int i = 0; i < 16 && a_max != a_min; i++) {
+    int best = 0, best_error = 256;
+    for (int k = 0; k < 8; k++) {
+      int error = std::abs((int)alphas[k] - (int)block[i][3]);
+      if (error < best_error) {
+        best = k;
+        best_error = error;
+      }
+    }
+    alpha_bits |= (uint64_t)best << (3 * i);
+  }
+  out[0] = a_max;
+  out[1] = a_min;
+  for (int k = 0; k < 6; k++) out[2 + k] = (uint8_t)(alpha_bits >> (8 * k));
+
+  // Color: inset bounding box of the visible texels. Fully transparent texels
+  // can take any color so they do not stretch the endpoints.
+  uint8_t c_min[3] = {255, 255, 255}, c_max[3] = {0, 0, 0};
+  bool any_visible = a_max > 0;
+  for (int i = 0; i < 16; i++) {
+    if (any_visible && block[i][3] == 0) continue;
+    for (int k = 0; k < 3; k++) {
+      c_min[k] = std::min(c_min[k], block[i][k]);
+      c_max[k] = std::max(c_max[k], block[i][k]);
+    }
+  }
+  for (int k = 0; k < 3; k++) {
+    int inset = (c_max[k] - c_min[k]) / 16;
+    c_min[k] = (uint8_t)(c_min[k] + inset);
+    c_max[k] = (uint8_t)(c_max[k] - inset);
+  }
+  uint16_t c0 = pack_565(c_max), c1 = pack_565(c_min);
+  uint8_t colors[4][3];
+  color_palette(c0, c1, colors);
+  uint32_t color_bits = 0;
+  for (int i = 0; i < 16; i++) {
+    int best = 0, best_error = 1 << 30;
+    for (int k = 0; k < 4; k++) {
+      int error = 0;
+      for (int c = 0; c < 3; c++) {
+        int d = (int)colors[k][c] - (int)block[i][c];
+        error += d * d;
+      }
+      if (error < best_error) {
+        best = k;
+        best_error = error;
+      }
+    }
+    color_bits |= (uint32_t)best << (2 * i);
+  }
+  out[8] = (uint8_t)c0;
+  out[9] = (uint8_t)(c0 >> 8);
+  out[10] = (uint8_t)c1;
+  out[11] = (uint8_t)(c1 >> 8);
+  for (int k = 0; k < 4; k++) out[12 + k] = (uint8_t)(color_bits >> (8 * k));
+}
+
+void decode_block(const uint8_t *in, uint8_t block[16][4]) {
+  uint8_t alphas[8];
+  alpha_palette(in[0], in[1], alphas);
+  uint64_t alpha_bits = 0;
+  for (int k = 0; k < 6; k++) alpha_bits |= (uint64_t)in[2 + k] << (8 * k);
+
+  uint8_t colors[4][3];
+  color_palette((uint16_t)(in[8] | in[9] << 8),
+                (uint16_t)(in[10] | in[11] << 8), colors);
+  uint32_t color_bits = 0;
+  for (int k = 0; k < 4; k++) color_bits |= (uint32_t)in[12 + k] << (8 * k);
+
+  for (int i = 0; i < 16; i++) {
+    const uint8_t *color = colors[(color_bits >> (2 * i)) & 3];
+    block[i][0] = color[0];
+    block[i][1] = color[1];
+    block[i][2] = color[2];
+    block[i][3] = alphas[(alpha_bits >> (3 * i)) & 7];
+  }
+}
+
+}  // namespace
+
+size_t bc3_level_size(int width, int height) {
+  return (size_t)std::max(1, (width + 3) / 4) * std::max(1, (height + 3) / 4) *
+         16;
+}
+
+std::vector<TextureLevel> build_mip_chain(const uint8_t *rgba, int width,
+                                          int height) {
+  std::vector<TextureLevel> levels(1);
+  levels[0].width = width;
+  levels[0].height = height;
+  levels[0].data.assign(rgba, rgba + (size_t)width * height * 4);
+
+  while (levels.back().width > 1 || levels.back().height > 1) {
+    const TextureLevel &src = levels.back();
+    TextureLevel dst;
+    dst.width = std::max(1, src.width / 2);
+    dst.height = std::max(1, src.height / 2);
+    dst.data.resize((size_t)dst.width * dst.height * 4);
+    for (int y = 0; y < dst.height; y++) {
+      for (int x = 0; x < dst.width; x++) {
+        unsigned int color[3] = {0, 0, 0}, plain[3] = {0, 0, 0}, alpha = 0;
+        for (int j = 0; j < 2; j++) {
+          for (int i = 0; i < 2; i++) {
+            int sx = std::min(2 * x + i, src.width - 1);
+            int sy = std::min(2 * y + j, src.height - 1);
+            const uint8_t *texel = &src.data[((size_t)sy * src.width + sx) * 4];
+            for (int k = 0; k < 3; k++) {
+              color[k] += texel[k] * texel[3];
+              plain[k] += texel[k];
+            }
+            alpha += texel[3];
+          }
+        }
+        uint8_t *out = &dst.data[((size_t)y * dst.width + x) * 4];
+        for (int k = 0; k < 3; k++)
+          out[k] = (uint8_t)(alpha > 0 ? (color[k] + alpha / 2) / alpha
+                                       : (plain[k] + 2) / 4);
+        out[3] = (uint8_t)((alpha + 2) / 4);
+      }
+    }
+    levels.push_back(std::move(dst));
+  }
+  return levels;
+}
+
+TextureLevel compress_bc3(const TextureLevel &rgba_level) {
+  TextureLevel out;
+  out.width = rgba_level.width;
+  out.height = rgba_level.height;
+  out.data.resize(bc3_level_size(out.width, out.height));
+
+  uint8_t *dst = out.data.data();
+  uint8_t block[16][4];
+  for (int by = 0; by < out.height; by += 4) {
+    for (int bx = 0; bx < out.width; bx += 4) {
+      // Border blocks repeat the last row / column
+      for (int i = 0; i < 16; i++) {
+        int x = std::min(bx + i % 4, out.width - 1);
+        int y = std::min(by + i / 4, out.height - 1);
+        memcpy(block[i], &rgba_level.data[((size_t)y * out.width + x) * 4], 4);
+      }
+      encode_block(block, dst);
+      dst += 16;
+    }
+  }
+  return out;
+}
+
+TextureLevel decompress_bc3(const TextureLevel &bc3_level) {
+  TextureLevel out;
+  out.width = bc3_level.width;
+  out.height = bc3_level.height;
+  out.data.resize((size_t)out.width * out.height * 4);
+
+  const uint8_t *src = bc3_level.data.data();
+  uint8_t block[16][4];
+  for (int by = 0; by < out.height; by += 4) {
+    for (int bx = 0; bx < out.width; bx += 4) {
+      decode_block(src, block);
+      src += 16;
+      for (int i = 0; i < 16; i++) {
+        int x = bx + i % 4, y = by + i / 4;
+        if (x >= out.width || y >= out.height) continue;
+        memcpy(&out.data[((size_t)y * out.width + x) * 4], block[i], 4);
+      }
+    }
+  }
+  return out;
+}
+
+bool write_dds_bc3(const std::string &path,
+                   const std::vector<TextureLevel> &bc3_levels) {
+  if (bc3_levels.empty()) return false;
+  FILE *file = fopen(path.c_str(), "wb");
+  if (file == NULL) return false;
+
+  DDSHeader header;
+  memset(&header, 0, sizeof(header));
+  header.size = sizeof(DDSHeader);
+  header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT |
+                 DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+  header.height = (uint32_t)bc3_levels[0].height;
+  header.width = (uint32_t)bc3_levels[0].width;
+  header.pitch_or_linear_size = (uint32_t)bc3_levels[0].data.size();
+  header.mip_map_count = (uint32_t)bc3_levels.size();
+  header.pf_size = 32;
+  header.pf_flags = DDPF_FOURCC;
+  header.pf_four_cc = DDS_FOURCC_DXT5;
+  header.caps = DDSCAPS_TEXTURE | DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+
+  bool ok = fwrite(&DDS_MAGIC, sizeof(DDS_MAGIC), 1, file) == 1 &&
+            fwrite(&header, sizeof(header), 1, file) == 1;
+  for (const TextureLevel &level : bc3_levels) {
+    ok = ok && fwrite(level.data.data(), 1, level.data.size(), file) ==
+                   level.data.size();
+  }
+  fclose(file);
+  return ok;
+}
+
+bool read_dds_bc3(const std::string &path,
+                  std::vector<TextureLevel> &out_bc3_levels) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (file == NULL) return false;
+
+  uint32_t magic = 0;
+  DDSHeader header;
+  bool ok = fread(&magic, sizeof(magic), 1, file) == 1 &&
+            fread(&header, sizeof(header), 1, file) == 1 &&
+            magic == DDS_MAGIC && header.size == sizeof(DDSHeader) &&
+            (header.pf_flags & DDPF_FOURCC) &&
+            header.pf_four_cc == DDS_FOURCC_DXT5;
+
+  out_bc3_levels.clear();
+  if (ok) {
+    uint32_t count = (header.flags & DDSD_MIPMAPCOUNT) && header.mip_map_count
+                         ? header.mip_map_count
+                         : 1;
+    int width = (int)header.width, height = (int)header.height;
+    for (uint32_t i = 0; i < count && ok; i++) {
+      TextureLevel level;
+      level.width = width;
+      level.height = height;
+      level.data.resize(bc3_level_size(width, height));
+      ok = fread(level.data.data(), 1, level.data.size(), file) ==
+           level.data.size();
+      out_bc3_levels.push_back(std::move(level));
+      width = std::max(1, width / 2);
+      height = std::max(1, height / 2);
+    }
+  }
+  fclose(file);
+  return ok;
+}
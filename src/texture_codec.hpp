@@ -0,0 +1,41 @@
+#pragma once
+
+// stlib
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+// CPU side texture helpers shared by the renderer and the offline
+// texture_compressor tool (see tools/). Nothing in here touches OpenGL.
+//
+// Textures are converted offline to BC3 (DXT5) with a prebuilt mip chain and
+// stored as .dds files in data/textures/compressed/. BC3 keeps a full 8 bit
+// alpha channel, which most of our sprites need, at 1 byte per texel instead of
+// 4 for RGBA8.
+
+// One level of a texture. For RGBA levels data holds width * height * 4 bytes,
+// for BC3 levels it holds the 16 byte blocks covering the level row by row.
+struct TextureLevel {
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> data;
+};
+
+// Size in bytes of a BC3 level, partial blocks on the borders are padded
+size_t bc3_level_size(int width, int height);
+
+// Box filtered mip chain down to 1x1, level 0 is a copy of rgba. Colors are
+// weighted by alpha so transparent texels do not darken the sprite borders.
+std::vector<TextureLevel> build_mip_chain(const uint8_t *rgba, int width,
+                                          int height);
+
+// Encode / decode one level
+TextureLevel compress_bc3(const TextureLevel &rgba_level);
+TextureLevel decompress_bc3(const TextureLevel &bc3_level);
+
+// Read / write a DXT5 .dds file with all its mip levels
+bool write_dds_bc3(const std::string &path,
+                   const std::vector<TextureLevel> &bc3_levels);
+bool read_dds_bc3(const std::string &path,
+                  std::vector<TextureLevel> &out_bc3_levels);
@@ -3,4 +3,4 @@
 
 // All we need to store besides the containers is the id of every entity and
 // callbacks to be able to remove entities across containers
-unsigned int Entity::id_count = 1;
\ No newline at end of file
+std::atomic<unsigned int> Entity::id_count{1};
\ No newline at end of file
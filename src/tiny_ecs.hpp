@@ -3,6 +3,7 @@
 #include <assert.h>
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <set>
 #include <typeindex>
@@ -12,8 +13,9 @@
 // Unique identifier for all entities
 class Entity {
   unsigned int id;
-  static unsigned int
-      id_count;  // starts from 1, entit 0 is the default initialization
+  // starts from 1, entit 0 is the default initialization. Atomic since the
+  // headless tools create entities on several threads.
+  static std::atomic<unsigned int> id_count;
  public:
   Entity() {
     id = id_count++;
@@ -31,6 +33,8 @@ struct ContainerInterface {
   virtual size_t size() = 0;
   virtual void remove(Entity e) = 0;
   virtual bool has(Entity entity) = 0;
+  // other must be a container of the same component type
+  virtual void swap(ContainerInterface &other) = 0;
 };
 
 // A container that stores components of type 'Component' and associated
@@ -120,6 +124,14 @@ class ComponentContainer : public ContainerInterface {
   // Report the number of components of type 'Component'
   size_t size() { return components.size(); }
 
+  // Exchange all components with other without copying them
+  void swap(ContainerInterface &other) {
+    ComponentContainer &container = static_cast<ComponentContainer &>(other);
+    map_entity_componentID.swap(container.map_entity_componentID);
+    components.swap(container.components);
+    entities.swap(container.entities);
+  }
+
   // Sort the components and associated entity assignment structures by the
   // comparisonFunction, see std::sort
   template <class Compare>
@@ -1,4 +1,8 @@
 #pragma once
+#include <assert.h>
+#include <stdint.h>
+
+#include <typeinfo>
 #include <vector>
 
 #include "tiny_ecs.hpp"
@@ -12,8 +16,12 @@ class ECSRegistry {
   ComponentContainer<SpriteAnimation> spriteAnimations;
   ComponentContainer<UIelement> UIelements;
   ComponentContainer<UIPass> UIpasses;
+  ComponentContainer<StaticLayer> staticLayers;
   ComponentContainer<Collision> collisions;
-  ComponentContainer<Collider> colliders;
+  ComponentContainer<CollisionFilter> collisionFilters;
+  ComponentContainer<FastBody> fastBodies;
+  ComponentContainer<Sleeping> sleepers;
+  ComponentContainer<Stillness> stillness;
   ComponentContainer<Mesh *> meshPtrs;
   ComponentContainer<ScreenState> screenStates;
   ComponentContainer<DebugComponent> debugComponents;
@@ -31,8 +39,12 @@ class ECSRegistry {
     registry_list.push_back(&spriteAnimations);
     registry_list.push_back(&UIelements);
     registry_list.push_back(&UIpasses);
+    registry_list.push_back(&staticLayers);
     registry_list.push_back(&collisions);
-    registry_list.push_back(&colliders);
+    registry_list.push_back(&collisionFilters);
+    registry_list.push_back(&fastBodies);
+    registry_list.push_back(&sleepers);
+    registry_list.push_back(&stillness);
     registry_list.push_back(&meshPtrs);
     registry_list.push_back(&screenStates);
     registry_list.push_back(&debugComponents);
@@ -50,6 +62,68 @@ class ECSRegistry {
     for (ContainerInterface *reg : registry_list) reg->clear();
   }
 
+  // Exchanges the components of every container with those of other, a
+  // registry of the same type, without copying any. The screen state belongs
+  // to the RenderSystem and stays. The scenes build the next round into a
+  // staging registry and swap it in when the round starts, see
+  // Scene::prepare.
+  void swap_components(ECSRegistry &other) {
+    assert(typeid(*this) == typeid(other));
+    for (size_t i = 0; i < registry_list.size(); i++)
+      if (registry_list[i] != &screenStates)
+        registry_list[i]->swap(*other.registry_list[i]);
+  }
+
+  // Remembers every pose before a simulation step moves it, so frames falling
+  // between two steps can be drawn interpolated
+  void snapshot_transforms() {
+    for (TransformComponent &transform : transforms.components) {
+      transform.previous_position = transform.position;
+      transform.previous_rotation = transform.rotation;
+      transform.has_previous = true;
+    }
+  }
+
+  // Copies the containers the render system draws from other, see
+  // RenderSystem::publish. The registry itself is not copyable since
+  // registry_list points to its own members.
+  void copy_render_components(const ECSRegistry &other) {
+    renderRequests = other.renderRequests;
+    transforms = other.transforms;
+    spriteAnimations = other.spriteAnimations;
+    UIelements = other.UIelements;
+    UIpasses = other.UIpasses;
+    staticLayers = other.staticLayers;
+    screenStates = other.screenStates;
+    colors = other.colors;
+    camera = other.camera;
+    spaces = other.spaces;
+    particleSystems = other.particleSystems;
+  }
+
+  // FNV-1a of the component counts and the poses. Two runs of the same scene
+  // that end with the same hash ended in the same state, see InputReplay.
+  uint64_t state_hash() {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void *data, size_t size) {
+      const unsigned char *bytes = (const unsigned char *)data;
+      for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+      }
+    };
+    for (ContainerInterface *reg : registry_list) {
+      uint64_t size = reg->size();
+      mix(&size, sizeof(size));
+    }
+    for (const TransformComponent &transform : transforms.components) {
+      mix(&transform.position, sizeof(transform.position));
+      mix(&transform.scale, sizeof(transform.scale));
+      mix(&transform.rotation, sizeof(transform.rotation));
+    }
+    return hash;
+  }
+
   void list_all_components() {
     printf("Debug info on all registry entries:\n");
     for (ContainerInterface *reg : registry_list)
@@ -58,6 +132,13 @@ class ECSRegistry {
                typeid(*reg).name());
   }
 
+  // total number of components in all containers, used to check for leaks
+  size_t count_all_components() {
+    size_t count = 0;
+    for (ContainerInterface *reg : registry_list) count += reg->size();
+    return count;
+  }
+
   void list_all_components_of(Entity e) {
     printf("Debug info on components of entity %u:\n", (unsigned int)e);
     for (ContainerInterface *reg : registry_list)
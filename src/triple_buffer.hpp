@@ -0,0 +1,48 @@
+#pragma once
+
+// stlib
+#include <atomic>
+
+// Hands the newest of a stream of values from one producer thread to one
+// consumer thread without either waiting for the other.
+//
+// The producer fills back() and publish()es it, the consumer acquire()s the
+// newest published value and reads it through front(). Of the three slots one
+// is being written, one is being read and the third holds the newest published
+// value. publish() and acquire() swap their slot with that third one, so a
+// value that is not picked up in time is replaced by the next one and a slow
+// consumer never holds the producer up. Each slot is only touched by one
+// thread at a time.
+template <typename T>
+class TripleBuffer {
+ public:
+  // Slot the producer writes the next value into
+  T &back() { return slots[back_index]; }
+
+  // Makes back() the newest value and hands the producer another slot. The
+  // new back() still holds an older value.
+  void publish() {
+    back_index = middle.exchange(back_index | FRESH) & INDEX;
+  }
+
+  // Moves the newest published value to front(), false when nothing was
+  // published since the last call
+  bool acquire() {
+    if (!(middle.load() & FRESH)) return false;
+    front_index = middle.exchange(front_index) & INDEX;
+    return true;
+  }
+
+  // Value the consumer reads, the newest one as of the last acquire()
+  const T &front() const { return slots[front_index]; }
+  T &front() { return slots[front_index]; }
+
+ private:
+  static const int INDEX = 3;  // bits of the slot index in middle
+  static const int FRESH = 4;  // set while middle was not acquired yet
+
+  T slots[3];
+  int back_index = 0;              // producer only
+  int front_index = 1;             // consumer only
+  std::atomic<int> middle{2};
+};
@@ -3,13 +3,8 @@
 WindowManager::WindowManager() {}
 
 WindowManager::~WindowManager() {
-  // Destroy music components
-  // if (background_music != nullptr)
-  //	Mix_FreeMusic(background_music);
-  Mix_CloseAudio();
-
   // Close the window
-  glfwDestroyWindow(window);
+  if (window != nullptr) glfwDestroyWindow(window);
 }
 
 // Debugging
@@ -19,7 +14,7 @@ void glfw_err_cb(int error, const char *desc) {
 }
 }  // namespace
 
-GLFWwindow *WindowManager::create_window(int width, int height) {
+GLFWwindow *WindowManager::create_window(int width, int height, bool visible) {
   ///////////////////////////////////////
   // Initialize GLFW
   glfwSetErrorCallback(glfw_err_cb);
@@ -29,9 +24,9 @@ GLFWwindow *WindowManager::create_window(int width, int height) {
   }
 
   //-------------------------------------------------------------------------
-  // If you are on Linux or Windows, you can change these 2 numbers to 4 and 3
-  // and enable the glDebugMessageCallback to have OpenGL catch your mistakes
-  // for you. GLFW / OGL Initialization
+  // The debug context lets drivers that expose KHR_debug (most Linux and
+  // Windows drivers, even on 3.3) report errors through
+  // glDebugMessageCallback, see gl_init_debug_output. GLFW / OGL Initialization
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
   glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
@@ -40,6 +35,7 @@ GLFWwindow *WindowManager::create_window(int width, int height) {
   glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
   glfwWindowHint(GLFW_RESIZABLE, 0);
+  glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
 
   const GLFWvidmode *mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
 
@@ -77,16 +73,9 @@ GLFWwindow *WindowManager::create_window(int width, int height) {
   glfwSetKeyCallback(window, key_redirect);
   glfwSetCursorPosCallback(window, cursor_pos_redirect);
 
-  //////////////////////////////////////
-  // Loading music and sounds with SDL
-  if (SDL_Init(SDL_INIT_AUDIO) < 0) {
-    fprintf(stderr, "Failed to initialize SDL Audio");
-    return nullptr;
-  }
-  if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) == -1) {
-    fprintf(stderr, "Failed to open audio device");
-    return nullptr;
-  }
+  glfwGetFramebufferSize(window, &framebuffer_width, &framebuffer_height);
+  glfwGetWindowSize(window, &window_width, &window_height);
+  title = shown_title = "Party Time";
 
   // handle closing the window from OS
   glfwSetWindowCloseCallback(window, glfwDestroyWindow);
@@ -114,3 +103,32 @@ void WindowManager::set_on_mouse_move_callback(
 }
 
 GLFWwindow *WindowManager::get_window() { return window; }
+
+void WindowManager::get_framebuffer_size(int *width, int *height) const {
+  *width = framebuffer_width;
+  *height = framebuffer_height;
+}
+
+void WindowManager::get_window_size(int *width, int *height) const {
+  *width = window_width;
+  *height = window_height;
+}
+
+void WindowManager::set_title(const std::string &title) {
+  std::lock_guard<std::mutex> lock(title_mutex);
+  this->title = title;
+}
+
+void WindowManager::poll_events() {
+  glfwPollEvents();
+
+  std::string next;
+  {
+    std::lock_guard<std::mutex> lock(title_mutex);
+    if (title == shown_title) return;
+    next = title;
+  }
+  // the scenes set the title every step, the window only when it changed
+  glfwSetWindowTitle(window, next.c_str());
+  shown_title = next;
+}
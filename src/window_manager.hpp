@@ -10,21 +10,21 @@
  */
 #pragma once
 
-#define SDL_MAIN_HANDLED
-#include <SDL.h>
-#include <SDL_mixer.h>
-
 #include <functional>
+#include <mutex>
+#include <string>
 
 #include "common.hpp"
+#include "scene_io.hpp"
 
-class WindowManager {
+class WindowManager : public Viewport {
  public:
   WindowManager();
 
   ~WindowManager();
 
-  GLFWwindow* create_window(int width, int height);
+  // a hidden window is used for headless replays
+  GLFWwindow* create_window(int width, int height, bool visible = true);
 
   void on_key(int key, int action, int mod);
 
@@ -36,8 +36,25 @@ class WindowManager {
 
   GLFWwindow* get_window();
 
+  // Most of GLFW may only be used on the main thread while the scenes step on
+  // the simulation thread. The window is not resizable, so its sizes are read
+  // once when it is created, and the title is set by the next poll_events().
+  void get_framebuffer_size(int* width, int* height) const override;
+  void get_window_size(int* width, int* height) const override;
+  void set_title(const std::string& title);
+
+  // Processes the window events and applies the last title set, main thread
+  // only. The input callbacks are called from here.
+  void poll_events();
+
  private:
-  GLFWwindow* window;
+  GLFWwindow* window = nullptr;
+  int framebuffer_width = 0, framebuffer_height = 0;
+  int window_width = 0, window_height = 0;
+
+  std::mutex title_mutex;
+  std::string title;        // last one set
+  std::string shown_title;  // last one applied to the window
   std::function<void(int, int, int)> on_key_callback_ptr;
   std::function<void(glm::vec2)> on_mouse_move_callback_ptr;
 };
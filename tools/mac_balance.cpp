@@ -0,0 +1,267 @@
+/**
+ * @file mac_balance.cpp
+ * @author Team Doge
+ * @brief Headless Monte Carlo runs of the survive in space mini game (mac).
+ * A bot dodges the rocks of the real MacWorldSystem and MacPhysicsSystem, at
+ * the fixed step of the game but as fast as the CPU allows. It only links the
+ * simulation library, without a window, GL or audio. Every combination of the
+ * given rock settings is played for a number of seeded episodes spread over
+ * the cores, and the survival time of every episode is written to a CSV.
+ *
+ * Usage: mac_balance [--max-rocks 10,15,...] [--rock-delay-ms 6000,...]
+ *                    [--episodes N] [--seconds S] [--reaction-ms MS]
+ *                    [--seed N] [--threads N] [--out FILE]
+ * @version 0.1
+ * @date 2021-12-05
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+// stlib
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// internal
+#include "job_system.hpp"
+#include "scene_io.hpp"
+#include "scenes/mac/systems/physics_system.hpp"
+#include "scenes/mac/systems/world_system.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+// the world the camera of the mac scene shows
+const int SCREEN_WIDTH = 1200;
+const int SCREEN_HEIGHT = 675;
+
+// episodes one job plays
+const size_t EPISODES_PER_JOB = 16;
+
+// Steers the salmon away from the rocks that will pass close to it soon,
+// deciding again every reaction_ms like a player would. Otherwise it drifts
+// back to the middle of the screen, where it has room to dodge.
+class DodgeBot {
+ public:
+  explicit DodgeBot(float reaction_ms) : reaction_ms(reaction_ms) {}
+
+  void act(MacRegistry &registry, MacWorldSystem &world, float elapsed_ms) {
+    next_decision_ms -= elapsed_ms;
+    if (next_decision_ms > 0) return;
+    next_decision_ms += reaction_ms;
+
+    vec2 player = registry.transforms.get(registry.players.entities[0])
+                      .position;
+    vec2 away = {0, 0};
+    for (Entity rock : registry.rocks.entities) {
+      vec2 offset = registry.transforms.get(rock).position - player;
+      vec2 velocity = registry.velocities.get(rock).velocity;
+      // closest approach within the horizon, the salmon standing still
+      float speed2 = dot(velocity, velocity);
+      float t = speed2 > 0 ? -dot(offset, velocity) / speed2 : 0;
+      t = std::min(std::max(t, 0.f), HORIZON_S);
+      vec2 closest = offset + velocity * t;
+      float distance = length(closest);
+      if (distance >= DANGER_PX) continue;
+      vec2 direction = distance > 1 ? closest / distance
+                                    : normalize(vec2(-velocity.y, velocity.x));
+      away -= direction * (DANGER_PX - distance) / DANGER_PX;
+    }
+    if (length(away) < 0.1f) away = (HOME - player) / 200.f;
+
+    hold(world, held_x, away.x, GLFW_KEY_LEFT, GLFW_KEY_RIGHT);
+    hold(world, held_y, away.y, GLFW_KEY_UP, GLFW_KEY_DOWN);
+  }
+
+ private:
+  const float HORIZON_S = 1.f;
+  const float DANGER_PX = 200.f;
+  const vec2 HOME = {SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2};
+
+  float reaction_ms;
+  float next_decision_ms = 0;
+  int held_x = 0, held_y = 0;  // -1, 0 or 1 along the axis
+
+  // presses the key of the direction of want along one axis, releasing the
+  // other one first
+  void hold(MacWorldSystem &world, int &held, float want, int negative_key,
+            int positive_key) {
+    int direction = want > 0.2f ? 1 : want < -0.2f ? -1 : 0;
+    if (direction == held) return;
+    if (held != 0)
+      world.on_key(held < 0 ? negative_key : positive_key, GLFW_RELEASE, 0);
+    if (direction != 0)
+      world.on_key(direction < 0 ? negative_key : positive_key, GLFW_PRESS, 0);
+    held = direction;
+  }
+};
+
+struct Setting {
+  MacBalance balance;
+  std::vector<float> survival_s;  // per episode
+};
+
+struct Episode {
+  size_t setting;
+  size_t index;  // within the setting
+};
+
+// Plays one episode on fresh systems until a rock hits the salmon or
+// max_seconds pass, returns the seconds survived
+float play(const MacBalance &balance, std::default_random_engine rng,
+           std::shared_ptr<MeshLibrary> meshes,
+           std::shared_ptr<Viewport> viewport, float reaction_ms,
+           float max_seconds) {
+  std::shared_ptr<MacRegistry> registry = std::make_shared<MacRegistry>();
+  std::shared_ptr<MacPhysicsSystem> physics =
+      std::make_shared<MacPhysicsSystem>();
+  // the sounds and titles of the steps are dropped
+  std::shared_ptr<SceneEvents> events = std::make_shared<SceneEvents>();
+  MacWorldSystem world;
+  world.set_balance(balance);
+  world.set_rng(rng);
+  physics->init(registry);
+  world.init(registry, meshes, physics, viewport, events, [] {});
+  DodgeBot bot(reaction_ms);
+  float elapsed_ms = 0;
+  while (elapsed_ms < max_seconds * 1000) {
+    bot.act(*registry, world, SIMULATION_STEP_MS);
+    world.step(SIMULATION_STEP_MS);
+    physics->step(SIMULATION_STEP_MS, SCREEN_WIDTH, SCREEN_HEIGHT);
+    world.handle_collisions();
+    events->clear();
+    elapsed_ms += SIMULATION_STEP_MS;
+    if (!registry->deathTimers.entities.empty()) break;
+  }
+  return elapsed_ms / 1000;
+}
+
+float percentile(const std::vector<float> &sorted, float p) {
+  return sorted[std::min(sorted.size() - 1, (size_t)(p * sorted.size()))];
+}
+
+std::vector<float> parse_list(const char *list) {
+  std::vector<float> values;
+  for (const char *c = list; *c != '\0';) {
+    char *end;
+    values.push_back(strtof(c, &end));
+    if (end == c) break;
+    c = *end == ',' ? end + 1 : end;
+  }
+  return values;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<float> max_rocks = {10, 15, 20, 25, 30, 35};
+  std::vector<float> rock_delays_ms = {MacBalance().rock_delay_ms};
+  size_t episodes = 1000;
+  float max_seconds = 120;
+  float reaction_ms = 150;
+  uint32_t seed = 1;
+  unsigned int threads = 0;
+  std::string out_path = "mac_balance.csv";
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--max-rocks") == 0 && i + 1 < argc) {
+      max_rocks = parse_list(argv[++i]);
+    } else if (strcmp(argv[i], "--rock-delay-ms") == 0 && i + 1 < argc) {
+      rock_delays_ms = parse_list(argv[++i]);
+    } else if (strcmp(argv[i], "--episodes") == 0 && i + 1 < argc) {
+      episodes = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+      max_seconds = strtof(argv[++i], nullptr);
+    } else if (strcmp(argv[i], "--reaction-ms") == 0 && i + 1 < argc) {
+      reaction_ms = std::max(strtof(argv[++i], nullptr), SIMULATION_STEP_MS);
+    } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      threads = (unsigned int)strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+      out_path = argv[++i];
+    } else {
+      fprintf(stderr, "Unknown argument %s\n", argv[i]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (max_rocks.empty() || rock_delays_ms.empty() || episodes == 0) {
+    fprintf(stderr, "Nothing to run\n");
+    return EXIT_FAILURE;
+  }
+
+  std::vector<Setting> settings;
+  for (float rocks : max_rocks)
+    for (float delay : rock_delays_ms) {
+      Setting setting;
+      setting.balance.max_rocks = (size_t)rocks;
+      setting.balance.rock_delay_ms = delay;
+      setting.survival_s.resize(episodes);
+      settings.push_back(setting);
+    }
+  std::vector<Episode> jobs;
+  for (size_t s = 0; s < settings.size(); s++)
+    for (size_t e = 0; e < episodes; e++) jobs.push_back({s, e});
+
+  // The meshes give the salmon its size
+  std::shared_ptr<MeshLibrary> meshes = std::make_shared<MeshLibrary>();
+  meshes->loadMeshes();
+  std::shared_ptr<Viewport> viewport =
+      std::make_shared<FixedViewport>(SCREEN_WIDTH, SCREEN_HEIGHT);
+
+  job_system.start(threads);
+  printf("%zu settings of %zu episodes on %u threads\n", settings.size(),
+         episodes, job_system.thread_count());
+  auto start = Clock::now();
+  job_system.parallel_for(
+      jobs.size(), EPISODES_PER_JOB, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; j++) {
+          Setting &setting = settings[jobs[j].setting];
+          // the same episode gets the same rocks on any number of threads
+          std::seed_seq episode_seed = {seed,
+                                        (uint32_t)setting.balance.max_rocks,
+                                        (uint32_t)setting.balance.rock_delay_ms,
+                                        (uint32_t)jobs[j].index};
+          setting.survival_s[jobs[j].index] =
+              play(setting.balance, std::default_random_engine(episode_seed),
+                   meshes, viewport, reaction_ms, max_seconds);
+        }
+      });
+  float ms = std::chrono::duration<float, std::milli>(Clock::now() - start)
+                 .count();
+
+  FILE *out = fopen(out_path.c_str(), "w");
+  if (out == nullptr) {
+    fprintf(stderr, "Could not open the file %s.\n", out_path.c_str());
+    return EXIT_FAILURE;
+  }
+  fprintf(out, "max_rocks,rock_delay_ms,episode,survival_s,survived\n");
+  printf("%9s %13s %8s %8s %8s %8s %9s\n", "max rocks", "rock delay ms",
+         "mean s", "p10 s", "p50 s", "p90 s", "survived");
+  for (const Setting &setting : settings) {
+    size_t survived = 0;
+    float sum = 0;
+    for (size_t e = 0; e < episodes; e++) {
+      float survival = setting.survival_s[e];
+      bool lived = survival >= max_seconds;
+      survived += lived;
+      sum += survival;
+      fprintf(out, "%zu,%g,%zu,%.3f,%d\n", setting.balance.max_rocks,
+              setting.balance.rock_delay_ms, e, survival, (int)lived);
+    }
+    std::vector<float> sorted = setting.survival_s;
+    std::sort(sorted.begin(), sorted.end());
+    printf("%9zu %13g %8.1f %8.1f %8.1f %8.1f %8.1f%%\n",
+           setting.balance.max_rocks, setting.balance.rock_delay_ms,
+           sum / episodes, percentile(sorted, 0.1f), percentile(sorted, 0.5f),
+           percentile(sorted, 0.9f), 100.f * survived / episodes);
+  }
+  fclose(out);
+  printf("%zu episodes in %.1f s, written to %s\n", jobs.size(), ms / 1000,
+         out_path.c_str());
+  return EXIT_SUCCESS;
+}
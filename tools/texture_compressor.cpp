@@ -0,0 +1,81 @@
+/**
+ * @file texture_compressor.cpp
+ * @author Team Doge
+ * @brief Offline conversion of the PNG textures to BC3 (DXT5) .dds files with a
+ * prebuilt mip chain. The renderer picks them up from data/textures/compressed/
+ * and falls back to the PNG when a file is missing.
+ *
+ * Usage: texture_compressor <output dir> <texture.png>...
+ * or build the compress_textures target, which converts every texture in
+ * data/textures.
+ * @version 0.1
+ * @date 2021-12-01
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#define STB_IMAGE_IMPLEMENTATION
+#include "../ext/stb_image/stb_image.h"
+
+// stlib
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "texture_codec.hpp"
+
+// data/textures/bkgd_0.png -> <output_dir>/bkgd_0.dds
+static std::string output_path(const std::string &output_dir,
+                               const std::string &input) {
+  size_t slash = input.find_last_of("/\\");
+  std::string name =
+      slash == std::string::npos ? input : input.substr(slash + 1);
+  size_t dot = name.find_last_of('.');
+  if (dot != std::string::npos) name = name.substr(0, dot);
+  return output_dir + "/" + name + ".dds";
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    fprintf(stderr, "Usage: %s <output dir> <texture.png>...\n", argv[0]);
+    return 1;
+  }
+  const std::string output_dir = argv[1];
+
+  size_t total_rgba = 0, total_bc3 = 0;
+  int failures = 0;
+  for (int i = 2; i < argc; i++) {
+    int width, height;
+    stbi_uc *data = stbi_load(argv[i], &width, &height, NULL, 4);
+    if (data == NULL) {
+      fprintf(stderr, "Could not load the file %s.\n", argv[i]);
+      failures++;
+      continue;
+    }
+
+    std::vector<TextureLevel> levels;
+    size_t rgba_bytes = 0, bc3_bytes = 0;
+    for (const TextureLevel &level : build_mip_chain(data, width, height)) {
+      levels.push_back(compress_bc3(level));
+      rgba_bytes += level.data.size();
+      bc3_bytes += levels.back().data.size();
+    }
+    stbi_image_free(data);
+
+    const std::string path = output_path(output_dir, argv[i]);
+    if (!write_dds_bc3(path, levels)) {
+      fprintf(stderr, "Could not write the file %s.\n", path.c_str());
+      failures++;
+      continue;
+    }
+    printf("%s: %dx%d, %zu mips, %.2f MB -> %.2f MB\n", path.c_str(), width,
+           height, levels.size(), rgba_bytes / 1048576.0,
+           bc3_bytes / 1048576.0);
+    total_rgba += rgba_bytes;
+    total_bc3 += bc3_bytes;
+  }
+
+  printf("Total: %.2f MB of RGBA mip chains -> %.2f MB of BC3\n",
+         total_rgba / 1048576.0, total_bc3 / 1048576.0);
+  return failures == 0 ? 0 : 1;
+}